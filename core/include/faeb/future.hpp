@@ -0,0 +1,266 @@
+/* faeb Core Runtime - C++20 Futures
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#ifndef FAEB_FUTURE_HPP
+#define FAEB_FUTURE_HPP
+
+#include "faeb/runtime.h"
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Typed, move-only handles on faeb futures. A faeb::future<T> is either
+// spawned onto a process, or returned by a coroutine that may co_await
+// other futures. A coroutine suspended in co_await resumes in a new
+// process on the scheduler or worker that completes what it awaited, so
+// it can block on faeb objects like any process. Exceptions thrown by
+// the work are rethrown where the value is taken.
+
+namespace faeb {
+
+template <typename T>
+class future;
+
+namespace detail {
+
+// Value or exception of a future, shared by its handle and its producer
+template <typename T>
+struct state {
+    std::optional<T> value;
+    std::exception_ptr error;
+
+    T take() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct state<void> {
+    std::exception_ptr error;
+
+    void take() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+inline void resume_process(void* address) {
+    std::coroutine_handle<>::from_address(address).resume();
+}
+
+// Continuation of a suspended co_await: resume in a process of its own,
+// or right here when no process can be made
+inline void resume(void* address, void*) {
+    if (faeb_process_spawn(resume_process, address) != FAEB_SUCCESS) {
+        resume_process(address);
+    }
+}
+
+template <typename T>
+class awaiter {
+public:
+    awaiter(faeb_future_t* handle, state<T>* shared) : handle_(handle), shared_(shared) {}
+
+    bool await_ready() const noexcept { return faeb_future_is_ready(handle_); }
+
+    // Completed in between: carry on without suspending
+    bool await_suspend(std::coroutine_handle<> coroutine) {
+        faeb_result_t result = faeb_future_then(handle_, resume, coroutine.address());
+        if (result == FAEB_ERROR_MEMORY) throw std::bad_alloc();
+        return result == FAEB_SUCCESS;
+    }
+
+    T await_resume() { return shared_->take(); }
+
+private:
+    faeb_future_t* handle_;
+    state<T>* shared_;
+};
+
+template <typename T>
+struct promise_base {
+    faeb_future_t* handle = faeb_future_create();
+    std::shared_ptr<state<T>> shared = std::make_shared<state<T>>();
+
+    promise_base() = default;
+    promise_base(const promise_base&) = delete;
+    promise_base& operator=(const promise_base&) = delete;
+    ~promise_base() { faeb_future_destroy(handle); }
+
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() {
+        shared->error = std::current_exception();
+        faeb_future_complete(handle, shared.get());
+    }
+};
+
+template <typename T>
+struct promise_result : promise_base<T> {
+    void return_value(T value) {
+        this->shared->value.emplace(std::move(value));
+        faeb_future_complete(this->handle, this->shared.get());
+    }
+};
+
+template <>
+struct promise_result<void> : promise_base<void> {
+    void return_void() { faeb_future_complete(this->handle, this->shared.get()); }
+};
+
+// Work of faeb::spawn, owned by its process
+template <typename F, typename T>
+struct job {
+    F function;
+    std::shared_ptr<state<T>> shared;
+
+    static void* run(void* context) {
+        std::unique_ptr<job> work(static_cast<job*>(context));
+        try {
+            if constexpr (std::is_void_v<T>) {
+                work->function();
+            } else {
+                work->shared->value.emplace(work->function());
+            }
+        } catch (...) {
+            work->shared->error = std::current_exception();
+        }
+        return work->shared.get();
+    }
+};
+
+}  // namespace detail
+
+template <typename T>
+class future {
+public:
+    // Coroutines returning faeb::future<T> run eagerly up to their first
+    // suspension; the future completes at co_return
+    struct promise_type : detail::promise_result<T> {
+        future get_return_object() {
+            if (!this->handle) throw std::bad_alloc();
+            faeb_future_retain(this->handle);
+            return future(this->handle, this->shared);
+        }
+    };
+
+    future() = default;
+    future(faeb_future_t* handle, std::shared_ptr<detail::state<T>> shared)
+        : handle_(handle), shared_(std::move(shared)) {}
+    future(future&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)), shared_(std::move(other.shared_)) {}
+    future& operator=(future&& other) noexcept {
+        if (this != &other) {
+            faeb_future_destroy(handle_);
+            handle_ = std::exchange(other.handle_, nullptr);
+            shared_ = std::move(other.shared_);
+        }
+        return *this;
+    }
+    future(const future&) = delete;
+    future& operator=(const future&) = delete;
+    ~future() { faeb_future_destroy(handle_); }
+
+    bool valid() const noexcept { return handle_ != nullptr; }
+    bool ready() const noexcept { return faeb_future_is_ready(handle_); }
+    faeb_future_t* native_handle() const noexcept { return handle_; }
+
+    // Park the calling process until the value is there and take it.
+    // Outside of a process the future must have completed already.
+    T get() {
+        if (faeb_future_await(handle_, nullptr) != FAEB_SUCCESS) {
+            throw std::logic_error("faeb::future: awaited outside of a process");
+        }
+        return shared_->take();
+    }
+
+    detail::awaiter<T> operator co_await() const noexcept {
+        return detail::awaiter<T>(handle_, shared_.get());
+    }
+
+private:
+    faeb_future_t* handle_ = nullptr;
+    std::shared_ptr<detail::state<T>> shared_;
+};
+
+// Run function() in a new process and complete with its result
+template <typename F>
+auto spawn(F function) -> future<std::invoke_result_t<F&>> {
+    using T = std::invoke_result_t<F&>;
+    using work_type = detail::job<F, T>;
+    auto shared = std::make_shared<detail::state<T>>();
+    auto* work = new work_type{std::move(function), shared};
+    faeb_future_t* handle = faeb_future_spawn(&work_type::run, work);
+    if (!handle) {
+        delete work;
+        throw std::bad_alloc();
+    }
+    return future<T>(handle, std::move(shared));
+}
+
+// Complete once every future has; take their values from them
+template <typename... Ts>
+future<void> when_all(const future<Ts>&... futures) {
+    faeb_future_t* handles[] = { futures.native_handle()... };
+    faeb_future_t* handle = faeb_future_when_all(handles, sizeof...(Ts));
+    if (!handle) throw std::bad_alloc();
+    return future<void>(handle, std::make_shared<detail::state<void>>());
+}
+
+// Complete with the position of the first future to complete
+template <typename... Ts>
+future<std::size_t> when_any(const future<Ts>&... futures) {
+    struct relay {
+        faeb_future_t* handle;
+        std::shared_ptr<detail::state<std::size_t>> shared;
+
+        static void done(void* context, void* result) {
+            std::unique_ptr<relay> self(static_cast<relay*>(context));
+            self->shared->value.emplace(static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(result)));
+            faeb_future_complete(self->handle, self->shared.get());
+            faeb_future_destroy(self->handle);
+        }
+    };
+
+    faeb_future_t* handles[] = { futures.native_handle()... };
+    faeb_future_t* any = faeb_future_when_any(handles, sizeof...(Ts));
+    faeb_future_t* handle = faeb_future_create();
+    if (!any || !handle) {
+        faeb_future_destroy(any);
+        faeb_future_destroy(handle);
+        throw std::bad_alloc();
+    }
+
+    // The relay holds its own reference on the result until it fires
+    auto shared = std::make_shared<detail::state<std::size_t>>();
+    faeb_future_retain(handle);
+    auto* forward = new relay{handle, shared};
+    void* first = nullptr;
+    faeb_result_t result = faeb_future_then(any, relay::done, forward);
+    if (result == FAEB_ERROR_INVALID) {
+        faeb_future_await(any, &first);
+        relay::done(forward, first);
+    } else if (result != FAEB_SUCCESS) {
+        delete forward;
+        faeb_future_destroy(handle);
+        faeb_future_destroy(handle);
+        faeb_future_destroy(any);
+        throw std::bad_alloc();
+    }
+    faeb_future_destroy(any);
+    return future<std::size_t>(handle, std::move(shared));
+}
+
+}  // namespace faeb
+
+#endif  // FAEB_FUTURE_HPP
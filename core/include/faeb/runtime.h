@@ -10,6 +10,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 // RISC-V Principle: Minimal orthogonal components
 typedef enum {
     FAEB_SUCCESS = 0,
@@ -22,27 +26,416 @@ typedef enum {
 // Memory management - minimal interface
 typedef struct faeb_memory faeb_memory_t;
 
+#define FAEB_CACHE_LINE_SIZE 64
+#define FAEB_MEMORY_SLAB_CLASSES 8
+
+// Allocation engine, selected at creation time
+typedef enum {
+    FAEB_MEMORY_HEAP = 0,   // Individually allocated blocks
+    FAEB_MEMORY_ARENA,      // Bump-pointer region, bulk reset
+    FAEB_MEMORY_SLAB        // Size-class slabs for small objects
+} faeb_memory_kind_t;
+
+// Backing options for arena and slab managers
+#define FAEB_MEMORY_MMAP      (1u << 0)  // One anonymous mapping of size bytes
+#define FAEB_MEMORY_HUGEPAGES (1u << 1)  // Huge pages, falling back to 4K
+#define FAEB_MEMORY_PREFAULT  (1u << 2)  // Fault the mapping in at creation
+
+typedef struct {
+    faeb_memory_kind_t kind;
+    uint32_t flags;
+} faeb_memory_config_t;
+
+// Occupancy of one slab size class
+typedef struct {
+    size_t object_size;
+    size_t slabs;
+    size_t objects_in_use;
+    size_t objects_capacity;
+} faeb_memory_class_stats_t;
+
+// Allocation telemetry, maintained with relaxed per-thread counters
+#define FAEB_MEMORY_HISTOGRAM_BUCKETS 48
+
+typedef struct {
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t reallocations;
+    uint64_t limit_hits;           // Requests refused by the budget
+    size_t bytes_live;
+    size_t bytes_peak;
+    size_t total_size;
+    uint64_t uptime_ns;
+    double allocations_per_second; // Averaged over uptime
+    double frees_per_second;
+    uint64_t size_histogram[FAEB_MEMORY_HISTOGRAM_BUCKETS]; // [2^i, 2^(i+1))
+    int numa_node;                 // Node the mapping is bound to, -1 if none
+} faeb_memory_stats_t;
+
+// One sampled allocation and the call stack that made it
+#define FAEB_MEMORY_PROFILE_DEPTH 16
+
+typedef struct {
+    size_t size;
+    uint32_t depth;
+    void* frames[FAEB_MEMORY_PROFILE_DEPTH];
+} faeb_memory_sample_t;
+
 faeb_memory_t* faeb_memory_create(size_t size);
+faeb_memory_t* faeb_memory_create_arena(size_t size);
+faeb_memory_t* faeb_memory_create_config(size_t size, const faeb_memory_config_t* config);
 void faeb_memory_destroy(faeb_memory_t* memory);
 void* faeb_memory_allocate(faeb_memory_t* memory, size_t size);
+void* faeb_memory_allocate_aligned(faeb_memory_t* memory, size_t size, size_t alignment);
+void* faeb_memory_allocate_cacheline(faeb_memory_t* memory, size_t size);
+void* faeb_memory_reallocate(faeb_memory_t* memory, void* ptr, size_t new_size);
 void faeb_memory_free(faeb_memory_t* memory, void* ptr);
+faeb_result_t faeb_memory_allocate_batch(faeb_memory_t* memory, size_t size, void** ptrs, size_t count);
+void faeb_memory_free_batch(faeb_memory_t* memory, void** ptrs, size_t count);
+faeb_result_t faeb_memory_reset(faeb_memory_t* memory);
+faeb_result_t faeb_memory_trim(faeb_memory_t* memory);
+size_t faeb_memory_get_page_size(faeb_memory_t* memory);
+faeb_result_t faeb_memory_get_last_error(faeb_memory_t* memory);
+size_t faeb_memory_get_class_stats(faeb_memory_t* memory, faeb_memory_class_stats_t* stats, size_t count);
+faeb_result_t faeb_memory_get_stats(faeb_memory_t* memory, faeb_memory_stats_t* stats);
+faeb_result_t faeb_memory_profile_start(faeb_memory_t* memory, uint32_t sample_rate);
+size_t faeb_memory_profile_read(faeb_memory_t* memory, faeb_memory_sample_t* samples, size_t count);
 
 // Process scheduling - simple cooperative scheduler
 typedef struct faeb_process faeb_process_t;
 typedef void (*faeb_process_fn)(void* context);
 
+// Each process runs on its own guarded stack of this many bytes
+#define FAEB_PROCESS_STACK_SIZE ((size_t)64 << 10)
+
+typedef struct {
+    size_t stack_size;   // 0 selects FAEB_PROCESS_STACK_SIZE
+} faeb_process_config_t;
+
+// Scheduling statistics on CLOCK_MONOTONIC. The queueing delay is how
+// long a process was ready to run before it was switched in.
+#define FAEB_SCHEDULER_DELAY_BUCKETS 32
+
+typedef struct {
+    uint64_t cpu_time_ns;          // Time spent switched in
+    uint64_t runs;                 // Times switched in
+    uint64_t switches;             // Times switched out before finishing
+    uint64_t blocks;               // Switches to wait, sleep or block
+    uint64_t delay_histogram[FAEB_SCHEDULER_DELAY_BUCKETS]; // [2^i, 2^(i+1)) ns
+    uint64_t periods;              // Deadline jobs completed
+    uint64_t deadline_misses;      // ...of which after their deadline
+} faeb_process_stats_t;
+
+// Earliest-deadline-first scheduling. A process with deadline parameters
+// runs ahead of every priority level, earliest absolute deadline first.
+// A job is released every period, runs for at most runtime and must
+// finish within deadline of its release; the scheduling loop releases
+// jobs on time to the nanosecond. Admission keeps the summed density
+// runtime / min(deadline, period) of a scheduler's deadline processes
+// within FAEB_SCHEDULER_DEADLINE_BOUND parts per million, leaving the
+// rest for priority processes.
+#define FAEB_SCHEDULER_DEADLINE_BOUND 950000
+
+typedef struct {
+    uint64_t runtime_ns;
+    uint64_t deadline_ns;          // 0 selects the period
+    uint64_t period_ns;
+} faeb_process_deadline_t;
+
+// Priorities run from 0 to FAEB_PROCESS_PRIORITIES - 1; higher runs first
+#define FAEB_PROCESS_PRIORITIES 32
+#define FAEB_PROCESS_PRIORITY_DEFAULT 16
+
 faeb_process_t* faeb_process_create(faeb_process_fn function, void* context);
+faeb_process_t* faeb_process_create_config(faeb_process_fn function, void* context, const faeb_process_config_t* config);
 void faeb_process_destroy(faeb_process_t* process);
 void faeb_process_yield(void);
 void faeb_process_run(faeb_process_t* process);
+bool faeb_process_is_terminated(faeb_process_t* process);
+faeb_result_t faeb_process_set_priority(faeb_process_t* process, int priority);
+int faeb_process_get_priority(faeb_process_t* process);
+faeb_result_t faeb_process_sleep(uint64_t milliseconds);
+faeb_result_t faeb_process_spawn(faeb_process_fn function, void* context);
+void faeb_process_set_cache_limit(size_t limit);
+void faeb_process_trim_cache(void);
+faeb_result_t faeb_process_get_stats(faeb_process_t* process, faeb_process_stats_t* stats);
+faeb_result_t faeb_process_set_deadline(faeb_process_t* process, const faeb_process_deadline_t* deadline);
+faeb_result_t faeb_process_wait_period(void);
+void faeb_scheduler_run(void);
+
+// Tick-driven scheduler; time slices and timeouts use CLOCK_MONOTONIC
+faeb_result_t faeb_scheduler_init(int time_slice_ms);
+faeb_result_t faeb_scheduler_add_process(faeb_process_t* process);
+faeb_result_t faeb_scheduler_remove_process(faeb_process_t* process);
+faeb_process_t* faeb_scheduler_schedule_next(void);
+faeb_process_t* faeb_scheduler_get_current(void);
+faeb_result_t faeb_scheduler_block_current(void);
+faeb_result_t faeb_scheduler_block_current_timeout(uint32_t timeout_ms);
+faeb_result_t faeb_scheduler_block_current_fd(int fd, uint32_t events);   // FAEB_FD_* below
+faeb_result_t faeb_scheduler_unblock_process(faeb_process_t* process);
+bool faeb_scheduler_time_slice_expired(void);
+faeb_result_t faeb_scheduler_tick(void);
 
-// I/O operations - minimal orthogonal operations
+// Scheduler health, for the current scheduler's processes only. Queue
+// lengths are kept as processes move; the totals come from per-thread
+// counters summed on read.
+typedef struct {
+    int ready_count;               // Tick scheduler queues
+    int blocked_count;
+    int total_processes;
+    int time_slice_ms;
+    size_t submitted;              // On the worker pool and not finished
+    uint64_t cpu_time_ns;
+    uint64_t runs;
+    uint64_t switches;
+    uint64_t blocks;
+    uint64_t delay_histogram[FAEB_SCHEDULER_DELAY_BUCKETS]; // [2^i, 2^(i+1)) ns
+    size_t deadline_processes;     // Admitted on the current scheduler
+    double deadline_density;       // Their summed density
+    uint64_t deadline_misses;
+    size_t io_pending;             // Processes parked on I/O
+    uint64_t io_requests;          // Requests queued on the I/O engine
+    uint64_t io_enters;            // io_uring_enter calls that carried them
+    size_t fd_waiting;             // Processes waiting on descriptor readiness
+    uint64_t fd_polls;             // epoll_wait calls
+    uint64_t fd_events;            // Readiness events they returned
+} faeb_scheduler_stats_t;
+
+faeb_result_t faeb_scheduler_get_stats(faeb_scheduler_stats_t* stats);
+
+// Scheduler instances. The calling functions above act on the thread's
+// current scheduler, a shared default until the thread selects another;
+// processes stay with the scheduler they were created on. Instances run
+// on separate threads share no scheduling state.
+typedef struct faeb_scheduler faeb_scheduler_t;
+
+faeb_scheduler_t* faeb_scheduler_create(int time_slice_ms);
+void faeb_scheduler_destroy(faeb_scheduler_t* scheduler);
+faeb_scheduler_t* faeb_scheduler_get_default(void);
+faeb_scheduler_t* faeb_scheduler_current(void);
+faeb_scheduler_t* faeb_scheduler_set_current(faeb_scheduler_t* scheduler);
+
+// Multi-core scheduling: one worker thread per core, each with its own
+// work-stealing deque. Workers park when there is nothing to run.
+typedef enum {
+    FAEB_PLACEMENT_NONE = 0,   // Workers run wherever the OS puts them
+    FAEB_PLACEMENT_SHARED,     // Every worker may run on any CPU of the set
+    FAEB_PLACEMENT_PINNED      // Worker i runs only on CPU i of the set, cycling
+} faeb_placement_t;
+
+typedef struct {
+    int workers;                 // 0 = one per CPU of the set
+    faeb_placement_t placement;
+    const int* cpus;             // NULL = every online CPU not isolated,
+    size_t cpu_count;            // cores before their second threads
+} faeb_worker_config_t;
+
+faeb_result_t faeb_scheduler_init_workers(int workers);   // 0 = one per online CPU
+faeb_result_t faeb_scheduler_init_workers_config(const faeb_worker_config_t* config);
+faeb_result_t faeb_scheduler_submit(faeb_process_t* process);
+faeb_result_t faeb_scheduler_spawn(faeb_process_fn function, void* context);   // Detached
+faeb_result_t faeb_scheduler_wait(void);
+void faeb_scheduler_shutdown_workers(void);
+int faeb_scheduler_get_worker_count(void);
+int faeb_scheduler_get_worker_cpu(int worker);             // -1 unless pinned
+
+// Machine topology, read once from /sys. Cores and last-level cache
+// domains are numbered densely; packages and nodes as the kernel does.
+// Memory managers mapped by a thread confined to one node are bound to
+// that node.
+typedef struct {
+    int cpu;
+    int core;
+    int package;
+    int node;
+    int cache;                   // Last-level cache domain
+    int thread;                  // Hardware thread within its core
+    bool isolated;               // isolcpus; only used when named
+} faeb_cpu_info_t;
+
+typedef struct {
+    int cpus;                    // Online
+    int cores;
+    int packages;
+    int nodes;
+    int caches;
+    int isolated;
+} faeb_topology_t;
+
+faeb_result_t faeb_topology_get(faeb_topology_t* topology);
+size_t faeb_topology_get_cpus(faeb_cpu_info_t* cpus, size_t count);
+faeb_result_t faeb_topology_pin_thread(const int* cpus, size_t count);   // NULL = any
+int faeb_topology_current_node(void);                                    // -1 if several
+
+// Synchronization between processes. A process that has to wait parks on
+// the object itself and is requeued by whoever releases it; waiting
+// outside of a process fails with FAEB_ERROR_INVALID instead of blocking.
+typedef struct faeb_event faeb_event_t;
+typedef struct faeb_semaphore faeb_semaphore_t;
+typedef struct faeb_mutex faeb_mutex_t;
+typedef struct faeb_cond faeb_cond_t;
+
+faeb_event_t* faeb_event_create(bool auto_reset);
+void faeb_event_destroy(faeb_event_t* event);
+void faeb_event_set(faeb_event_t* event);
+void faeb_event_reset(faeb_event_t* event);
+faeb_result_t faeb_event_wait(faeb_event_t* event);
+
+faeb_semaphore_t* faeb_semaphore_create(uint32_t count);
+void faeb_semaphore_destroy(faeb_semaphore_t* semaphore);
+faeb_result_t faeb_semaphore_wait(faeb_semaphore_t* semaphore);
+bool faeb_semaphore_try_wait(faeb_semaphore_t* semaphore);
+void faeb_semaphore_post(faeb_semaphore_t* semaphore);
+
+faeb_mutex_t* faeb_mutex_create(void);
+void faeb_mutex_destroy(faeb_mutex_t* mutex);
+faeb_result_t faeb_mutex_lock(faeb_mutex_t* mutex);
+bool faeb_mutex_try_lock(faeb_mutex_t* mutex);
+faeb_result_t faeb_mutex_unlock(faeb_mutex_t* mutex);
+
+faeb_cond_t* faeb_cond_create(void);
+void faeb_cond_destroy(faeb_cond_t* cond);
+faeb_result_t faeb_cond_wait(faeb_cond_t* cond, faeb_mutex_t* mutex);
+void faeb_cond_signal(faeb_cond_t* cond);
+void faeb_cond_broadcast(faeb_cond_t* cond);
+
+// Bounded channels of fixed-size messages. Sending to a full channel or
+// receiving from an empty one parks the calling process; outside of a
+// process those calls fail instead. SPSC channels allow one sending and
+// one receiving thread of control at a time, MPMC channels any number.
+typedef struct faeb_channel faeb_channel_t;
+
+typedef enum {
+    FAEB_CHANNEL_SPSC = 0,
+    FAEB_CHANNEL_MPMC
+} faeb_channel_kind_t;
+
+faeb_channel_t* faeb_channel_create(faeb_channel_kind_t kind, size_t message_size, size_t capacity);
+void faeb_channel_destroy(faeb_channel_t* channel);
+faeb_result_t faeb_channel_send(faeb_channel_t* channel, const void* message);
+faeb_result_t faeb_channel_receive(faeb_channel_t* channel, void* message);
+bool faeb_channel_try_send(faeb_channel_t* channel, const void* message);
+bool faeb_channel_try_receive(faeb_channel_t* channel, void* message);
+size_t faeb_channel_send_batch(faeb_channel_t* channel, const void* messages, size_t count);
+size_t faeb_channel_receive_batch(faeb_channel_t* channel, void* messages, size_t count);
+void faeb_channel_close(faeb_channel_t* channel);
+
+// Futures: one-shot results. Awaiting an incomplete future parks the
+// calling process until it completes; outside of a process awaiting
+// fails with FAEB_ERROR_INVALID instead. Spawned futures run their
+// function in a detached process and complete with its return value.
+// Combinators complete from their children's completions and need no
+// process of their own. Every future is released with
+// faeb_future_destroy; whatever still works on it keeps it alive.
+// faeb/future.hpp wraps these as C++20 awaitables.
+typedef struct faeb_future faeb_future_t;
+typedef void* (*faeb_future_fn)(void* context);
+
+faeb_future_t* faeb_future_create(void);
+faeb_future_t* faeb_future_spawn(faeb_future_fn function, void* context);
+faeb_future_t* faeb_future_when_all(faeb_future_t* const* futures, size_t count);
+faeb_future_t* faeb_future_when_any(faeb_future_t* const* futures, size_t count);
+void faeb_future_retain(faeb_future_t* future);
+void faeb_future_destroy(faeb_future_t* future);
+faeb_result_t faeb_future_complete(faeb_future_t* future, void* result);
+faeb_result_t faeb_future_await(faeb_future_t* future, void** result);
+bool faeb_future_is_ready(faeb_future_t* future);
+faeb_result_t faeb_future_then(faeb_future_t* future,
+                               void (*callback)(void* context, void* result), void* context);
+
+// Parallel loops and task graphs on the worker pool. The caller waits
+// for the work to finish: a process parks, a plain thread blocks, and
+// the caller of a loop takes chunks itself meanwhile. Without
+// workers everything runs in order on the calling thread.
+//
+// faeb_parallel_for calls body on disjoint subranges covering
+// [begin, end). Chunks are guided: each claim takes a share of what is
+// left, shrinking toward grain (0 picks one) as the loop drains, so
+// early chunks are large and the tail balances across workers.
+typedef void (*faeb_parallel_fn)(void* context, size_t begin, size_t end);
+
+faeb_result_t faeb_parallel_for(size_t begin, size_t end, size_t grain,
+                                faeb_parallel_fn body, void* context);
+
+// A task graph runs each task once all of its dependencies have. Tasks
+// may only depend on tasks added before them, so every graph is acyclic.
+// A finished task runs one newly ready successor itself and hands the
+// others to idle workers. A graph can be run again once it has finished.
+typedef struct faeb_graph faeb_graph_t;
+
+faeb_graph_t* faeb_graph_create(void);
+void faeb_graph_destroy(faeb_graph_t* graph);
+faeb_result_t faeb_graph_add_task(faeb_graph_t* graph, faeb_process_fn function, void* context,
+                                  const size_t* dependencies, size_t count, size_t* task);
+faeb_result_t faeb_graph_run(faeb_graph_t* graph);
+
+// I/O operations - minimal orthogonal operations. Input and output go
+// through user-space buffers, so small reads and writes cost a copy
+// rather than a syscall; faeb_io_flush and faeb_io_destroy write out
+// what is pending. An io is not synchronized: use one per thread, or
+// lock around it.
 typedef struct faeb_io faeb_io_t;
 
+#define FAEB_IO_BUFFER_SIZE ((size_t)8 << 10)
+
+typedef enum {
+    FAEB_IO_AUTO = 0,       // Line buffered on a terminal, fully otherwise
+    FAEB_IO_FULL,           // Written out when the buffer fills
+    FAEB_IO_LINE,           // Also written out after each newline
+    FAEB_IO_UNBUFFERED      // Every call goes straight to the descriptor
+} faeb_io_mode_t;
+
+typedef struct {
+    size_t buffer_size;     // 0 selects FAEB_IO_BUFFER_SIZE
+    faeb_io_mode_t mode;    // Output buffering; input is unbuffered only with
+                            // FAEB_IO_UNBUFFERED
+} faeb_io_config_t;
+
 faeb_io_t* faeb_io_create(void);
+faeb_io_t* faeb_io_create_config(const faeb_io_config_t* config);
+faeb_io_t* faeb_io_open(int input_fd, int output_fd, const faeb_io_config_t* config);
 void faeb_io_destroy(faeb_io_t* io);
 size_t faeb_io_read(faeb_io_t* io, void* buffer, size_t size);
 size_t faeb_io_write(faeb_io_t* io, const void* buffer, size_t size);
+faeb_result_t faeb_io_flush(faeb_io_t* io);
+faeb_result_t faeb_io_get_last_error(faeb_io_t* io);
+bool faeb_io_is_available(faeb_io_t* io);
+
+// Asynchronous I/O. A process inside a scheduling loop that reads or
+// writes, through faeb_io or the calls below, parks until the request
+// completes while the loop runs other processes. Each scheduler has its
+// own engine, chosen before its first request; processes on the worker
+// pool always use the thread pool. Elsewhere these are plain blocking
+// calls. offset -1 reads or writes at the file position.
+typedef enum {
+    FAEB_IO_BACKEND_AUTO = 0,   // io_uring when the kernel allows it, else threads
+    FAEB_IO_BACKEND_URING,      // Requests batched into io_uring per timer tick
+    FAEB_IO_BACKEND_THREADS     // Blocking calls on a shared, growing thread pool
+} faeb_io_backend_t;
+
+faeb_result_t faeb_scheduler_set_io_backend(faeb_io_backend_t backend);
+faeb_io_backend_t faeb_scheduler_get_io_backend(void);   // AUTO until settled
+faeb_result_t faeb_io_pread(int fd, void* buffer, size_t size, int64_t offset, size_t* done);
+faeb_result_t faeb_io_pwrite(int fd, const void* buffer, size_t size, int64_t offset,
+                             size_t* done);
+
+// Readiness of pipes, sockets and other pollable descriptors, which
+// registration makes non-blocking until they are unregistered; reading
+// and writing through these calls in a loop registers them. A process
+// in a scheduling loop that waits on one parks while the loop
+// multiplexes every registered descriptor through one edge-triggered
+// epoll set; the tick scheduler blocks its current process the same way
+// and faeb_scheduler_tick unblocks it. Elsewhere waiting is a poll(2).
+// Unregister a descriptor before closing it; a wait notices one closed
+// without that when its number is reused.
+#define FAEB_FD_READ  0x1u
+#define FAEB_FD_WRITE 0x2u
+
+faeb_result_t faeb_fd_register(int fd);
+faeb_result_t faeb_fd_unregister(int fd);
+faeb_result_t faeb_fd_wait(int fd, uint32_t events);     // After EAGAIN
+faeb_result_t faeb_fd_read(int fd, void* buffer, size_t size, size_t* done);
+faeb_result_t faeb_fd_write(int fd, const void* buffer, size_t size, size_t* done);
 
 // Verification interface - formal verification support
 bool faeb_verify_memory_safety(const void* ptr, size_t size);
@@ -58,4 +451,8 @@ typedef struct {
     faeb_result_t (*operation)(void*, const void*, size_t);
 } faeb_extension_t;
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif // FAEB_RUNTIME_H
@@ -0,0 +1,610 @@
+/* faeb Core Runtime - Asynchronous I/O Engine
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#define _GNU_SOURCE
+#include "internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <linux/io_uring.h>
+
+// A process doing I/O inside a scheduling loop queues the request on the
+// loop's engine and parks. With io_uring the request becomes a submission
+// entry; the loop hands every entry queued since the last tick to the
+// kernel in one io_uring_enter and reaps completions from the shared
+// ring without a syscall. Without io_uring, and for processes on the
+// worker pool, a shared thread pool makes the blocking call and wakes the
+// process when it returns; it grows while every thread is busy, so calls
+// left blocked on pipes or sockets cannot hold up the rest, and shrinks
+// back once idle. Calls made outside of a process just block.
+// A process destroyed while its request is in flight leaves its stack,
+// which holds the request and usually the buffer, to the engine: io_uring
+// is asked to cancel the request, and whoever sees it complete frees the
+// process.
+
+#define FAEB_IO_RING_ENTRIES 256
+#define FAEB_IO_THREADS 4                   // Thread pool size when idle
+#define FAEB_IO_THREADS_MAX 256             // Grown to while all are busy
+#define FAEB_IO_THREAD_IDLE_S 1             // Until a thread above the base exits
+#define FAEB_IO_MAX_CHUNK ((size_t)1 << 30)   // Per request; longer ones come back short
+
+struct io_request {
+    faeb_wait_queue_t waiters;     // The parked process
+    struct io_request* next;       // Thread pool queue
+    faeb_io_engine_t* engine;      // Notified on completion, NULL on workers
+    bool write;
+    int fd;
+    void* buffer;
+    size_t size;
+    int64_t offset;                // -1: at and advancing the file position
+    ssize_t result;                // Bytes transferred or -errno
+    bool done;                     // Result in, the process woken
+    struct faeb_process* orphan;   // Destroyed while waiting, freed on completion
+};
+
+// Owned by the thread running its scheduler, except event_fd and the
+// thread pool's wakes through the scheduler's inbox
+struct faeb_io_engine {
+    faeb_io_backend_t backend;
+    size_t pending;                // Parked on a request
+    uint64_t requests;
+    uint64_t enters;               // io_uring_enter calls
+    uint64_t submit_tick;          // Timer tick of the last submission
+
+    // io_uring: mapped rings; queued counts entries not yet submitted
+    int ring_fd;
+    void* ring;
+    size_t ring_size;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    _Atomic unsigned* sq_head;
+    _Atomic unsigned* sq_tail;
+    unsigned* sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned queued;
+    unsigned inflight;             // Queued or submitted, not yet reaped
+    _Atomic unsigned* cq_head;
+    _Atomic unsigned* cq_tail;
+    struct io_uring_cqe* cqes;
+    unsigned cq_mask;
+    unsigned cq_entries;
+
+    // Thread pool backend: completions wake the loop through this
+    int event_fd;
+};
+
+// The blocking call itself
+static ssize_t io_syscall(bool write_op, int fd, void* buffer, size_t size, int64_t offset) {
+    if (write_op) {
+        return offset < 0 ? write(fd, buffer, size) : pwrite(fd, buffer, size, (off_t)offset);
+    }
+    return offset < 0 ? read(fd, buffer, size) : pread(fd, buffer, size, (off_t)offset);
+}
+
+// Shared pool of threads making blocking calls for parked processes
+static struct {
+    pthread_once_t once;
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    struct io_request* head;
+    struct io_request* tail;
+    size_t queued;
+    int threads;
+    int idle;                      // Waiting for work
+} io_pool = { .once = PTHREAD_ONCE_INIT, .lock = PTHREAD_MUTEX_INITIALIZER,
+              .work = PTHREAD_COND_INITIALIZER };
+
+// Threads above FAEB_IO_THREADS leave after idling for a while
+static void* io_pool_main(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&io_pool.lock);
+    for (;;) {
+        while (!io_pool.head) {
+            int waited = 0;
+            io_pool.idle++;
+            if (io_pool.threads > FAEB_IO_THREADS) {
+                struct timespec until;
+                clock_gettime(CLOCK_REALTIME, &until);
+                until.tv_sec += FAEB_IO_THREAD_IDLE_S;
+                waited = pthread_cond_timedwait(&io_pool.work, &io_pool.lock, &until);
+            } else {
+                pthread_cond_wait(&io_pool.work, &io_pool.lock);
+            }
+            io_pool.idle--;
+            if (waited == ETIMEDOUT && !io_pool.head && io_pool.threads > FAEB_IO_THREADS) {
+                io_pool.threads--;
+                pthread_mutex_unlock(&io_pool.lock);
+                return NULL;
+            }
+        }
+        struct io_request* request = io_pool.head;
+        io_pool.head = request->next;
+        if (!io_pool.head) io_pool.tail = NULL;
+        io_pool.queued--;
+        pthread_mutex_unlock(&io_pool.lock);
+        
+        ssize_t result = io_syscall(request->write, request->fd, request->buffer,
+                                    request->size, request->offset);
+        if (result < 0) result = -errno;
+        
+        // The process may free the request once woken; one destroyed
+        // meanwhile left its stack for this thread to free
+        pthread_mutex_lock(&io_pool.lock);
+        struct faeb_process* orphan = request->orphan;
+        if (orphan) {
+            pthread_mutex_unlock(&io_pool.lock);
+            faeb_process_release(orphan);
+            pthread_mutex_lock(&io_pool.lock);
+            continue;
+        }
+        faeb_io_engine_t* engine = request->engine;
+        request->result = result;
+        request->done = true;
+        struct faeb_process* process = wait_queue_pop(&request->waiters);
+        if (process) {
+            faeb_process_wake(process);
+        }
+        if (engine) {
+            uint64_t one = 1;
+            ssize_t ignored = write(engine->event_fd, &one, sizeof(one));
+            (void)ignored;
+        }
+    }
+    return NULL;
+}
+
+// Add a detached pool thread; the caller holds the pool lock
+static void io_pool_spawn(void) {
+    pthread_attr_t attr;
+    pthread_t thread;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &attr, io_pool_main, NULL) == 0) {
+        io_pool.threads++;
+    }
+    pthread_attr_destroy(&attr);
+}
+
+static void io_pool_start(void) {
+    pthread_mutex_lock(&io_pool.lock);
+    for (int i = 0; i < FAEB_IO_THREADS; i++) {
+        io_pool_spawn();
+    }
+    pthread_mutex_unlock(&io_pool.lock);
+}
+
+// Queue request for the pool, adding a thread when more are queued than
+// threads wait for them; the caller holds the pool lock
+static void io_pool_push(struct io_request* request) {
+    if (io_pool.tail) {
+        io_pool.tail->next = request;
+    } else {
+        io_pool.head = request;
+    }
+    io_pool.tail = request;
+    io_pool.queued++;
+    if (io_pool.queued > (size_t)io_pool.idle && io_pool.threads < FAEB_IO_THREADS_MAX) {
+        io_pool_spawn();
+    }
+    pthread_cond_signal(&io_pool.work);
+}
+
+static int ring_enter(faeb_io_engine_t* engine, unsigned submit, unsigned wait,
+                      const struct timespec* timeout) {
+    struct io_uring_getevents_arg arg = { 0 };
+    struct __kernel_timespec ts;
+    unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0;
+    if (wait) {
+        flags |= IORING_ENTER_EXT_ARG;
+        if (timeout) {
+            ts.tv_sec = timeout->tv_sec;
+            ts.tv_nsec = timeout->tv_nsec;
+            arg.ts = (uint64_t)(uintptr_t)&ts;
+        }
+    }
+    engine->enters++;
+    int result = (int)syscall(__NR_io_uring_enter, engine->ring_fd, submit, wait, flags,
+                              wait ? &arg : NULL, wait ? sizeof(arg) : 0);
+    if (result >= 0) {
+        engine->queued -= (unsigned)result < submit ? (unsigned)result : submit;
+    }
+    return result;
+}
+
+static void ring_unmap(faeb_io_engine_t* engine) {
+    if (engine->sqes) munmap(engine->sqes, engine->sqes_size);
+    if (engine->ring) munmap(engine->ring, engine->ring_size);
+    if (engine->ring_fd >= 0) close(engine->ring_fd);
+    engine->sqes = NULL;
+    engine->ring = NULL;
+    engine->ring_fd = -1;
+}
+
+// Set up the rings, or fail when the kernel is too old or forbids them
+static bool ring_setup(faeb_io_engine_t* engine) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    engine->ring_fd = (int)syscall(__NR_io_uring_setup, FAEB_IO_RING_ENTRIES, &params);
+    if (engine->ring_fd < 0) return false;
+    
+    // One mapping for both rings, and timeouts on waits
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) ||
+        !(params.features & IORING_FEAT_EXT_ARG)) {
+        ring_unmap(engine);
+        return false;
+    }
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    engine->ring_size = sq_size > cq_size ? sq_size : cq_size;
+    engine->ring = mmap(NULL, engine->ring_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, engine->ring_fd, IORING_OFF_SQ_RING);
+    if (engine->ring == MAP_FAILED) {
+        engine->ring = NULL;
+        ring_unmap(engine);
+        return false;
+    }
+    engine->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    engine->sqes = mmap(NULL, engine->sqes_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, engine->ring_fd, IORING_OFF_SQES);
+    if (engine->sqes == MAP_FAILED) {
+        engine->sqes = NULL;
+        ring_unmap(engine);
+        return false;
+    }
+    
+    char* ring = engine->ring;
+    engine->sq_head = (_Atomic unsigned*)(ring + params.sq_off.head);
+    engine->sq_tail = (_Atomic unsigned*)(ring + params.sq_off.tail);
+    engine->sq_array = (unsigned*)(ring + params.sq_off.array);
+    engine->sq_mask = *(unsigned*)(ring + params.sq_off.ring_mask);
+    engine->sq_entries = params.sq_entries;
+    engine->cq_head = (_Atomic unsigned*)(ring + params.cq_off.head);
+    engine->cq_tail = (_Atomic unsigned*)(ring + params.cq_off.tail);
+    engine->cqes = (struct io_uring_cqe*)(ring + params.cq_off.cqes);
+    engine->cq_mask = *(unsigned*)(ring + params.cq_off.ring_mask);
+    engine->cq_entries = params.cq_entries;
+    return true;
+}
+
+// Create the engine for backend; AUTO settles on one here
+faeb_io_engine_t* faeb_io_engine_create(faeb_io_backend_t backend) {
+    faeb_io_engine_t* engine = calloc(1, sizeof(faeb_io_engine_t));
+    if (!engine) return NULL;
+    
+    engine->ring_fd = -1;
+    engine->event_fd = -1;
+    if (backend != FAEB_IO_BACKEND_THREADS && ring_setup(engine)) {
+        engine->backend = FAEB_IO_BACKEND_URING;
+        return engine;
+    }
+    if (backend == FAEB_IO_BACKEND_URING) {
+        free(engine);
+        return NULL;
+    }
+    
+    engine->backend = FAEB_IO_BACKEND_THREADS;
+    engine->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (engine->event_fd < 0) {
+        free(engine);
+        return NULL;
+    }
+    return engine;
+}
+
+static void ring_reap(faeb_io_engine_t* engine);
+
+// Destroy an engine nobody waits on. Requests orphaned by destroyed
+// processes may still write to the stacks they hold: wait them out.
+void faeb_io_engine_destroy(faeb_io_engine_t* engine) {
+    if (!engine) return;
+    
+    while (engine->backend == FAEB_IO_BACKEND_URING && engine->inflight) {
+        if (ring_enter(engine, engine->queued, 1, NULL) < 0 && errno != EINTR) break;
+        ring_reap(engine);
+    }
+    ring_unmap(engine);
+    if (engine->event_fd >= 0) {
+        // A pool thread wakes the last process before writing to event_fd,
+        // both under the pool lock: wait it out before closing
+        pthread_mutex_lock(&io_pool.lock);
+        pthread_mutex_unlock(&io_pool.lock);
+        close(engine->event_fd);
+    }
+    free(engine);
+}
+
+faeb_io_backend_t faeb_io_engine_backend(faeb_io_engine_t* engine) {
+    return engine->backend;
+}
+
+size_t faeb_io_engine_pending(faeb_io_engine_t* engine) {
+    return engine ? engine->pending : 0;
+}
+
+void faeb_io_engine_stats(faeb_io_engine_t* engine, faeb_scheduler_stats_t* stats) {
+    if (!engine) return;
+    
+    stats->io_pending = engine->pending;
+    stats->io_requests = engine->requests;
+    stats->io_enters = engine->enters;
+}
+
+// Wake the process of every completion in the ring
+static void ring_reap(faeb_io_engine_t* engine) {
+    unsigned head = atomic_load_explicit(engine->cq_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(engine->cq_tail, memory_order_acquire);
+    if (head == tail) return;
+    
+    for (; head != tail; head++) {
+        struct io_uring_cqe* cqe = &engine->cqes[head & engine->cq_mask];
+        struct io_request* request = (struct io_request*)(uintptr_t)cqe->user_data;
+        engine->inflight--;
+        // Cancellations carry no request; nobody waits for them
+        if (!request) continue;
+        if (request->orphan) {
+            engine->pending--;
+            faeb_process_release(request->orphan);
+            continue;
+        }
+        request->result = cqe->res;
+        request->done = true;
+        faeb_process_wake(wait_queue_pop(&request->waiters));
+    }
+    atomic_store_explicit(engine->cq_head, head, memory_order_release);
+}
+
+// Reap what has completed, and submit what is queued once per timer tick
+// so requests made between ticks go to the kernel together
+void faeb_io_engine_poll(faeb_io_engine_t* engine, uint64_t tick) {
+    if (engine->backend != FAEB_IO_BACKEND_URING || engine->pending == 0) return;
+    
+    if (engine->queued && tick != engine->submit_tick) {
+        engine->submit_tick = tick;
+        ring_enter(engine, engine->queued, 0, NULL);
+    }
+    ring_reap(engine);
+}
+
+// Nothing can run: submit, then wait for a completion or until_ns
+void faeb_io_engine_wait(faeb_io_engine_t* engine, uint64_t until_ns) {
+    struct timespec timeout;
+    const struct timespec* limit = NULL;
+    int wait_ms = -1;
+    if (until_ns != UINT64_MAX) {
+        uint64_t now = faeb_timer_now_ns();
+        uint64_t left = until_ns > now ? until_ns - now : 0;
+        timeout.tv_sec = (time_t)(left / 1000000000ULL);
+        timeout.tv_nsec = (long)(left % 1000000000ULL);
+        limit = &timeout;
+        uint64_t ms = (left + 999999) / 1000000;
+        wait_ms = ms > INT_MAX ? INT_MAX : (int)ms;
+    }
+    
+    if (engine->backend == FAEB_IO_BACKEND_URING) {
+        ring_reap(engine);
+        ring_enter(engine, engine->queued, 1, limit);
+        ring_reap(engine);
+        return;
+    }
+    
+    struct pollfd event = { .fd = engine->event_fd, .events = POLLIN };
+    if (poll(&event, 1, wait_ms) > 0) {
+        uint64_t count;
+        ssize_t ignored = read(engine->event_fd, &count, sizeof(count));
+        (void)ignored;
+    }
+}
+
+// The loop is about to sleep on this engine's descriptor among others:
+// hand the kernel what is queued, and drop thread pool wakeups already
+// seen so only new completions end the sleep
+int faeb_io_engine_prepare(faeb_io_engine_t* engine) {
+    if (engine->backend == FAEB_IO_BACKEND_URING) {
+        if (engine->queued) {
+            ring_enter(engine, engine->queued, 0, NULL);
+        }
+        return engine->ring_fd;
+    }
+    
+    uint64_t count;
+    ssize_t ignored = read(engine->event_fd, &count, sizeof(count));
+    (void)ignored;
+    return engine->event_fd;
+}
+
+// Cleared ring entry to fill in before ring_push, NULL when the ring
+// fails. A full submission ring is submitted early; with as many requests
+// in flight as the completion ring holds, the thread waits for one to
+// complete rather than overflow it.
+static struct io_uring_sqe* ring_next(faeb_io_engine_t* engine) {
+    unsigned tail = atomic_load_explicit(engine->sq_tail, memory_order_relaxed);
+    while (tail - atomic_load_explicit(engine->sq_head, memory_order_acquire) ==
+           engine->sq_entries || engine->inflight >= engine->cq_entries) {
+        unsigned wait = engine->inflight >= engine->cq_entries ? 1 : 0;
+        if (ring_enter(engine, engine->queued, wait, NULL) < 0 && errno != EINTR) return NULL;
+        ring_reap(engine);
+    }
+    
+    struct io_uring_sqe* sqe = &engine->sqes[tail & engine->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+// Queue the entry ring_next handed out
+static void ring_push(faeb_io_engine_t* engine) {
+    unsigned tail = atomic_load_explicit(engine->sq_tail, memory_order_relaxed);
+    unsigned index = tail & engine->sq_mask;
+    engine->sq_array[index] = index;
+    atomic_store_explicit(engine->sq_tail, tail + 1, memory_order_release);
+    engine->queued++;
+    engine->inflight++;
+}
+
+// Queue a ring entry for request
+static bool ring_queue(faeb_io_engine_t* engine, struct io_request* request) {
+    struct io_uring_sqe* sqe = ring_next(engine);
+    if (!sqe) return false;
+    
+    sqe->opcode = request->write ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe->fd = request->fd;
+    sqe->addr = (uint64_t)(uintptr_t)request->buffer;
+    sqe->len = (uint32_t)request->size;
+    sqe->off = request->offset < 0 ? (uint64_t)-1 : (uint64_t)request->offset;
+    sqe->user_data = (uint64_t)(uintptr_t)request;
+    ring_push(engine);
+    return true;
+}
+
+// The process parked on a request is being destroyed, off the request's
+// wait queue already. Returns true when the request is still in flight:
+// the engine then keeps the process and frees it once the request
+// completes. With io_uring the request is cancelled and stays pending
+// until reaped; a thread pool request not yet taken is just dropped.
+bool faeb_io_engine_forget(struct faeb_process* process) {
+    struct io_request* request = process->io_request;
+    faeb_io_engine_t* engine = request->engine;
+    process->io_request = NULL;
+    
+    if (engine && engine->backend == FAEB_IO_BACKEND_URING) {
+        if (request->done) {
+            engine->pending--;
+            return false;
+        }
+        request->orphan = process;
+        struct io_uring_sqe* sqe = ring_next(engine);
+        if (sqe) {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = (uint64_t)(uintptr_t)request;
+            ring_push(engine);
+        }
+        return true;
+    }
+    
+    pthread_mutex_lock(&io_pool.lock);
+    bool in_flight = !request->done;
+    if (in_flight) {
+        struct io_request* previous = NULL;
+        struct io_request* queued = io_pool.head;
+        while (queued && queued != request) {
+            previous = queued;
+            queued = queued->next;
+        }
+        if (queued) {
+            if (previous) {
+                previous->next = request->next;
+            } else {
+                io_pool.head = request->next;
+            }
+            if (io_pool.tail == request) io_pool.tail = previous;
+            io_pool.queued--;
+            in_flight = false;
+        } else {
+            request->orphan = process;
+        }
+    }
+    pthread_mutex_unlock(&io_pool.lock);
+    if (engine) engine->pending--;
+    return in_flight;
+}
+
+// Read or write from the running process, parking it until done
+static ssize_t io_transfer(bool write_op, int fd, void* buffer, size_t size, int64_t offset) {
+    if (size > FAEB_IO_MAX_CHUNK) size = FAEB_IO_MAX_CHUNK;
+    struct faeb_process* process = faeb_process_self();
+    bool on_worker = process && faeb_scheduler_on_worker();
+    faeb_scheduler_t* scheduler = faeb_scheduler_running();
+    if (!process || (!on_worker && (!scheduler || process->scheduler != scheduler))) {
+        return io_syscall(write_op, fd, buffer, size, offset);
+    }
+    
+    faeb_io_engine_t* engine = NULL;
+    if (!on_worker) {
+        engine = faeb_scheduler_io_engine(scheduler);
+        if (!engine) return io_syscall(write_op, fd, buffer, size, offset);
+    }
+    struct io_request request = {
+        .engine = engine, .write = write_op, .fd = fd, .buffer = buffer,
+        .size = size, .offset = offset
+    };
+    
+    if (engine && engine->backend == FAEB_IO_BACKEND_URING) {
+        if (!ring_queue(engine, &request)) return io_syscall(write_op, fd, buffer, size, offset);
+        engine->pending++;
+        engine->requests++;
+        process->io_request = &request;
+        faeb_process_park(&request.waiters, NULL);
+        process->io_request = NULL;
+        engine->pending--;
+    } else {
+        pthread_once(&io_pool.once, io_pool_start);
+        pthread_mutex_lock(&io_pool.lock);
+        if (io_pool.threads == 0) {
+            pthread_mutex_unlock(&io_pool.lock);
+            return io_syscall(write_op, fd, buffer, size, offset);
+        }
+        if (engine) {
+            engine->pending++;
+            engine->requests++;
+        }
+        process->io_request = &request;
+        io_pool_push(&request);
+        faeb_process_park(&request.waiters, &io_pool.lock);
+        process->io_request = NULL;
+        if (engine) engine->pending--;
+    }
+    
+    if (request.result < 0) {
+        errno = (int)-request.result;
+        return -1;
+    }
+    return request.result;
+}
+
+ssize_t faeb_io_engine_read(int fd, void* buffer, size_t size, int64_t offset) {
+    return io_transfer(false, fd, buffer, size, offset);
+}
+
+ssize_t faeb_io_engine_write(int fd, const void* buffer, size_t size, int64_t offset) {
+    return io_transfer(true, fd, (void*)buffer, size, offset);
+}
+
+// Read up to size bytes at offset, or at the file position when offset
+// is -1, storing the count in done
+faeb_result_t faeb_io_pread(int fd, void* buffer, size_t size, int64_t offset, size_t* done) {
+    if (fd < 0 || (!buffer && size) || offset < -1) return FAEB_ERROR_INVALID;
+    
+    ssize_t result;
+    do {
+        result = io_transfer(false, fd, buffer, size, offset);
+    } while (result < 0 && errno == EINTR);
+    if (done) {
+        *done = result > 0 ? (size_t)result : 0;
+    }
+    return result < 0 ? FAEB_ERROR_IO : FAEB_SUCCESS;
+}
+
+// Write up to size bytes at offset, or at the file position when offset
+// is -1, storing the count in done
+faeb_result_t faeb_io_pwrite(int fd, const void* buffer, size_t size, int64_t offset,
+                             size_t* done) {
+    if (fd < 0 || (!buffer && size) || offset < -1) return FAEB_ERROR_INVALID;
+    
+    ssize_t result;
+    do {
+        result = io_transfer(true, fd, (void*)buffer, size, offset);
+    } while (result < 0 && errno == EINTR);
+    if (done) {
+        *done = result > 0 ? (size_t)result : 0;
+    }
+    return result < 0 ? FAEB_ERROR_IO : FAEB_SUCCESS;
+}
@@ -0,0 +1,343 @@
+/* faeb Core Runtime - Channels
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#include "internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+// Bounded ring of fixed-size messages. The fast path never takes a lock:
+// SPSC channels move a head and a tail index that each side owns, MPMC
+// channels claim slots with a per-slot turn number (Vyukov's bounded
+// queue). Only a side that finds the ring full or empty takes the lock,
+// registers as a waiter and parks; the other side looks for waiters
+// after every operation, and the waiter count plus a full fence on both
+// sides makes sure one of them sees the other.
+struct faeb_channel {
+    // Consumer side
+    _Alignas(FAEB_CACHE_LINE_SIZE) _Atomic size_t head;
+    size_t tail_cache;              // SPSC: producer index last seen
+
+    // Producer side
+    _Alignas(FAEB_CACHE_LINE_SIZE) _Atomic size_t tail;
+    size_t head_cache;              // SPSC: consumer index last seen
+
+    // Parked processes
+    _Alignas(FAEB_CACHE_LINE_SIZE) pthread_mutex_t lock;
+    faeb_wait_queue_t senders;
+    faeb_wait_queue_t receivers;
+    _Atomic size_t send_waiters;
+    _Atomic size_t receive_waiters;
+    _Atomic bool closed;
+
+    faeb_channel_kind_t kind;
+    size_t message_size;
+    size_t capacity;                // Power of two
+    _Atomic size_t* turns;          // MPMC: per-slot turn numbers
+    unsigned char* slots;
+};
+
+// Create a channel of capacity messages of message_size bytes each;
+// the capacity is rounded up to a power of two
+faeb_channel_t* faeb_channel_create(faeb_channel_kind_t kind, size_t message_size,
+                                    size_t capacity) {
+    if (message_size == 0 || capacity == 0 || capacity > SIZE_MAX / 4 / message_size) {
+        return NULL;
+    }
+    if (kind != FAEB_CHANNEL_SPSC && kind != FAEB_CHANNEL_MPMC) {
+        return NULL;
+    }
+    
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    
+    faeb_channel_t* channel = aligned_alloc(FAEB_CACHE_LINE_SIZE, sizeof(faeb_channel_t));
+    if (!channel) return NULL;
+    memset(channel, 0, sizeof(*channel));
+    
+    channel->slots = malloc(rounded * message_size);
+    if (kind == FAEB_CHANNEL_MPMC) {
+        channel->turns = malloc(rounded * sizeof(*channel->turns));
+    }
+    if (!channel->slots || (kind == FAEB_CHANNEL_MPMC && !channel->turns)) {
+        free(channel->slots);
+        free(channel->turns);
+        free(channel);
+        return NULL;
+    }
+    
+    // Slot i first takes the message sent at position i
+    if (channel->turns) {
+        for (size_t i = 0; i < rounded; i++) {
+            atomic_init(&channel->turns[i], i);
+        }
+    }
+    
+    atomic_init(&channel->head, 0);
+    atomic_init(&channel->tail, 0);
+    atomic_init(&channel->send_waiters, 0);
+    atomic_init(&channel->receive_waiters, 0);
+    atomic_init(&channel->closed, false);
+    pthread_mutex_init(&channel->lock, NULL);
+    channel->kind = kind;
+    channel->message_size = message_size;
+    channel->capacity = rounded;
+    
+    return channel;
+}
+
+// Destroy a channel; processes still parked on it stay blocked
+void faeb_channel_destroy(faeb_channel_t* channel) {
+    if (!channel) return;
+    
+    pthread_mutex_destroy(&channel->lock);
+    free(channel->turns);
+    free(channel->slots);
+    free(channel);
+}
+
+// Copy up to count messages in; returns how many went in
+static size_t channel_push(faeb_channel_t* channel, const unsigned char* messages,
+                           size_t count) {
+    size_t size = channel->message_size;
+    size_t mask = channel->capacity - 1;
+    
+    if (channel->kind == FAEB_CHANNEL_SPSC) {
+        size_t tail = atomic_load_explicit(&channel->tail, memory_order_relaxed);
+        size_t space = channel->capacity - (tail - channel->head_cache);
+        if (space < count) {
+            channel->head_cache = atomic_load_explicit(&channel->head, memory_order_acquire);
+            space = channel->capacity - (tail - channel->head_cache);
+        }
+        size_t n = count < space ? count : space;
+        if (n == 0) return 0;
+        
+        // At most two runs: up to the end of the ring, then from its start
+        size_t first = tail & mask;
+        size_t run = n < channel->capacity - first ? n : channel->capacity - first;
+        memcpy(channel->slots + first * size, messages, run * size);
+        memcpy(channel->slots, messages + run * size, (n - run) * size);
+        atomic_store_explicit(&channel->tail, tail + n, memory_order_release);
+        return n;
+    }
+    
+    size_t sent = 0;
+    while (sent < count) {
+        size_t position = atomic_load_explicit(&channel->tail, memory_order_relaxed);
+        for (;;) {
+            size_t turn = atomic_load_explicit(&channel->turns[position & mask],
+                                               memory_order_acquire);
+            intptr_t lag = (intptr_t)turn - (intptr_t)position;
+            if (lag == 0) {
+                if (atomic_compare_exchange_weak_explicit(&channel->tail, &position,
+                                                          position + 1,
+                                                          memory_order_relaxed,
+                                                          memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                return sent;    // Full
+            } else {
+                position = atomic_load_explicit(&channel->tail, memory_order_relaxed);
+            }
+        }
+        
+        memcpy(channel->slots + (position & mask) * size, messages + sent * size, size);
+        atomic_store_explicit(&channel->turns[position & mask], position + 1,
+                              memory_order_release);
+        sent++;
+    }
+    return sent;
+}
+
+// Copy up to count messages out; returns how many came out
+static size_t channel_pop(faeb_channel_t* channel, unsigned char* messages, size_t count) {
+    size_t size = channel->message_size;
+    size_t mask = channel->capacity - 1;
+    
+    if (channel->kind == FAEB_CHANNEL_SPSC) {
+        size_t head = atomic_load_explicit(&channel->head, memory_order_relaxed);
+        size_t available = channel->tail_cache - head;
+        if (available < count) {
+            channel->tail_cache = atomic_load_explicit(&channel->tail, memory_order_acquire);
+            available = channel->tail_cache - head;
+        }
+        size_t n = count < available ? count : available;
+        if (n == 0) return 0;
+        
+        size_t first = head & mask;
+        size_t run = n < channel->capacity - first ? n : channel->capacity - first;
+        memcpy(messages, channel->slots + first * size, run * size);
+        memcpy(messages + run * size, channel->slots, (n - run) * size);
+        atomic_store_explicit(&channel->head, head + n, memory_order_release);
+        return n;
+    }
+    
+    size_t received = 0;
+    while (received < count) {
+        size_t position = atomic_load_explicit(&channel->head, memory_order_relaxed);
+        for (;;) {
+            size_t turn = atomic_load_explicit(&channel->turns[position & mask],
+                                               memory_order_acquire);
+            intptr_t lag = (intptr_t)turn - (intptr_t)(position + 1);
+            if (lag == 0) {
+                if (atomic_compare_exchange_weak_explicit(&channel->head, &position,
+                                                          position + 1,
+                                                          memory_order_relaxed,
+                                                          memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                return received;    // Empty
+            } else {
+                position = atomic_load_explicit(&channel->head, memory_order_relaxed);
+            }
+        }
+        
+        memcpy(messages + received * size, channel->slots + (position & mask) * size, size);
+        atomic_store_explicit(&channel->turns[position & mask], position + channel->capacity,
+                              memory_order_release);
+        received++;
+    }
+    return received;
+}
+
+// After moving count messages, wake up to count processes parked on the
+// other side. The fence pairs with the waiter's increment: either the
+// waiter's recheck sees our messages or we see the waiter.
+static void channel_wake(faeb_channel_t* channel, _Atomic size_t* waiters,
+                         faeb_wait_queue_t* queue, size_t count) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(waiters, memory_order_relaxed) == 0) return;
+    
+    pthread_mutex_lock(&channel->lock);
+    struct faeb_process* process;
+    while (count-- > 0 && (process = wait_queue_pop(queue)) != NULL) {
+        atomic_fetch_sub_explicit(waiters, 1, memory_order_relaxed);
+        faeb_process_wake(process);
+    }
+    pthread_mutex_unlock(&channel->lock);
+}
+
+// Send all count messages, parking while the channel is full. Stops
+// early when the channel is closed, or when it is full and the caller
+// is not a process.
+static size_t channel_send(faeb_channel_t* channel, const unsigned char* messages,
+                           size_t count) {
+    size_t sent = 0;
+    
+    while (sent < count && !atomic_load_explicit(&channel->closed, memory_order_relaxed)) {
+        size_t n = channel_push(channel, messages + sent * channel->message_size, count - sent);
+        if (n == 0) {
+            pthread_mutex_lock(&channel->lock);
+            atomic_fetch_add(&channel->send_waiters, 1);
+            n = channel_push(channel, messages + sent * channel->message_size, count - sent);
+            if (n == 0 && !atomic_load(&channel->closed) && faeb_process_self()) {
+                faeb_process_park(&channel->senders, &channel->lock);
+                continue;
+            }
+            atomic_fetch_sub(&channel->send_waiters, 1);
+            pthread_mutex_unlock(&channel->lock);
+            if (n == 0) break;
+        }
+        sent += n;
+        channel_wake(channel, &channel->receive_waiters, &channel->receivers, n);
+    }
+    
+    return sent;
+}
+
+// Receive between one and count messages, parking while the channel is
+// empty. Returns 0 once the channel is closed and drained, or when it is
+// empty and the caller is not a process.
+static size_t channel_receive(faeb_channel_t* channel, unsigned char* messages,
+                              size_t count) {
+    for (;;) {
+        size_t n = channel_pop(channel, messages, count);
+        if (n == 0) {
+            pthread_mutex_lock(&channel->lock);
+            atomic_fetch_add(&channel->receive_waiters, 1);
+            n = channel_pop(channel, messages, count);
+            if (n == 0 && !atomic_load(&channel->closed) && faeb_process_self()) {
+                faeb_process_park(&channel->receivers, &channel->lock);
+                continue;
+            }
+            atomic_fetch_sub(&channel->receive_waiters, 1);
+            pthread_mutex_unlock(&channel->lock);
+            if (n == 0) return 0;
+        }
+        channel_wake(channel, &channel->send_waiters, &channel->senders, n);
+        return n;
+    }
+}
+
+// Send one message, parking the calling process while the channel is full
+faeb_result_t faeb_channel_send(faeb_channel_t* channel, const void* message) {
+    if (!channel || !message) return FAEB_ERROR_INVALID;
+    
+    return channel_send(channel, message, 1) == 1 ? FAEB_SUCCESS : FAEB_ERROR_INVALID;
+}
+
+// Receive one message, parking the calling process while the channel is
+// empty. FAEB_ERROR_IO once the channel is closed and drained.
+faeb_result_t faeb_channel_receive(faeb_channel_t* channel, void* message) {
+    if (!channel || !message) return FAEB_ERROR_INVALID;
+    
+    if (channel_receive(channel, message, 1) == 1) return FAEB_SUCCESS;
+    return atomic_load(&channel->closed) ? FAEB_ERROR_IO : FAEB_ERROR_INVALID;
+}
+
+bool faeb_channel_try_send(faeb_channel_t* channel, const void* message) {
+    if (!channel || !message || atomic_load(&channel->closed)) return false;
+    
+    if (channel_push(channel, message, 1) == 0) return false;
+    channel_wake(channel, &channel->receive_waiters, &channel->receivers, 1);
+    return true;
+}
+
+bool faeb_channel_try_receive(faeb_channel_t* channel, void* message) {
+    if (!channel || !message) return false;
+    
+    if (channel_pop(channel, message, 1) == 0) return false;
+    channel_wake(channel, &channel->send_waiters, &channel->senders, 1);
+    return true;
+}
+
+// Send count contiguous messages; returns how many were sent, which is
+// count unless the channel was closed
+size_t faeb_channel_send_batch(faeb_channel_t* channel, const void* messages, size_t count) {
+    if (!channel || !messages) return 0;
+    
+    return channel_send(channel, messages, count);
+}
+
+// Receive up to count messages, waiting only for the first; returns how
+// many arrived, 0 once the channel is closed and drained
+size_t faeb_channel_receive_batch(faeb_channel_t* channel, void* messages, size_t count) {
+    if (!channel || !messages || count == 0) return 0;
+    
+    return channel_receive(channel, messages, count);
+}
+
+// Refuse further sends and release every parked process. Messages
+// already sent can still be received.
+void faeb_channel_close(faeb_channel_t* channel) {
+    if (!channel) return;
+    
+    pthread_mutex_lock(&channel->lock);
+    atomic_store(&channel->closed, true);
+    struct faeb_process* process;
+    while ((process = wait_queue_pop(&channel->senders)) != NULL) {
+        faeb_process_wake(process);
+    }
+    while ((process = wait_queue_pop(&channel->receivers)) != NULL) {
+        faeb_process_wake(process);
+    }
+    atomic_store(&channel->send_waiters, 0);
+    atomic_store(&channel->receive_waiters, 0);
+    pthread_mutex_unlock(&channel->lock);
+}
@@ -0,0 +1,283 @@
+/* faeb Core Runtime - Futures
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#include "internal.h"
+#include <stdlib.h>
+#include <stdatomic.h>
+
+// A future is a one-shot result slot with a FIFO of parked processes and
+// a list of continuations, both guarded by one lock. Completing it wakes
+// the processes and runs the continuations after the lock is dropped,
+// so a continuation may complete other futures. Combinators are plain
+// futures whose continuations sit on their children; they take no
+// process of their own.
+
+struct faeb_future_link {
+    struct faeb_future_link* next;
+    faeb_future_t* parent;               // Combinator waiting on this child
+    size_t index;                        // Child's position in the combinator
+    void (*callback)(void* context, void* result);
+    void* context;
+};
+
+struct faeb_future {
+    pthread_mutex_t lock;
+    faeb_wait_queue_t waiters;
+    struct faeb_future_link* links;      // Pending continuations, newest first
+    void* result;
+    bool ready;
+    _Atomic size_t references;
+
+    // Combinators count their children down; spawned futures remember
+    // the work their process runs
+    bool any;                            // when_any rather than when_all
+    _Atomic size_t remaining;            // when_all children still running
+    struct faeb_future_link* children;   // One link per child, owned here
+    faeb_future_fn function;             // faeb_future_spawn's work
+    void* context;
+};
+
+static faeb_future_t* future_alloc(size_t references) {
+    faeb_future_t* future = calloc(1, sizeof(faeb_future_t));
+    if (!future) return NULL;
+    
+    pthread_mutex_init(&future->lock, NULL);
+    atomic_init(&future->references, references);
+    atomic_init(&future->remaining, 0);
+    return future;
+}
+
+static void link_fire(struct faeb_future_link* link, void* result);
+
+// Drop one reference. A future freed before completing lets go of the
+// combinators waiting on it; they never complete.
+static void future_release(faeb_future_t* future) {
+    if (atomic_fetch_sub_explicit(&future->references, 1, memory_order_acq_rel) != 1) return;
+    
+    struct faeb_future_link* link = future->links;
+    while (link) {
+        struct faeb_future_link* next = link->next;
+        if (link->parent) {
+            future_release(link->parent);
+        } else {
+            free(link);
+        }
+        link = next;
+    }
+    free(future->children);
+    pthread_mutex_destroy(&future->lock);
+    free(future);
+}
+
+// Run a continuation now, or keep it until the future completes
+static void future_attach(faeb_future_t* future, struct faeb_future_link* link) {
+    pthread_mutex_lock(&future->lock);
+    if (future->ready) {
+        void* result = future->result;
+        pthread_mutex_unlock(&future->lock);
+        link_fire(link, result);
+        return;
+    }
+    link->next = future->links;
+    future->links = link;
+    pthread_mutex_unlock(&future->lock);
+}
+
+// Create an incomplete future for faeb_future_complete to finish
+faeb_future_t* faeb_future_create(void) {
+    return future_alloc(1);
+}
+
+// Take another reference, released by another faeb_future_destroy
+void faeb_future_retain(faeb_future_t* future) {
+    if (!future) return;
+    
+    atomic_fetch_add_explicit(&future->references, 1, memory_order_relaxed);
+}
+
+// Release the caller's reference. A spawned process or a combinator
+// still holding one keeps the future alive until it is done with it.
+void faeb_future_destroy(faeb_future_t* future) {
+    if (!future) return;
+    
+    future_release(future);
+}
+
+// Complete the future with result, waking every process awaiting it and
+// running its continuations. Only the first completion counts.
+faeb_result_t faeb_future_complete(faeb_future_t* future, void* result) {
+    if (!future) return FAEB_ERROR_INVALID;
+    
+    pthread_mutex_lock(&future->lock);
+    if (future->ready) {
+        pthread_mutex_unlock(&future->lock);
+        return FAEB_ERROR_INVALID;
+    }
+    future->result = result;
+    future->ready = true;
+    struct faeb_process* process;
+    while ((process = wait_queue_pop(&future->waiters)) != NULL) {
+        faeb_process_wake(process);
+    }
+    struct faeb_future_link* link = future->links;
+    future->links = NULL;
+    pthread_mutex_unlock(&future->lock);
+    
+    // Oldest continuation first
+    struct faeb_future_link* oldest = NULL;
+    while (link) {
+        struct faeb_future_link* next = link->next;
+        link->next = oldest;
+        oldest = link;
+        link = next;
+    }
+    while (oldest) {
+        struct faeb_future_link* next = oldest->next;
+        link_fire(oldest, result);
+        oldest = next;
+    }
+    return FAEB_SUCCESS;
+}
+
+bool faeb_future_is_ready(faeb_future_t* future) {
+    if (!future) return false;
+    
+    pthread_mutex_lock(&future->lock);
+    bool ready = future->ready;
+    pthread_mutex_unlock(&future->lock);
+    return ready;
+}
+
+// Wait for the result. Outside of a process this only succeeds when the
+// future has already completed.
+faeb_result_t faeb_future_await(faeb_future_t* future, void** result) {
+    if (!future) return FAEB_ERROR_INVALID;
+    
+    pthread_mutex_lock(&future->lock);
+    if (!future->ready) {
+        if (!faeb_process_self()) {
+            pthread_mutex_unlock(&future->lock);
+            return FAEB_ERROR_INVALID;
+        }
+        
+        // The completer sets the result before waking us
+        faeb_process_park(&future->waiters, &future->lock);
+        pthread_mutex_lock(&future->lock);
+    }
+    if (result) {
+        *result = future->result;
+    }
+    pthread_mutex_unlock(&future->lock);
+    return FAEB_SUCCESS;
+}
+
+// Call callback(context, result) once the future completes, on whichever
+// process or thread completes it. FAEB_ERROR_INVALID when it already
+// has, in which case callback is not called.
+faeb_result_t faeb_future_then(faeb_future_t* future,
+                               void (*callback)(void* context, void* result),
+                               void* context) {
+    if (!future || !callback) return FAEB_ERROR_INVALID;
+    
+    struct faeb_future_link* link = calloc(1, sizeof(*link));
+    if (!link) return FAEB_ERROR_MEMORY;
+    link->callback = callback;
+    link->context = context;
+    
+    pthread_mutex_lock(&future->lock);
+    if (future->ready) {
+        pthread_mutex_unlock(&future->lock);
+        free(link);
+        return FAEB_ERROR_INVALID;
+    }
+    link->next = future->links;
+    future->links = link;
+    pthread_mutex_unlock(&future->lock);
+    return FAEB_SUCCESS;
+}
+
+// Process body of faeb_future_spawn
+static void future_main(void* context) {
+    faeb_future_t* future = context;
+    faeb_future_complete(future, future->function(future->context));
+    future_release(future);
+}
+
+// Run function(context) in a new detached process, on the calling
+// worker or the current scheduler like faeb_process_spawn, and complete
+// the future with what it returns
+faeb_future_t* faeb_future_spawn(faeb_future_fn function, void* context) {
+    if (!function) return NULL;
+    
+    // One reference for the caller, one for the process
+    faeb_future_t* future = future_alloc(2);
+    if (!future) return NULL;
+    future->function = function;
+    future->context = context;
+    
+    if (faeb_process_spawn(future_main, future) != FAEB_SUCCESS) {
+        future_release(future);
+        future_release(future);
+        return NULL;
+    }
+    return future;
+}
+
+// A child of a combinator completed: when_all counts down, when_any
+// completes with the first child's index. Each link holds a reference
+// on its combinator.
+static void link_fire(struct faeb_future_link* link, void* result) {
+    faeb_future_t* parent = link->parent;
+    if (!parent) {
+        link->callback(link->context, result);
+        free(link);
+        return;
+    }
+    
+    if (parent->any) {
+        faeb_future_complete(parent, (void*)(uintptr_t)link->index);
+    } else if (atomic_fetch_sub_explicit(&parent->remaining, 1, memory_order_acq_rel) == 1) {
+        faeb_future_complete(parent, NULL);
+    }
+    future_release(parent);
+}
+
+static faeb_future_t* future_combine(faeb_future_t* const* futures, size_t count, bool any) {
+    if (!futures || count == 0) return NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (!futures[i]) return NULL;
+    }
+    
+    faeb_future_t* future = future_alloc(1 + count);
+    if (!future) return NULL;
+    future->children = calloc(count, sizeof(struct faeb_future_link));
+    if (!future->children) {
+        pthread_mutex_destroy(&future->lock);
+        free(future);
+        return NULL;
+    }
+    future->any = any;
+    atomic_init(&future->remaining, count);
+    
+    for (size_t i = 0; i < count; i++) {
+        struct faeb_future_link* link = &future->children[i];
+        link->parent = future;
+        link->index = i;
+        future_attach(futures[i], link);
+    }
+    return future;
+}
+
+// Complete once every future has, with a NULL result; read each child
+// for its own
+faeb_future_t* faeb_future_when_all(faeb_future_t* const* futures, size_t count) {
+    return future_combine(futures, count, false);
+}
+
+// Complete as soon as one future has, with the index of the first one
+// as a uintptr_t result
+faeb_future_t* faeb_future_when_any(faeb_future_t* const* futures, size_t count) {
+    return future_combine(futures, count, true);
+}
@@ -0,0 +1,484 @@
+/* faeb Core Runtime - Internal Definitions
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#ifndef FAEB_INTERNAL_H
+#define FAEB_INTERNAL_H
+
+#include "faeb/runtime.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/types.h>
+
+// Saved execution context. On x86-64 and AArch64 the callee-saved
+// registers live on the suspended stack and only its pointer is kept;
+// elsewhere ucontext does the work.
+#if (defined(__x86_64__) || defined(__aarch64__)) && defined(__ELF__)
+#define FAEB_CONTEXT_ASM 1
+typedef struct {
+    void* stack_pointer;
+} faeb_context_t;
+#else
+#include <ucontext.h>
+typedef ucontext_t faeb_context_t;
+#endif
+
+// Hierarchical timer wheel: FAEB_TIMER_LEVELS levels of 64 slots over
+// CLOCK_MONOTONIC ticks. Arm and cancel are O(1); advancing costs one
+// step per occupied slot or cascade, not per tick.
+#define FAEB_TIMER_TICK_NS 1000000ULL   // 1 ms
+#define FAEB_TIMER_LEVEL_BITS 6
+#define FAEB_TIMER_SLOTS (1 << FAEB_TIMER_LEVEL_BITS)
+#define FAEB_TIMER_LEVELS 6
+
+struct faeb_process;
+typedef struct faeb_timer faeb_timer_t;
+typedef struct faeb_timer_wheel faeb_timer_wheel_t;
+
+struct faeb_timer {
+    faeb_timer_t* next;
+    faeb_timer_t* prev;
+    faeb_timer_wheel_t* wheel;    // Non-NULL while pending
+    uint64_t expires;             // Absolute tick
+    uint8_t level;
+    uint8_t slot;
+    void (*fire)(faeb_timer_wheel_t* wheel, faeb_timer_t* timer);
+};
+
+struct faeb_timer_wheel {
+    uint64_t now;                 // Last tick processed
+    size_t count;
+    uint64_t occupied[FAEB_TIMER_LEVELS];
+    faeb_timer_t* slots[FAEB_TIMER_LEVELS][FAEB_TIMER_SLOTS];
+    void (*ready)(struct faeb_process* process);  // Requeues a woken process
+};
+
+uint64_t faeb_timer_now_ns(void);
+uint64_t faeb_timer_now(void);
+uint64_t faeb_timer_deadline(uint64_t milliseconds);
+void faeb_timer_sleep_until(uint64_t tick);
+void faeb_timer_sleep_until_ns(uint64_t ns);
+void faeb_timer_wheel_init(faeb_timer_wheel_t* wheel, void (*ready)(struct faeb_process* process));
+void faeb_timer_arm(faeb_timer_wheel_t* wheel, faeb_timer_t* timer, uint64_t expires);
+void faeb_timer_cancel(faeb_timer_t* timer);
+void faeb_timer_wheel_clear(faeb_timer_wheel_t* wheel);
+size_t faeb_timer_advance(faeb_timer_wheel_t* wheel, uint64_t tick);
+uint64_t faeb_timer_next(faeb_timer_wheel_t* wheel);
+void faeb_timer_set_local(faeb_timer_wheel_t* wheel);
+faeb_timer_wheel_t* faeb_timer_get_local(void);
+
+// Process state enumeration
+typedef enum {
+    FAEB_PROCESS_READY,
+    FAEB_PROCESS_RUNNING,
+    FAEB_PROCESS_BLOCKED,
+    FAEB_PROCESS_TERMINATED
+} faeb_process_state_t;
+
+// A process that has waited this many picks at the lowest occupied level
+// is promoted one level, so low priorities cannot starve
+#define FAEB_RUNQUEUE_AGING_PICKS 16
+
+// Ready processes as one intrusive FIFO per priority level plus a bitmap
+// of non-empty levels: push, remove and pick are all constant time
+typedef struct faeb_runqueue {
+    struct faeb_process* heads[FAEB_PROCESS_PRIORITIES];
+    struct faeb_process* tails[FAEB_PROCESS_PRIORITIES];
+    uint32_t ready_mask;    // Bit p is set while level p is non-empty
+    uint64_t picks;
+    size_t count;
+} faeb_runqueue_t;
+
+// Processes parked on a synchronization object, FIFO, linked through
+// their run queue pointers: a blocked process is never also queued to run
+typedef struct faeb_wait_queue {
+    struct faeb_process* head;
+    struct faeb_process* tail;
+    size_t count;
+} faeb_wait_queue_t;
+
+// Binary min-heap of deadline processes on a nanosecond key: the ready
+// ones by absolute deadline, those between jobs by next release.
+// Admission reserves a slot per process in each, so queueing never
+// allocates.
+typedef struct faeb_deadline_heap {
+    struct faeb_process** entries;
+    size_t count;
+    size_t capacity;
+} faeb_deadline_heap_t;
+
+typedef struct faeb_io_engine faeb_io_engine_t;
+typedef struct faeb_reactor faeb_reactor_t;
+
+// Scheduler instance: one run queue shared by the cooperative loop and
+// the tick-driven API, the tick scheduler's blocked queue and slice, and
+// one timer wheel for both. Only the thread running the instance touches
+// them; other threads hand woken processes over through the inbox.
+struct faeb_scheduler {
+    uint64_t id;                      // Unique; tags its statistics blocks
+    faeb_runqueue_t ready_queue;
+    faeb_deadline_heap_t deadlines;   // Picked before ready_queue
+    faeb_deadline_heap_t releases;    // Waiting for their next job
+    faeb_wait_queue_t blocked_queue;
+    struct faeb_process* current;     // Tick scheduler's running process
+    bool initialized;                 // Tick API enabled
+    int time_slice;
+    int current_time;
+    uint64_t slice_start_ns;          // When current was switched in
+    faeb_timer_wheel_t timers;
+
+    // Deadline admission: admitted processes and their summed density
+    // in parts per million
+    size_t deadline_processes;
+    uint64_t deadline_density;
+    _Atomic uint64_t deadline_misses;
+
+    // Asynchronous I/O, created on the first request from a process
+    faeb_io_engine_t* io;
+    faeb_io_backend_t io_backend;
+
+    // Descriptor readiness, created on the first wait or registration
+    faeb_reactor_t* reactor;
+
+    // Its processes submitted to the worker pool and not yet finished
+    _Atomic size_t submitted;
+
+    // Processes woken by other threads, newest first, linked through next
+    _Alignas(FAEB_CACHE_LINE_SIZE) _Atomic(struct faeb_process*) inbox;
+};
+
+// Process structure, shared by the process and scheduler modules
+struct faeb_process {
+    faeb_process_fn function;
+    void* context;
+    faeb_process_state_t state;
+    struct faeb_process* next;
+    int priority;
+
+    // Run queue linkage; level differs from priority while aged
+    struct faeb_process* prev;
+    faeb_runqueue_t* runqueue;
+    int level;
+    uint64_t enqueued_pick;
+    faeb_scheduler_t* scheduler;   // Scheduler it was created on
+
+    // Earliest-deadline-first parameters, period 0 when not admitted;
+    // the current job was released at release_ns and is due by deadline
+    uint64_t budget_ns;
+    uint64_t relative_deadline_ns;
+    uint64_t period_ns;
+    uint64_t release_ns;
+    uint64_t deadline_ns;
+    faeb_deadline_heap_t* heap;    // Heap holding it, NULL when in neither
+    size_t heap_index;
+    uint64_t heap_key;
+
+    // Stackful execution: the process's own context and the context of
+    // whoever resumed it, which yield switches back to
+    faeb_context_t machine;
+    faeb_context_t caller;
+    char* stack;          // Mapping base; the lowest page is a guard page
+    size_t stack_size;    // Mapping size including the guard page
+    bool on_workers;      // Submitted to the worker pool and not finished
+    bool detached;        // Destroyed by the scheduler when it finishes
+
+    // Sleeps and timed blocks
+    faeb_timer_t timer;
+
+    // Statistics, written only by the thread running or queueing the
+    // process; ready_ns is when it last became ready to run
+    uint64_t ready_ns;
+    _Atomic uint64_t runtime_ns;
+    _Atomic uint64_t runs;
+    _Atomic uint64_t switches;
+    _Atomic uint64_t blocks;
+    _Atomic uint64_t delays[FAEB_SCHEDULER_DELAY_BUCKETS];
+    _Atomic uint64_t periods;
+    _Atomic uint64_t deadline_misses;
+
+    // Wait queue the process is blocked on, and the lock guarding it
+    faeb_wait_queue_t* wait_queue;
+    pthread_mutex_t* wait_lock;
+
+    // Descriptor readiness awaited and the reactor entry awaiting it; the
+    // tick scheduler's blocked processes link on it through fd_next
+    struct faeb_reactor_fd* fd_entry;
+    struct faeb_process* fd_next;
+    struct faeb_process* fd_prev;
+    uint32_t fd_events;
+
+    // I/O engine request the process is parked on; it and its buffer may
+    // be on the process's stack
+    struct io_request* io_request;
+};
+
+// Wake a process whose sleep or timed block expired
+void faeb_process_timer_fire(faeb_timer_wheel_t* wheel, faeb_timer_t* timer);
+
+// Run a process on the calling thread until it yields, blocks or
+// finishes; returns the state it stopped in
+faeb_process_state_t faeb_process_resume(struct faeb_process* process);
+
+// Process running on the calling thread, NULL outside of processes
+struct faeb_process* faeb_process_self(void);
+
+// Block the running process on queue. The caller holds lock, which is
+// released only once the process is off its stack, so a waker on another
+// thread cannot resume it early.
+void faeb_process_park(faeb_wait_queue_t* queue, pthread_mutex_t* lock);
+
+// Free a process the I/O engine kept after faeb_process_destroy, from
+// any thread
+void faeb_process_release(struct faeb_process* process);
+
+// Make a parked process runnable again on the scheduler it belongs to.
+// The caller holds the lock of the queue it was taken from.
+void faeb_process_wake(struct faeb_process* process);
+
+// Scheduling statistics. A process is charged from when it is switched
+// in at start until it is switched out at end, in whatever state it has
+// by then; each thread adds the same events to its own totals for the
+// process's scheduler.
+void faeb_process_account_run(struct faeb_process* process, uint64_t start);
+void faeb_process_account_stop(struct faeb_process* process, uint64_t start, uint64_t end);
+
+// Restart the calling thread's switch clock after it has been idle
+void faeb_process_clock_sync(void);
+
+// Add every thread's totals for scheduler to stats
+void faeb_process_accumulate_stats(const faeb_scheduler_t* scheduler,
+                                   faeb_scheduler_stats_t* stats);
+
+// Hand a destroyed scheduler's totals blocks back for reuse
+void faeb_process_release_stats(const faeb_scheduler_t* scheduler);
+
+// Single-writer counters: a relaxed load and store, no locked instruction
+static inline void stat_add(_Atomic uint64_t* counter, uint64_t value) {
+    atomic_store_explicit(counter,
+                          atomic_load_explicit(counter, memory_order_relaxed) + value,
+                          memory_order_relaxed);
+}
+
+// Timer wheel callback of every scheduler instance: back to its queue
+void faeb_scheduler_timer_ready(struct faeb_process* process);
+
+void faeb_deadline_heap_push(faeb_deadline_heap_t* heap, struct faeb_process* process,
+                             uint64_t key);
+struct faeb_process* faeb_deadline_heap_pop(faeb_deadline_heap_t* heap);
+void faeb_deadline_heap_remove(struct faeb_process* process);
+
+// Move deadline processes whose next job is released by now to the
+// ready heap
+void faeb_scheduler_release(faeb_scheduler_t* scheduler, uint64_t now);
+
+// Admit deadline parameters for process on its scheduler, replacing any
+// it had; period 0 withdraws them. FAEB_ERROR_LIMIT when the admitted
+// density would exceed the bound.
+faeb_result_t faeb_scheduler_admit(struct faeb_process* process, uint64_t runtime_ns,
+                                   uint64_t deadline_ns, uint64_t period_ns);
+
+// Requeue a woken process on the worker pool
+void faeb_scheduler_wake_worker(struct faeb_process* process);
+
+// Worker placement. Check cpus, or take the default placement order when
+// cpus is NULL, into out; returns how many CPUs there are, 0 when one is
+// not online. Set the affinity new threads start with.
+size_t faeb_topology_placement(const int* cpus, size_t count, int* out, size_t max);
+faeb_result_t faeb_topology_attr_set(pthread_attr_t* attr, const int* cpus, size_t count);
+
+// Whether the calling thread is one of the scheduler's workers
+bool faeb_scheduler_on_worker(void);
+
+// Scheduler whose loop is running on the calling thread, NULL outside
+// faeb_scheduler_run
+faeb_scheduler_t* faeb_scheduler_running(void);
+
+// The scheduler's I/O engine, created on first use; NULL when it cannot
+// be created
+faeb_io_engine_t* faeb_scheduler_io_engine(faeb_scheduler_t* scheduler);
+
+// I/O engine of one scheduler. Only the thread running that scheduler
+// polls and waits on it: poll reaps completions and submits queued
+// requests when tick has moved on; wait submits and sleeps until one
+// completes or until_ns. Read and write park the running process in a
+// loop or on a worker and block anywhere else, returning like read(2)
+// and write(2).
+faeb_io_engine_t* faeb_io_engine_create(faeb_io_backend_t backend);
+void faeb_io_engine_destroy(faeb_io_engine_t* engine);
+faeb_io_backend_t faeb_io_engine_backend(faeb_io_engine_t* engine);
+size_t faeb_io_engine_pending(faeb_io_engine_t* engine);
+void faeb_io_engine_stats(faeb_io_engine_t* engine, faeb_scheduler_stats_t* stats);
+void faeb_io_engine_poll(faeb_io_engine_t* engine, uint64_t tick);
+void faeb_io_engine_wait(faeb_io_engine_t* engine, uint64_t until_ns);
+ssize_t faeb_io_engine_read(int fd, void* buffer, size_t size, int64_t offset);
+ssize_t faeb_io_engine_write(int fd, const void* buffer, size_t size, int64_t offset);
+
+// Before the loop sleeps on the engine's descriptor: submit what is
+// queued and clear stale wakeups; returns the descriptor
+int faeb_io_engine_prepare(faeb_io_engine_t* engine);
+
+// A process parked on a request is being destroyed; true when the
+// engine keeps it until the request completes, see faeb_process_release
+bool faeb_io_engine_forget(struct faeb_process* process);
+
+// The scheduler's reactor, created on first use; NULL when it cannot be
+// created
+faeb_reactor_t* faeb_scheduler_reactor(faeb_scheduler_t* scheduler);
+
+// Readiness reactor of one scheduler, used only by the thread running
+// it. Poll dispatches edges without blocking once per tick; wait blocks
+// until an edge, until_ns, or an I/O completion while io has requests
+// pending. Block is faeb_scheduler_block_current_fd; forget drops a
+// waiting process that leaves some other way.
+faeb_reactor_t* faeb_reactor_create(void);
+void faeb_reactor_destroy(faeb_reactor_t* reactor);
+size_t faeb_reactor_waiting(faeb_reactor_t* reactor);
+void faeb_reactor_stats(faeb_reactor_t* reactor, faeb_scheduler_stats_t* stats);
+void faeb_reactor_poll(faeb_reactor_t* reactor, uint64_t tick);
+void faeb_reactor_wait(faeb_reactor_t* reactor, faeb_io_engine_t* io, uint64_t until_ns);
+faeb_result_t faeb_reactor_block(faeb_reactor_t* reactor, int fd, uint32_t events);
+void faeb_reactor_forget(struct faeb_process* process);
+
+static inline void runqueue_link(faeb_runqueue_t* runqueue,
+                                 struct faeb_process* process, int level) {
+    process->runqueue = runqueue;
+    process->level = level;
+    process->enqueued_pick = runqueue->picks;
+    process->next = NULL;
+    process->prev = runqueue->tails[level];
+    if (process->prev) {
+        process->prev->next = process;
+    } else {
+        runqueue->heads[level] = process;
+        runqueue->ready_mask |= 1u << level;
+    }
+    runqueue->tails[level] = process;
+    runqueue->count++;
+}
+
+// Remove a process from whichever level it is queued on
+static inline void runqueue_remove(faeb_runqueue_t* runqueue,
+                                   struct faeb_process* process) {
+    if (process->runqueue != runqueue) return;
+    
+    int level = process->level;
+    if (process->prev) {
+        process->prev->next = process->next;
+    } else {
+        runqueue->heads[level] = process->next;
+    }
+    if (process->next) {
+        process->next->prev = process->prev;
+    } else {
+        runqueue->tails[level] = process->prev;
+    }
+    if (!runqueue->heads[level]) {
+        runqueue->ready_mask &= ~(1u << level);
+    }
+    process->next = NULL;
+    process->prev = NULL;
+    process->runqueue = NULL;
+    runqueue->count--;
+}
+
+// Queue a process at the tail of its own priority level
+static inline void runqueue_push(faeb_runqueue_t* runqueue,
+                                 struct faeb_process* process) {
+    runqueue_link(runqueue, process, process->priority);
+}
+
+// Take the head of the highest ready level. Before picking, the oldest
+// process of the lowest ready level moves up one level once it has
+// waited FAEB_RUNQUEUE_AGING_PICKS picks.
+static inline struct faeb_process* runqueue_pop(faeb_runqueue_t* runqueue) {
+    if (!runqueue->ready_mask) return NULL;
+    
+    runqueue->picks++;
+    int high = 31 - __builtin_clz(runqueue->ready_mask);
+    int low = __builtin_ctz(runqueue->ready_mask);
+    if (low < high) {
+        struct faeb_process* oldest = runqueue->heads[low];
+        if (runqueue->picks - oldest->enqueued_pick >= FAEB_RUNQUEUE_AGING_PICKS) {
+            runqueue_remove(runqueue, oldest);
+            runqueue_link(runqueue, oldest, low + 1);
+        }
+    }
+    
+    struct faeb_process* process = runqueue->heads[high];
+    runqueue_remove(runqueue, process);
+    return process;
+}
+
+static inline void wait_queue_push(faeb_wait_queue_t* queue,
+                                   struct faeb_process* process) {
+    process->wait_queue = queue;
+    process->next = NULL;
+    process->prev = queue->tail;
+    if (queue->tail) {
+        queue->tail->next = process;
+    } else {
+        queue->head = process;
+    }
+    queue->tail = process;
+    queue->count++;
+}
+
+static inline void wait_queue_remove(faeb_wait_queue_t* queue,
+                                     struct faeb_process* process) {
+    if (process->wait_queue != queue) return;
+    
+    if (process->prev) {
+        process->prev->next = process->next;
+    } else {
+        queue->head = process->next;
+    }
+    if (process->next) {
+        process->next->prev = process->prev;
+    } else {
+        queue->tail = process->prev;
+    }
+    process->next = NULL;
+    process->prev = NULL;
+    process->wait_queue = NULL;
+    queue->count--;
+}
+
+// Take the longest-waiting process, NULL when nobody waits
+static inline struct faeb_process* wait_queue_pop(faeb_wait_queue_t* queue) {
+    struct faeb_process* process = queue->head;
+    if (process) {
+        wait_queue_remove(queue, process);
+    }
+    return process;
+}
+
+// Ready a process on its scheduler: the deadline heap when it has
+// deadline parameters, its priority level otherwise
+static inline void scheduler_enqueue(faeb_scheduler_t* scheduler,
+                                     struct faeb_process* process) {
+    if (process->period_ns) {
+        faeb_deadline_heap_push(&scheduler->deadlines, process, process->deadline_ns);
+    } else {
+        runqueue_push(&scheduler->ready_queue, process);
+    }
+}
+
+// Earliest deadline first, then the highest priority
+static inline struct faeb_process* scheduler_dequeue(faeb_scheduler_t* scheduler) {
+    if (scheduler->deadlines.count) {
+        return faeb_deadline_heap_pop(&scheduler->deadlines);
+    }
+    return runqueue_pop(&scheduler->ready_queue);
+}
+
+// Take a process out of whichever ready set or release heap holds it
+static inline void scheduler_unqueue(struct faeb_process* process) {
+    if (process->heap) {
+        faeb_deadline_heap_remove(process);
+    } else if (process->runqueue) {
+        runqueue_remove(process->runqueue, process);
+    }
+}
+
+#endif // FAEB_INTERNAL_H
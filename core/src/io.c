@@ -3,19 +3,28 @@
  * License: Apache 2.0
  */
 
-#include "faeb/runtime.h"
+#include "internal.h"
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
 
+// Reads are served from a buffer refilled with one read() at a time;
+// writes collect in a buffer that goes out with one write() when it
+// fills, at a newline in line mode, or on flush. Requests at least as
+// large as the buffer bypass it. The syscalls go through the I/O
+// engine, so a process waiting on one parks instead of stalling its
+// scheduler.
+
 // I/O buffer structure
 struct faeb_io_buffer {
     char* data;
     size_t size;
-    size_t position;
+    size_t position;     // Output: bytes pending; input: next byte to hand out
+    size_t length;       // Input: bytes read into data
     int fd;
+    faeb_io_mode_t mode;
     bool is_open;
 };
 
@@ -27,48 +36,97 @@ struct faeb_io {
     faeb_result_t last_error;
 };
 
-// Create I/O manager
+static struct faeb_io_buffer* buffer_create(int fd, size_t size, faeb_io_mode_t mode) {
+    struct faeb_io_buffer* buf = malloc(sizeof(struct faeb_io_buffer));
+    if (!buf) return NULL;
+    
+    buf->data = NULL;
+    buf->size = mode == FAEB_IO_UNBUFFERED ? 0 : size;
+    buf->position = 0;
+    buf->length = 0;
+    buf->fd = fd;
+    buf->mode = mode;
+    buf->is_open = true;
+    if (buf->size) {
+        buf->data = malloc(buf->size);
+        if (!buf->data) {
+            free(buf);
+            return NULL;
+        }
+    }
+    return buf;
+}
+
+// Write all of data, retrying short writes and interruptions
+static faeb_result_t write_all(int fd, const char* data, size_t size, size_t* written) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = faeb_io_engine_write(fd, data + done, size - done, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        done += (size_t)n;
+    }
+    if (written) {
+        *written = done;
+    }
+    return done == size ? FAEB_SUCCESS : FAEB_ERROR_IO;
+}
+
+// Write out pending output. What could not be written stays buffered.
+static faeb_result_t buffer_drain(struct faeb_io_buffer* buf) {
+    if (buf->position == 0) return FAEB_SUCCESS;
+    
+    size_t written;
+    faeb_result_t result = write_all(buf->fd, buf->data, buf->position, &written);
+    buf->position -= written;
+    if (buf->position) {
+        memmove(buf->data, buf->data + written, buf->position);
+    }
+    return result;
+}
+
+// Create I/O manager on the standard descriptors
 faeb_io_t* faeb_io_create(void) {
+    return faeb_io_create_config(NULL);
+}
+
+faeb_io_t* faeb_io_create_config(const faeb_io_config_t* config) {
+    return faeb_io_open(STDIN_FILENO, STDOUT_FILENO, config);
+}
+
+// Create I/O manager reading input_fd and writing output_fd. Errors
+// still go to stderr, unbuffered. The descriptors stay the caller's.
+faeb_io_t* faeb_io_open(int input_fd, int output_fd, const faeb_io_config_t* config) {
+    if (input_fd < 0 || output_fd < 0) return NULL;
+    
+    size_t size = config && config->buffer_size ? config->buffer_size : FAEB_IO_BUFFER_SIZE;
+    faeb_io_mode_t mode = config ? config->mode : FAEB_IO_AUTO;
+    if (mode == FAEB_IO_AUTO) {
+        mode = isatty(output_fd) ? FAEB_IO_LINE : FAEB_IO_FULL;
+    }
+    
     faeb_io_t* io = malloc(sizeof(faeb_io_t));
     if (!io) return NULL;
     
-    // Initialize buffers
-    io->stdin_buf = malloc(sizeof(struct faeb_io_buffer));
-    io->stdout_buf = malloc(sizeof(struct faeb_io_buffer));
-    io->stderr_buf = malloc(sizeof(struct faeb_io_buffer));
+    // Input is unbuffered only on request
+    io->stdin_buf = buffer_create(input_fd, size,
+                                  mode == FAEB_IO_UNBUFFERED ? FAEB_IO_UNBUFFERED : FAEB_IO_FULL);
+    io->stdout_buf = buffer_create(output_fd, size, mode);
+    io->stderr_buf = buffer_create(STDERR_FILENO, 0, FAEB_IO_UNBUFFERED);
     
     if (!io->stdin_buf || !io->stdout_buf || !io->stderr_buf) {
         faeb_io_destroy(io);
         return NULL;
     }
     
-    // Initialize stdin buffer
-    io->stdin_buf->data = NULL;
-    io->stdin_buf->size = 0;
-    io->stdin_buf->position = 0;
-    io->stdin_buf->fd = STDIN_FILENO;
-    io->stdin_buf->is_open = true;
-    
-    // Initialize stdout buffer
-    io->stdout_buf->data = NULL;
-    io->stdout_buf->size = 0;
-    io->stdout_buf->position = 0;
-    io->stdout_buf->fd = STDOUT_FILENO;
-    io->stdout_buf->is_open = true;
-    
-    // Initialize stderr buffer
-    io->stderr_buf->data = NULL;
-    io->stderr_buf->size = 0;
-    io->stderr_buf->position = 0;
-    io->stderr_buf->fd = STDERR_FILENO;
-    io->stderr_buf->is_open = true;
-    
     io->last_error = FAEB_SUCCESS;
     
     return io;
 }
 
-// Destroy I/O manager
+// Destroy I/O manager, writing out anything still buffered
 void faeb_io_destroy(faeb_io_t* io) {
     if (!io) return;
     
@@ -79,6 +137,7 @@ void faeb_io_destroy(faeb_io_t* io) {
     }
     
     if (io->stdout_buf) {
+        if (io->stdout_buf->is_open) buffer_drain(io->stdout_buf);
         if (io->stdout_buf->data) free(io->stdout_buf->data);
         free(io->stdout_buf);
     }
@@ -91,7 +150,8 @@ void faeb_io_destroy(faeb_io_t* io) {
     free(io);
 }
 
-// Read from I/O buffer
+// Read up to size bytes, as read() does: short counts are normal and 0
+// with FAEB_SUCCESS means end of input
 size_t faeb_io_read(faeb_io_t* io, void* buffer, size_t size) {
     if (!io || !buffer || size == 0) {
         if (io) io->last_error = FAEB_ERROR_INVALID;
@@ -105,8 +165,44 @@ size_t faeb_io_read(faeb_io_t* io, void* buffer, size_t size) {
         return 0;
     }
     
-    // Read from file descriptor
-    ssize_t bytes_read = read(buf->fd, buffer, size);
+    // A prompt written in line mode shows before we wait for the answer
+    if (io->stdout_buf->mode == FAEB_IO_LINE && buffer_drain(io->stdout_buf) != FAEB_SUCCESS) {
+        io->last_error = FAEB_ERROR_IO;
+        return 0;
+    }
+    
+    // Hand out what is buffered before reading more
+    size_t buffered = buf->length - buf->position;
+    if (buffered == 0 && size < buf->size) {
+        ssize_t bytes_read;
+        do {
+            bytes_read = faeb_io_engine_read(buf->fd, buf->data, buf->size, -1);
+        } while (bytes_read < 0 && errno == EINTR);
+        if (bytes_read < 0) {
+            io->last_error = FAEB_ERROR_IO;
+            return 0;
+        }
+        buf->position = 0;
+        buf->length = (size_t)bytes_read;
+        buffered = buf->length;
+        if (buffered == 0) {
+            io->last_error = FAEB_SUCCESS;
+            return 0;
+        }
+    }
+    if (buffered > 0) {
+        size_t count = size < buffered ? size : buffered;
+        memcpy(buffer, buf->data + buf->position, count);
+        buf->position += count;
+        io->last_error = FAEB_SUCCESS;
+        return count;
+    }
+    
+    // Large reads go straight into the caller's memory
+    ssize_t bytes_read;
+    do {
+        bytes_read = faeb_io_engine_read(buf->fd, buffer, size, -1);
+    } while (bytes_read < 0 && errno == EINTR);
     if (bytes_read < 0) {
         io->last_error = FAEB_ERROR_IO;
         return 0;
@@ -116,7 +212,8 @@ size_t faeb_io_read(faeb_io_t* io, void* buffer, size_t size) {
     return (size_t)bytes_read;
 }
 
-// Write to I/O buffer
+// Write size bytes. They are all accepted, into the buffer or out to
+// the descriptor, unless writing fails, which returns 0.
 size_t faeb_io_write(faeb_io_t* io, const void* buffer, size_t size) {
     if (!io || !buffer || size == 0) {
         if (io) io->last_error = FAEB_ERROR_INVALID;
@@ -130,24 +227,35 @@ size_t faeb_io_write(faeb_io_t* io, const void* buffer, size_t size) {
         return 0;
     }
     
-    // Write to file descriptor
-    ssize_t bytes_written = write(buf->fd, buffer, size);
-    if (bytes_written < 0) {
-        io->last_error = FAEB_ERROR_IO;
-        return 0;
+    const char* data = buffer;
+    faeb_result_t result = FAEB_SUCCESS;
+    if (size > buf->size - buf->position) {
+        result = buffer_drain(buf);
+    }
+    if (result == FAEB_SUCCESS) {
+        if (size >= buf->size) {
+            // Too big to be worth copying
+            result = write_all(buf->fd, data, size, NULL);
+        } else {
+            memcpy(buf->data + buf->position, data, size);
+            buf->position += size;
+            if (buf->mode == FAEB_IO_LINE && memchr(data, '\n', size)) {
+                result = buffer_drain(buf);
+            }
+        }
     }
     
-    io->last_error = FAEB_SUCCESS;
-    return (size_t)bytes_written;
+    io->last_error = result;
+    return result == FAEB_SUCCESS ? size : 0;
 }
 
-// Flush I/O buffers
+// Write out all buffered output
 faeb_result_t faeb_io_flush(faeb_io_t* io) {
     if (!io) return FAEB_ERROR_INVALID;
     
     // Flush stdout
     if (io->stdout_buf && io->stdout_buf->is_open) {
-        if (fflush(stdout) != 0) {
+        if (buffer_drain(io->stdout_buf) != FAEB_SUCCESS) {
             io->last_error = FAEB_ERROR_IO;
             return FAEB_ERROR_IO;
         }
@@ -155,7 +263,7 @@ faeb_result_t faeb_io_flush(faeb_io_t* io) {
     
     // Flush stderr
     if (io->stderr_buf && io->stderr_buf->is_open) {
-        if (fflush(stderr) != 0) {
+        if (buffer_drain(io->stderr_buf) != FAEB_SUCCESS) {
             io->last_error = FAEB_ERROR_IO;
             return FAEB_ERROR_IO;
         }
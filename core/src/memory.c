@@ -3,118 +3,2044 @@
  * License: Apache 2.0
  */
 
+#define _DEFAULT_SOURCE
+
 #include "faeb/runtime.h"
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#if defined(__GLIBC__)
+#include <execinfo.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
 
-// Memory block structure for tracking allocations
+// Memory block header, stored in-band immediately before each payload.
+// Only read once the block index has vouched for the address.
 struct faeb_memory_block {
-    void* ptr;
-    size_t size;
+    struct faeb_memory_block* prev;
     struct faeb_memory_block* next;
+    size_t size;
+    size_t alignment;   // Requested, at least FAEB_MEMORY_ALIGN
+};
+
+// Open-addressed set of live heap block addresses, so faeb_memory_free
+// can reject foreign and stale pointers without reading their memory.
+// Guarded by the manager lock.
+struct faeb_memory_index {
+    uintptr_t* slots;
+    size_t capacity;    // Power of two, 0 until the first block
+    size_t live;
+    size_t used;        // Live plus deleted slots
+};
+
+// Offset and size of every arena allocation in address order, so one
+// that is not the tail can be resized knowing where it ends. Guarded by
+// the manager lock.
+struct faeb_memory_extent {
+    size_t offset;
+    size_t size;
+};
+
+struct faeb_memory_extents {
+    struct faeb_memory_extent* items;
+    size_t count;
+    size_t capacity;
+};
+
+#define FAEB_MEMORY_ALIGN _Alignof(max_align_t)
+#define FAEB_MEMORY_HEADER_SIZE \
+    ((sizeof(struct faeb_memory_block) + FAEB_MEMORY_ALIGN - 1) & \
+     ~(FAEB_MEMORY_ALIGN - 1))
+#define FAEB_INDEX_EMPTY ((uintptr_t)0)
+#define FAEB_INDEX_DELETED ((uintptr_t)1)
+#define FAEB_INDEX_MIN_CAPACITY 64
+
+// Slab engine geometry: page-sized slabs, one cache line of header, then
+// objects. Classes up to a cache line are powers of two so no object
+// straddles a line; larger classes are whole lines and start line-aligned.
+#define FAEB_SLAB_SIZE 4096
+#define FAEB_SLAB_HEADER_SIZE FAEB_CACHE_LINE_SIZE
+#define FAEB_SLAB_MAX_OBJECT 512
+#define FAEB_SLAB_BITMAP_WORDS 4
+
+// Slab page map: three radix levels over page numbers, enough for a
+// 48-bit address space
+#define FAEB_PAGEMAP_BITS 12
+#define FAEB_PAGEMAP_FANOUT ((size_t)1 << FAEB_PAGEMAP_BITS)
+
+// Per-thread magazines: each thread owns one slot in every manager's
+// cache table and moves objects to and from slabs in half-magazine runs.
+#define FAEB_MEMORY_MAX_THREADS 64
+#define FAEB_MAGAZINE_SIZE 64
+
+// Nodes a mapped region can be bound to
+#define FAEB_MEMORY_MAX_NODES 1024
+
+// Huge page granularity used for explicit and transparent huge pages
+#define FAEB_HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+// Sampled allocation-site profiler ring
+#define FAEB_MEMORY_PROFILE_SAMPLES 1024
+
+static const size_t slab_class_sizes[FAEB_MEMORY_SLAB_CLASSES] = {
+    16, 32, 64, 128, 192, 256, 384, 512
+};
+
+// Class index by 16-byte granule: (size + 15) / 16
+static const uint8_t slab_class_index[FAEB_SLAB_MAX_OBJECT / 16 + 1] = {
+    0, 0, 1, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5,
+    6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7
+};
+
+// Slab header, stored at the start of each page-aligned slab. Objects
+// are carved lazily from bump and recycled through free_list. The
+// allocated bits track objects held by callers, wherever the free ones
+// sit, so a double free is caught even while the object is cached.
+struct faeb_memory_slab {
+    struct faeb_memory_slab* prev;
+    struct faeb_memory_slab* next;
+    void* free_list;
+    uint16_t bump;      // Objects carved so far
+    uint16_t in_use;
+    uint16_t capacity;
+    uint16_t class_index;
+    _Atomic uint64_t allocated[FAEB_SLAB_BITMAP_WORDS];
+};
+
+_Static_assert(sizeof(struct faeb_memory_slab) <= FAEB_SLAB_HEADER_SIZE,
+               "slab header must fit in one cache line");
+_Static_assert((FAEB_SLAB_SIZE - FAEB_SLAB_HEADER_SIZE) / 16 <=
+               64 * FAEB_SLAB_BITMAP_WORDS,
+               "allocated bits must cover the smallest class");
+
+// Page map leaves hold one bit per page; inner nodes are kept until the
+// manager is destroyed, so lookups walk the map without the lock
+struct faeb_memory_pagemap_leaf {
+    _Atomic uint64_t pages[FAEB_PAGEMAP_FANOUT / 64];
+};
+
+struct faeb_memory_pagemap_node {
+    _Atomic(struct faeb_memory_pagemap_leaf*) leaves[FAEB_PAGEMAP_FANOUT];
+};
+
+struct faeb_memory_pagemap {
+    _Atomic(struct faeb_memory_pagemap_node*) nodes[FAEB_PAGEMAP_FANOUT];
+};
+
+// Per size class slab lists
+struct faeb_memory_class {
+    struct faeb_memory_slab* partial;  // Slabs with at least one free object
+    struct faeb_memory_slab* full;     // Slabs with no free objects
+    size_t slabs;
+    size_t in_use;
+};
+
+// Per-thread cache of free slab objects
+struct faeb_memory_magazine {
+    uint32_t count;
+    void* objects[FAEB_MAGAZINE_SIZE];
+};
+
+// Telemetry counters. Each thread bumps its own copy with relaxed atomics
+// so the hot path never shares a cache line; readers sum all copies.
+struct faeb_memory_counters {
+    bool shared;  // Bumped by several threads, needs read-modify-write
+    _Atomic uint64_t allocations;
+    _Atomic uint64_t frees;
+    _Atomic uint64_t reallocations;
+    _Atomic uint64_t limit_hits;
+    _Atomic uint64_t histogram[FAEB_MEMORY_HISTOGRAM_BUCKETS];
+};
+
+struct faeb_memory_tcache {
+    struct faeb_memory_magazine magazines[FAEB_MEMORY_SLAB_CLASSES];
+    struct faeb_memory_counters counters;
+};
+
+// Allocation-site profiler state
+struct faeb_memory_profile {
+    _Atomic uint32_t sample_rate;   // 1-in-N allocations, 0 when stopped
+    size_t next;                    // Ring write position
+    size_t recorded;                // Samples taken since start
+    faeb_memory_sample_t* samples;
 };
 
-// Memory manager structure
+// Memory manager structure. The lock guards block and slab lists and the
+// arena cursor; the budget is maintained atomically outside it.
 struct faeb_memory {
+    faeb_memory_kind_t kind;
+    uint32_t flags;
     size_t total_size;
-    size_t used_size;
+    _Atomic size_t used_size;
+    pthread_mutex_t lock;
     struct faeb_memory_block* blocks;
-    faeb_result_t last_error;
+    struct faeb_memory_index index;
+    char* region;       // Arena region, or slab page pool when mapped
+    size_t region_size; // Mapped length, 0 when the region came from malloc
+    size_t page_size;   // Page size backing the region
+    int numa_node;      // Node the mapped region is bound to, -1 if none
+    size_t arena_last;  // Offset of the most recent arena allocation
+    struct faeb_memory_extents arena_blocks;
+    size_t arena_high;  // Arena high-water mark, for trimming
+    size_t slab_cursor; // Next never-used slab page in the region
+    uint32_t* free_pages;      // Region slab pages returned by their slabs
+    size_t free_page_count;
+    _Atomic(struct faeb_memory_pagemap*) slab_pages; // Live slab pages
+    struct faeb_memory_class classes[FAEB_MEMORY_SLAB_CLASSES];
+    _Atomic(struct faeb_memory_tcache*) tcaches[FAEB_MEMORY_MAX_THREADS];
+    struct faeb_memory_counters shared_counters; // Threads without a slot
+    _Atomic size_t peak_size;
+    uint64_t created_ns;
+    struct faeb_memory_profile profile;
 };
 
-// Create memory manager with specified size
-faeb_memory_t* faeb_memory_create(size_t size) {
+// Last error is per thread, like errno
+static _Thread_local faeb_result_t memory_last_error = FAEB_SUCCESS;
+
+// Allocations left until this thread takes the next profile sample
+static _Thread_local uint32_t profile_countdown = 0;
+
+// Thread slot registry shared by all managers
+static _Atomic uint64_t thread_slots_used = 0;
+static _Thread_local int thread_slot = -1;  // -1 unclaimed, -2 none left
+static pthread_key_t thread_slot_key;
+static pthread_once_t thread_slot_once = PTHREAD_ONCE_INIT;
+
+static inline void* block_payload(struct faeb_memory_block* block) {
+    return (char*)block + FAEB_MEMORY_HEADER_SIZE;
+}
+
+// Header address for a payload, computed without touching memory
+static inline uintptr_t payload_block(const void* ptr) {
+    return (uintptr_t)ptr - FAEB_MEMORY_HEADER_SIZE;
+}
+
+static inline size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Start of the libc allocation holding block: over-aligned blocks sit
+// behind a prefix padded to their alignment
+static inline void* block_base(struct faeb_memory_block* block) {
+    if (block->alignment <= FAEB_MEMORY_ALIGN) return block;
+    return (char*)block - (align_up(FAEB_MEMORY_HEADER_SIZE, block->alignment) -
+                           FAEB_MEMORY_HEADER_SIZE);
+}
+
+static inline char* slab_objects(struct faeb_memory_slab* slab) {
+    return (char*)slab + FAEB_SLAB_HEADER_SIZE;
+}
+
+static inline struct faeb_memory_slab* slab_of(void* ptr) {
+    return (struct faeb_memory_slab*)((uintptr_t)ptr &
+                                      ~(uintptr_t)(FAEB_SLAB_SIZE - 1));
+}
+
+static inline size_t index_slot(uintptr_t key, size_t capacity) {
+    return (size_t)(((uint64_t)(key >> 4) * 0x9e3779b97f4a7c15ULL) >>
+                    (64 - __builtin_ctzll((unsigned long long)capacity)));
+}
+
+// Add a key known to be absent, reusing the first deleted slot on its
+// probe path. Capacity must have been reserved.
+static void index_insert(struct faeb_memory_index* index, uintptr_t key) {
+    size_t mask = index->capacity - 1;
+    size_t i = index_slot(key, index->capacity);
+    while (index->slots[i] > FAEB_INDEX_DELETED) {
+        i = (i + 1) & mask;
+    }
+    if (index->slots[i] == FAEB_INDEX_EMPTY) {
+        index->used++;
+    }
+    index->slots[i] = key;
+    index->live++;
+}
+
+// Make room for count more keys, rehashing once live and deleted slots
+// would pass half the table
+static bool index_reserve(struct faeb_memory_index* index, size_t count) {
+    if (count > SIZE_MAX / 8 - index->live) {
+        return false;
+    }
+    if ((index->used + count) * 2 <= index->capacity) {
+        return true;
+    }
+    
+    size_t capacity = FAEB_INDEX_MIN_CAPACITY;
+    while (capacity < (index->live + count) * 4) {
+        capacity *= 2;
+    }
+    uintptr_t* slots = calloc(capacity, sizeof(uintptr_t));
+    if (!slots) {
+        return false;
+    }
+    
+    struct faeb_memory_index grown = { slots, capacity, 0, 0 };
+    for (size_t i = 0; i < index->capacity; i++) {
+        if (index->slots[i] > FAEB_INDEX_DELETED) {
+            index_insert(&grown, index->slots[i]);
+        }
+    }
+    free(index->slots);
+    *index = grown;
+    return true;
+}
+
+static bool index_remove(struct faeb_memory_index* index, uintptr_t key) {
+    if (index->capacity == 0) {
+        return false;
+    }
+    size_t mask = index->capacity - 1;
+    for (size_t i = index_slot(key, index->capacity);; i = (i + 1) & mask) {
+        if (index->slots[i] == key) {
+            index->slots[i] = FAEB_INDEX_DELETED;
+            index->live--;
+            return true;
+        }
+        if (index->slots[i] == FAEB_INDEX_EMPTY) {
+            return false;
+        }
+    }
+}
+
+static bool index_contains(const struct faeb_memory_index* index,
+                           uintptr_t key) {
+    if (index->capacity == 0) {
+        return false;
+    }
+    size_t mask = index->capacity - 1;
+    for (size_t i = index_slot(key, index->capacity);; i = (i + 1) & mask) {
+        if (index->slots[i] == key) {
+            return true;
+        }
+        if (index->slots[i] == FAEB_INDEX_EMPTY) {
+            return false;
+        }
+    }
+}
+
+static void index_clear(struct faeb_memory_index* index) {
+    free(index->slots);
+    memset(index, 0, sizeof(*index));
+}
+
+// Raise the high-water mark if used exceeds it
+static void peak_update(faeb_memory_t* memory, size_t used) {
+    size_t peak = atomic_load_explicit(&memory->peak_size,
+                                       memory_order_relaxed);
+    while (used > peak &&
+           !atomic_compare_exchange_weak_explicit(&memory->peak_size, &peak,
+                                                  used, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+// Reserve bytes against the budget without taking the lock
+static bool budget_reserve(faeb_memory_t* memory, size_t size) {
+    size_t used = atomic_load_explicit(&memory->used_size,
+                                       memory_order_relaxed);
+    do {
+        if (size > memory->total_size - used) {
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&memory->used_size,
+                                                    &used, used + size,
+                                                    memory_order_relaxed,
+                                                    memory_order_relaxed));
+    peak_update(memory, used + size);
+    return true;
+}
+
+static void budget_release(faeb_memory_t* memory, size_t size) {
+    atomic_fetch_sub_explicit(&memory->used_size, size, memory_order_relaxed);
+}
+
+// Give the slot back when its thread exits; a later thread inherits the
+// cached objects along with the slot
+static void thread_slot_release(void* value) {
+    int slot = (int)((uintptr_t)value - 1);
+    atomic_fetch_and(&thread_slots_used, ~((uint64_t)1 << slot));
+}
+
+static void thread_slot_key_create(void) {
+    pthread_key_create(&thread_slot_key, thread_slot_release);
+}
+
+static int thread_slot_claim(void) {
+    if (thread_slot != -1) {
+        return thread_slot;
+    }
+    
+    pthread_once(&thread_slot_once, thread_slot_key_create);
+    uint64_t used = atomic_load(&thread_slots_used);
+    for (;;) {
+        if (used == UINT64_MAX) {
+            thread_slot = -2; // Fall back to the locked path
+            return thread_slot;
+        }
+        int slot = __builtin_ctzll(~used);
+        if (atomic_compare_exchange_weak(&thread_slots_used, &used,
+                                         used | ((uint64_t)1 << slot))) {
+            thread_slot = slot;
+            pthread_setspecific(thread_slot_key, (void*)(uintptr_t)(slot + 1));
+            return slot;
+        }
+    }
+}
+
+// Get the calling thread's cache in this manager, creating it on first use
+static struct faeb_memory_tcache* thread_cache(faeb_memory_t* memory) {
+    int slot = thread_slot_claim();
+    if (slot < 0) {
+        return NULL;
+    }
+    
+    struct faeb_memory_tcache* cache =
+        atomic_load_explicit(&memory->tcaches[slot], memory_order_relaxed);
+    if (!cache) {
+        // Only the slot owner writes here; release publishes the zeroed
+        // counters to telemetry readers
+        cache = calloc(1, sizeof(struct faeb_memory_tcache));
+        atomic_store_explicit(&memory->tcaches[slot], cache,
+                              memory_order_release);
+    }
+    return cache;
+}
+
+// Map an anonymous region, preferring explicit huge pages, then
+// transparent huge pages, then base pages
+static char* region_map(size_t size, uint32_t flags, size_t* mapped_size,
+                        size_t* page_size) {
+    const int prot = PROT_READ | PROT_WRITE;
+    const int map = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+    size_t base_page = (size_t)sysconf(_SC_PAGESIZE);
+    
+    if (flags & FAEB_MEMORY_HUGEPAGES) {
+        size_t length = align_up(size, FAEB_HUGE_PAGE_SIZE);
+        
+#ifdef MAP_HUGETLB
+        // Reserve up front: an unreserved hugetlb mapping faults with
+        // SIGBUS instead of failing here when the pool is empty
+        void* huge = mmap(NULL, length, prot,
+                          (map & ~MAP_NORESERVE) | MAP_HUGETLB, -1, 0);
+        if (huge != MAP_FAILED) {
+            *mapped_size = length;
+            *page_size = FAEB_HUGE_PAGE_SIZE;
+            return huge;
+        }
+#endif
+        
+#ifdef MADV_HUGEPAGE
+        // Over-map so the region can start on a huge page boundary
+        char* raw = mmap(NULL, length + FAEB_HUGE_PAGE_SIZE, prot, map, -1, 0);
+        if (raw != MAP_FAILED) {
+            char* aligned = (char*)align_up((uintptr_t)raw, FAEB_HUGE_PAGE_SIZE);
+            size_t head = (size_t)(aligned - raw);
+            if (head > 0) {
+                munmap(raw, head);
+            }
+            munmap(aligned + length, FAEB_HUGE_PAGE_SIZE - head);
+            
+            *mapped_size = length;
+            *page_size = madvise(aligned, length, MADV_HUGEPAGE) == 0 ?
+                         FAEB_HUGE_PAGE_SIZE : base_page;
+            return aligned;
+        }
+#endif
+    }
+    
+    size_t length = align_up(size, base_page);
+    void* region = mmap(NULL, length, prot, map, -1, 0);
+    if (region == MAP_FAILED) {
+        return NULL;
+    }
+    *mapped_size = length;
+    *page_size = base_page;
+    return region;
+}
+
+// Prefer the node the creating thread is confined to for a mapped
+// region, so a pool made on a pinned worker stays local whichever thread
+// touches it first. Returns the node, or -1 when left to first touch.
+static int region_bind(char* region, size_t size) {
+#if defined(__linux__) && defined(SYS_mbind)
+    int node = faeb_topology_current_node();
+    if (node < 0) {
+        return -1;
+    }
+    
+    // The kernel reads maxnode - 1 bits of the mask
+    const size_t bits = 8 * sizeof(unsigned long);
+    unsigned long mask[FAEB_MEMORY_MAX_NODES / (8 * sizeof(unsigned long))] = { 0 };
+    if ((size_t)node >= FAEB_MEMORY_MAX_NODES) {
+        return -1;
+    }
+    mask[(size_t)node / bits] = 1UL << ((size_t)node % bits);
+    if (syscall(SYS_mbind, region, size, MPOL_PREFERRED, mask,
+                (unsigned long)FAEB_MEMORY_MAX_NODES + 1, 0) != 0) {
+        return -1;
+    }
+    return node;
+#else
+    (void)region;
+    (void)size;
+    return -1;
+#endif
+}
+
+// Touch every page so later allocations never take a page fault
+static void region_prefault(char* region, size_t size, size_t page_size) {
+    for (size_t offset = 0; offset < size; offset += page_size) {
+        ((volatile char*)region)[offset] = 0;
+    }
+}
+
+// Set up the backing region of an arena or slab manager
+static bool region_create(faeb_memory_t* memory, size_t size) {
+    if (!(memory->flags & FAEB_MEMORY_MMAP)) {
+        if (memory->kind == FAEB_MEMORY_ARENA && size > 0) {
+            memory->region = malloc(size);
+            return memory->region != NULL;
+        }
+        return true;
+    }
+    
+    if (size == 0) {
+        return true;
+    }
+    
+    memory->region = region_map(size, memory->flags, &memory->region_size,
+                                &memory->page_size);
+    if (!memory->region) {
+        return false;
+    }
+    memory->numa_node = region_bind(memory->region, memory->region_size);
+    
+    if (memory->kind == FAEB_MEMORY_SLAB) {
+        size_t pages = memory->region_size / FAEB_SLAB_SIZE;
+        memory->free_pages = malloc(pages * sizeof(uint32_t));
+        if (!memory->free_pages) {
+            munmap(memory->region, memory->region_size);
+            memory->region = NULL;
+            return false;
+        }
+    }
+    
+    if (memory->flags & FAEB_MEMORY_PREFAULT) {
+        region_prefault(memory->region, memory->region_size,
+                        memory->page_size);
+    }
+    return true;
+}
+
+static void region_destroy(faeb_memory_t* memory) {
+    if (memory->region_size > 0) {
+        munmap(memory->region, memory->region_size);
+    } else {
+        free(memory->region);
+    }
+    free(memory->free_pages);
+}
+
+static inline bool region_contains(const faeb_memory_t* memory,
+                                   const void* ptr) {
+    return memory->region_size > 0 && (const char*)ptr >= memory->region &&
+           (const char*)ptr < memory->region + memory->region_size;
+}
+
+// Get the calling thread's telemetry counters
+static struct faeb_memory_counters* thread_counters(faeb_memory_t* memory) {
+    struct faeb_memory_tcache* cache = thread_cache(memory);
+    return cache ? &cache->counters : &memory->shared_counters;
+}
+
+// Count events. A thread's own counters have a single writer, so a
+// relaxed load and store suffice and no locked instruction is issued.
+static inline void counter_add(const struct faeb_memory_counters* counters,
+                               _Atomic uint64_t* counter, uint64_t value) {
+    if (counters->shared) {
+        atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+    } else {
+        atomic_store_explicit(counter,
+                              atomic_load_explicit(counter,
+                                                   memory_order_relaxed) + value,
+                              memory_order_relaxed);
+    }
+}
+
+// log2 size bucket, with everything past the last bucket folded into it
+static inline size_t histogram_bucket(size_t size) {
+    size_t bucket = (size_t)(63 - __builtin_clzll((unsigned long long)size));
+    return bucket < FAEB_MEMORY_HISTOGRAM_BUCKETS ?
+           bucket : FAEB_MEMORY_HISTOGRAM_BUCKETS - 1;
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Create memory manager of the configured kind
+faeb_memory_t* faeb_memory_create_config(size_t size,
+                                         const faeb_memory_config_t* config) {
+    faeb_memory_kind_t kind = config ? config->kind : FAEB_MEMORY_HEAP;
+    uint32_t flags = config ? config->flags : 0;
+    if (kind != FAEB_MEMORY_HEAP && kind != FAEB_MEMORY_ARENA &&
+        kind != FAEB_MEMORY_SLAB) {
+        return NULL;
+    }
+    
+    // Heap blocks are individually allocated and cannot share one mapping
+    if (kind == FAEB_MEMORY_HEAP && (flags & FAEB_MEMORY_MMAP)) {
+        return NULL;
+    }
+    
     faeb_memory_t* memory = malloc(sizeof(faeb_memory_t));
     if (!memory) {
         return NULL;
     }
     
+    memory->kind = kind;
+    memory->flags = flags;
     memory->total_size = size;
-    memory->used_size = 0;
+    atomic_init(&memory->used_size, 0);
     memory->blocks = NULL;
-    memory->last_error = FAEB_SUCCESS;
+    memset(&memory->index, 0, sizeof(memory->index));
+    memory->region = NULL;
+    memory->region_size = 0;
+    memory->page_size = (size_t)sysconf(_SC_PAGESIZE);
+    memory->numa_node = -1;
+    memory->arena_last = 0;
+    memset(&memory->arena_blocks, 0, sizeof(memory->arena_blocks));
+    memory->arena_high = 0;
+    memory->slab_cursor = 0;
+    memory->free_pages = NULL;
+    memory->free_page_count = 0;
+    atomic_init(&memory->slab_pages, NULL);
+    memset(memory->classes, 0, sizeof(memory->classes));
+    for (size_t t = 0; t < FAEB_MEMORY_MAX_THREADS; t++) {
+        atomic_init(&memory->tcaches[t], NULL);
+    }
+    memset(&memory->shared_counters, 0, sizeof(memory->shared_counters));
+    memory->shared_counters.shared = true;
+    atomic_init(&memory->peak_size, 0);
+    memory->created_ns = monotonic_ns();
+    atomic_init(&memory->profile.sample_rate, 0);
+    memory->profile.next = 0;
+    memory->profile.recorded = 0;
+    memory->profile.samples = NULL;
+    
+    if (pthread_mutex_init(&memory->lock, NULL) != 0) {
+        free(memory);
+        return NULL;
+    }
+    
+    if (!region_create(memory, size)) {
+        pthread_mutex_destroy(&memory->lock);
+        free(memory);
+        return NULL;
+    }
     
     return memory;
 }
 
-// Destroy memory manager and free all blocks
-void faeb_memory_destroy(faeb_memory_t* memory) {
-    if (!memory) return;
-    
-    // Free all allocated blocks
+// Create memory manager with specified size
+faeb_memory_t* faeb_memory_create(size_t size) {
+    return faeb_memory_create_config(size, NULL);
+}
+
+// Create arena memory manager backed by one contiguous region of size bytes
+faeb_memory_t* faeb_memory_create_arena(size_t size) {
+    faeb_memory_config_t config = { .kind = FAEB_MEMORY_ARENA };
+    return faeb_memory_create_config(size, &config);
+}
+
+// Release every heap block
+static void heap_release_all(faeb_memory_t* memory) {
     struct faeb_memory_block* current = memory->blocks;
     while (current) {
         struct faeb_memory_block* next = current->next;
-        free(current->ptr);
-        free(current);
+        free(block_base(current));
         current = next;
     }
-    
-    free(memory);
+    memory->blocks = NULL;
+    index_clear(&memory->index);
 }
 
-// Allocate memory block
-void* faeb_memory_allocate(faeb_memory_t* memory, size_t size) {
-    if (!memory || size == 0) {
-        if (memory) memory->last_error = FAEB_ERROR_INVALID;
+// Find the page map word holding page's bit, creating the nodes on the
+// way when create is set. Caller holds the lock.
+static _Atomic uint64_t* pagemap_word(faeb_memory_t* memory, const void* page,
+                                      bool create) {
+    uintptr_t number = (uintptr_t)page / FAEB_SLAB_SIZE;
+    if (number >> (3 * FAEB_PAGEMAP_BITS)) {
         return NULL;
     }
     
-    // Check if allocation would exceed total size
-    if (memory->used_size + size > memory->total_size) {
-        memory->last_error = FAEB_ERROR_LIMIT;
-        return NULL;
+    struct faeb_memory_pagemap* map =
+        atomic_load_explicit(&memory->slab_pages, memory_order_relaxed);
+    if (!map) {
+        if (!create || !(map = calloc(1, sizeof(*map)))) return NULL;
+        atomic_store_explicit(&memory->slab_pages, map, memory_order_release);
     }
     
-    // Allocate memory
-    void* ptr = malloc(size);
-    if (!ptr) {
-        memory->last_error = FAEB_ERROR_MEMORY;
+    _Atomic(struct faeb_memory_pagemap_node*)* node_slot =
+        &map->nodes[number >> (2 * FAEB_PAGEMAP_BITS)];
+    struct faeb_memory_pagemap_node* node =
+        atomic_load_explicit(node_slot, memory_order_relaxed);
+    if (!node) {
+        if (!create || !(node = calloc(1, sizeof(*node)))) return NULL;
+        atomic_store_explicit(node_slot, node, memory_order_release);
+    }
+    
+    _Atomic(struct faeb_memory_pagemap_leaf*)* leaf_slot =
+        &node->leaves[(number >> FAEB_PAGEMAP_BITS) & (FAEB_PAGEMAP_FANOUT - 1)];
+    struct faeb_memory_pagemap_leaf* leaf =
+        atomic_load_explicit(leaf_slot, memory_order_relaxed);
+    if (!leaf) {
+        if (!create || !(leaf = calloc(1, sizeof(*leaf)))) return NULL;
+        atomic_store_explicit(leaf_slot, leaf, memory_order_release);
+    }
+    
+    return &leaf->pages[(number & (FAEB_PAGEMAP_FANOUT - 1)) / 64];
+}
+
+static bool pagemap_mark(faeb_memory_t* memory, const void* page) {
+    _Atomic uint64_t* word = pagemap_word(memory, page, true);
+    if (!word) return false;
+    uint64_t bit = (uint64_t)1 << ((uintptr_t)page / FAEB_SLAB_SIZE % 64);
+    atomic_fetch_or_explicit(word, bit, memory_order_relaxed);
+    return true;
+}
+
+static void pagemap_clear(faeb_memory_t* memory, const void* page) {
+    _Atomic uint64_t* word = pagemap_word(memory, page, false);
+    if (!word) return;
+    uint64_t bit = (uint64_t)1 << ((uintptr_t)page / FAEB_SLAB_SIZE % 64);
+    atomic_fetch_and_explicit(word, ~bit, memory_order_relaxed);
+}
+
+// Check whether page is a live slab page of this manager, without the
+// lock and without reading the page itself
+static bool pagemap_contains(faeb_memory_t* memory, const void* page) {
+    uintptr_t number = (uintptr_t)page / FAEB_SLAB_SIZE;
+    if (number >> (3 * FAEB_PAGEMAP_BITS)) {
+        return false;
+    }
+    
+    struct faeb_memory_pagemap* map =
+        atomic_load_explicit(&memory->slab_pages, memory_order_acquire);
+    if (!map) return false;
+    struct faeb_memory_pagemap_node* node =
+        atomic_load_explicit(&map->nodes[number >> (2 * FAEB_PAGEMAP_BITS)],
+                             memory_order_acquire);
+    if (!node) return false;
+    struct faeb_memory_pagemap_leaf* leaf =
+        atomic_load_explicit(&node->leaves[(number >> FAEB_PAGEMAP_BITS) &
+                                           (FAEB_PAGEMAP_FANOUT - 1)],
+                             memory_order_acquire);
+    if (!leaf) return false;
+    
+    size_t bit = number & (FAEB_PAGEMAP_FANOUT - 1);
+    return (atomic_load_explicit(&leaf->pages[bit / 64],
+                                 memory_order_relaxed) >> (bit % 64)) & 1;
+}
+
+static void pagemap_destroy(faeb_memory_t* memory) {
+    struct faeb_memory_pagemap* map = memory->slab_pages;
+    if (!map) return;
+    for (size_t i = 0; i < FAEB_PAGEMAP_FANOUT; i++) {
+        struct faeb_memory_pagemap_node* node = map->nodes[i];
+        if (!node) continue;
+        for (size_t j = 0; j < FAEB_PAGEMAP_FANOUT; j++) {
+            free(node->leaves[j]);
+        }
+        free(node);
+    }
+    free(map);
+}
+
+// Get a slab page from the mapped region, or from libc when unmapped
+// or exhausted
+static void* slab_page_take(faeb_memory_t* memory) {
+    if (memory->region_size > 0) {
+        if (memory->free_page_count > 0) {
+            uint32_t page = memory->free_pages[--memory->free_page_count];
+            return memory->region + (size_t)page * FAEB_SLAB_SIZE;
+        }
+        if (memory->slab_cursor + FAEB_SLAB_SIZE <= memory->region_size) {
+            void* page = memory->region + memory->slab_cursor;
+            memory->slab_cursor += FAEB_SLAB_SIZE;
+            return page;
+        }
+    }
+    return aligned_alloc(FAEB_SLAB_SIZE, FAEB_SLAB_SIZE);
+}
+
+static void slab_page_release(faeb_memory_t* memory,
+                              struct faeb_memory_slab* slab) {
+    pagemap_clear(memory, slab);
+    if (region_contains(memory, slab)) {
+        memory->free_pages[memory->free_page_count++] =
+            (uint32_t)(((char*)slab - memory->region) / FAEB_SLAB_SIZE);
+    } else {
+        free(slab);
+    }
+}
+
+static void slab_list_release(faeb_memory_t* memory,
+                              struct faeb_memory_slab* slab) {
+    while (slab) {
+        struct faeb_memory_slab* next = slab->next;
+        slab_page_release(memory, slab);
+        slab = next;
+    }
+}
+
+// Release every slab of every class and empty all thread caches
+static void slab_release_all(faeb_memory_t* memory) {
+    for (size_t i = 0; i < FAEB_MEMORY_SLAB_CLASSES; i++) {
+        slab_list_release(memory, memory->classes[i].partial);
+        slab_list_release(memory, memory->classes[i].full);
+    }
+    memset(memory->classes, 0, sizeof(memory->classes));
+    memory->slab_cursor = 0;
+    memory->free_page_count = 0;
+    
+    for (size_t t = 0; t < FAEB_MEMORY_MAX_THREADS; t++) {
+        if (memory->tcaches[t]) {
+            memset(memory->tcaches[t]->magazines, 0,
+                   sizeof(memory->tcaches[t]->magazines));
+        }
+    }
+}
+
+// Destroy memory manager and free all blocks. No other thread may be
+// using the manager.
+void faeb_memory_destroy(faeb_memory_t* memory) {
+    if (!memory) return;
+    
+    heap_release_all(memory);
+    slab_release_all(memory);
+    pagemap_destroy(memory);
+    for (size_t t = 0; t < FAEB_MEMORY_MAX_THREADS; t++) {
+        free(memory->tcaches[t]);
+    }
+    pthread_mutex_destroy(&memory->lock);
+    region_destroy(memory);
+    free(memory->arena_blocks.items);
+    free(memory->profile.samples);
+    free(memory);
+}
+
+// Unlink a heap block from the manager's list. Caller holds the lock.
+static void heap_unlink(faeb_memory_t* memory, struct faeb_memory_block* block) {
+    if (block->prev) {
+        block->prev->next = block->next;
+    } else {
+        memory->blocks = block->next;
+    }
+    if (block->next) {
+        block->next->prev = block->prev;
+    }
+}
+
+// Link a heap block at the head of the manager's list. Caller holds the lock.
+static void heap_link(faeb_memory_t* memory, struct faeb_memory_block* block) {
+    block->prev = NULL;
+    block->next = memory->blocks;
+    if (memory->blocks) {
+        memory->blocks->prev = block;
+    }
+    memory->blocks = block;
+}
+
+// Allocate header and payload from libc. Over-aligned payloads get a
+// padded prefix so the header still sits directly before the payload.
+static void* heap_allocate(faeb_memory_t* memory, size_t size,
+                           size_t alignment) {
+    if (!budget_reserve(memory, size)) {
+        memory_last_error = FAEB_ERROR_LIMIT;
         return NULL;
     }
     
-    // Create block tracker
-    struct faeb_memory_block* block = malloc(sizeof(struct faeb_memory_block));
+    struct faeb_memory_block* block = NULL;
+    size_t offset = 0;
+    if (alignment <= FAEB_MEMORY_ALIGN) {
+        if (size <= SIZE_MAX - FAEB_MEMORY_HEADER_SIZE) {
+            block = malloc(FAEB_MEMORY_HEADER_SIZE + size);
+        }
+    } else {
+        size_t prefix = align_up(FAEB_MEMORY_HEADER_SIZE, alignment);
+        if (size <= SIZE_MAX - prefix - alignment) {
+            char* base = aligned_alloc(alignment,
+                                       align_up(prefix + size, alignment));
+            if (base) {
+                offset = prefix - FAEB_MEMORY_HEADER_SIZE;
+                block = (struct faeb_memory_block*)(base + offset);
+            }
+        }
+    }
     if (!block) {
-        free(ptr);
-        memory->last_error = FAEB_ERROR_MEMORY;
+        budget_release(memory, size);
+        memory_last_error = FAEB_ERROR_MEMORY;
         return NULL;
     }
     
-    block->ptr = ptr;
     block->size = size;
-    block->next = memory->blocks;
-    memory->blocks = block;
+    block->alignment = alignment > FAEB_MEMORY_ALIGN ? alignment : FAEB_MEMORY_ALIGN;
     
-    memory->used_size += size;
-    memory->last_error = FAEB_SUCCESS;
+    pthread_mutex_lock(&memory->lock);
+    if (!index_reserve(&memory->index, 1)) {
+        pthread_mutex_unlock(&memory->lock);
+        free((char*)block - offset);
+        budget_release(memory, size);
+        memory_last_error = FAEB_ERROR_MEMORY;
+        return NULL;
+    }
+    index_insert(&memory->index, (uintptr_t)block);
+    heap_link(memory, block);
+    pthread_mutex_unlock(&memory->lock);
     
-    return ptr;
+    memory_last_error = FAEB_SUCCESS;
+    return block_payload(block);
 }
 
-// Free memory block
-void faeb_memory_free(faeb_memory_t* memory, void* ptr) {
-    if (!memory || !ptr) return;
+// Make room for count more arena extents
+static bool extents_reserve(struct faeb_memory_extents* extents, size_t count) {
+    if (count <= extents->capacity - extents->count) {
+        return true;
+    }
     
-    // Find and remove block
-    struct faeb_memory_block** current = &memory->blocks;
-    while (*current) {
-        if ((*current)->ptr == ptr) {
-            struct faeb_memory_block* block = *current;
-            *current = block->next;
-            
-            memory->used_size -= block->size;
-            free(block->ptr);
-            free(block);
-            
-            memory->last_error = FAEB_SUCCESS;
-            return;
+    size_t capacity = extents->capacity ? extents->capacity : 64;
+    while (capacity - extents->count < count) {
+        if (capacity > SIZE_MAX / 2 / sizeof(struct faeb_memory_extent)) {
+            return false;
         }
-        current = &(*current)->next;
+        capacity *= 2;
     }
-    
-    memory->last_error = FAEB_ERROR_INVALID;
+    struct faeb_memory_extent* items =
+        realloc(extents->items, capacity * sizeof(struct faeb_memory_extent));
+    if (!items) {
+        return false;
+    }
+    extents->items = items;
+    extents->capacity = capacity;
+    return true;
+}
+
+// Append an extent past every other; capacity must have been reserved
+static inline void extents_push(struct faeb_memory_extents* extents,
+                                size_t offset, size_t size) {
+    extents->items[extents->count++] = (struct faeb_memory_extent){ offset, size };
+}
+
+// Extent of the allocation starting at offset, NULL when none does
+static struct faeb_memory_extent* extents_find(struct faeb_memory_extents* extents,
+                                               size_t offset) {
+    size_t low = 0;
+    size_t high = extents->count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (extents->items[middle].offset < offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == extents->count || extents->items[low].offset != offset) {
+        return NULL;
+    }
+    return &extents->items[low];
+}
+
+// Carve the next aligned slice off the arena region
+static void* arena_allocate(faeb_memory_t* memory, size_t size,
+                            size_t alignment) {
+    pthread_mutex_lock(&memory->lock);
+    size_t used = atomic_load_explicit(&memory->used_size,
+                                       memory_order_relaxed);
+    uintptr_t base = (uintptr_t)memory->region;
+    size_t offset = (size_t)(align_up(base + used, alignment) - base);
+    if (offset > memory->total_size || size > memory->total_size - offset) {
+        pthread_mutex_unlock(&memory->lock);
+        memory_last_error = FAEB_ERROR_LIMIT;
+        return NULL;
+    }
+    if (!extents_reserve(&memory->arena_blocks, 1)) {
+        pthread_mutex_unlock(&memory->lock);
+        memory_last_error = FAEB_ERROR_MEMORY;
+        return NULL;
+    }
+    
+    extents_push(&memory->arena_blocks, offset, size);
+    memory->arena_last = offset;
+    if (offset + size > memory->arena_high) {
+        memory->arena_high = offset + size;
+    }
+    atomic_store_explicit(&memory->used_size, offset + size,
+                          memory_order_relaxed);
+    pthread_mutex_unlock(&memory->lock);
+    peak_update(memory, offset + size);
+    
+    memory_last_error = FAEB_SUCCESS;
+    return memory->region + offset;
+}
+
+static void slab_unlink(struct faeb_memory_slab** list,
+                        struct faeb_memory_slab* slab) {
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        *list = slab->next;
+    }
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+    slab->prev = NULL;
+    slab->next = NULL;
+}
+
+static void slab_push(struct faeb_memory_slab** list,
+                      struct faeb_memory_slab* slab) {
+    slab->prev = NULL;
+    slab->next = *list;
+    if (*list) {
+        (*list)->prev = slab;
+    }
+    *list = slab;
+}
+
+// Get a fresh page-aligned slab for a size class
+static struct faeb_memory_slab* slab_create(faeb_memory_t* memory,
+                                            size_t class_index) {
+    struct faeb_memory_slab* slab = slab_page_take(memory);
+    if (!slab) return NULL;
+    if (!pagemap_mark(memory, slab)) {
+        slab_page_release(memory, slab);
+        return NULL;
+    }
+    
+    size_t object_size = slab_class_sizes[class_index];
+    slab->prev = NULL;
+    slab->next = NULL;
+    slab->free_list = NULL;
+    slab->bump = 0;
+    slab->in_use = 0;
+    slab->capacity = (uint16_t)((FAEB_SLAB_SIZE - FAEB_SLAB_HEADER_SIZE) /
+                                object_size);
+    slab->class_index = (uint16_t)class_index;
+    for (size_t i = 0; i < FAEB_SLAB_BITMAP_WORDS; i++) {
+        atomic_init(&slab->allocated[i], 0);
+    }
+    
+    memory->classes[class_index].slabs++;
+    return slab;
+}
+
+// Take one object of a size class out of its slabs. Caller holds the lock.
+static void* slab_take(faeb_memory_t* memory, size_t class_index) {
+    struct faeb_memory_class* cls = &memory->classes[class_index];
+    size_t object_size = slab_class_sizes[class_index];
+    
+    struct faeb_memory_slab* slab = cls->partial;
+    if (!slab) {
+        slab = slab_create(memory, class_index);
+        if (!slab) {
+            return NULL;
+        }
+        slab_push(&cls->partial, slab);
+    }
+    
+    void* object = slab->free_list;
+    if (object) {
+        slab->free_list = *(void**)object;
+    } else {
+        object = slab_objects(slab) + (size_t)slab->bump++ * object_size;
+    }
+    
+    if (++slab->in_use == slab->capacity) {
+        slab_unlink(&cls->partial, slab);
+        slab_push(&cls->full, slab);
+    }
+    
+    cls->in_use++;
+    return object;
+}
+
+// Return one object to its slab. Caller holds the lock.
+static void slab_put(faeb_memory_t* memory, void* ptr) {
+    struct faeb_memory_slab* slab = slab_of(ptr);
+    struct faeb_memory_class* cls = &memory->classes[slab->class_index];
+    
+    if (slab->in_use == slab->capacity) {
+        slab_unlink(&cls->full, slab);
+        slab_push(&cls->partial, slab);
+    }
+    
+    *(void**)ptr = slab->free_list;
+    slab->free_list = ptr;
+    slab->in_use--;
+    cls->in_use--;
+    
+    // Keep one empty slab per class warm, give the rest back
+    if (slab->in_use == 0 && (slab->prev || slab->next)) {
+        slab_unlink(&cls->partial, slab);
+        slab_page_release(memory, slab);
+        cls->slabs--;
+    }
+}
+
+// Flip an object's allocated bit, returning whether it was set before
+static inline bool slab_object_mark(void* ptr, bool allocated) {
+    struct faeb_memory_slab* slab = slab_of(ptr);
+    size_t index = (size_t)((char*)ptr - slab_objects(slab)) /
+                   slab_class_sizes[slab->class_index];
+    uint64_t bit = (uint64_t)1 << (index % 64);
+    _Atomic uint64_t* word = &slab->allocated[index / 64];
+    uint64_t old = allocated ?
+                   atomic_fetch_or_explicit(word, bit, memory_order_relaxed) :
+                   atomic_fetch_and_explicit(word, ~bit, memory_order_relaxed);
+    return (old & bit) != 0;
+}
+
+// Whether an object's allocated bit is set, leaving it as it is
+static inline bool slab_object_allocated(void* ptr) {
+    struct faeb_memory_slab* slab = slab_of(ptr);
+    size_t index = (size_t)((char*)ptr - slab_objects(slab)) /
+                   slab_class_sizes[slab->class_index];
+    uint64_t word = atomic_load_explicit(&slab->allocated[index / 64],
+                                         memory_order_relaxed);
+    return (word >> (index % 64)) & 1;
+}
+
+// Pop one object of a size class, refilling the thread's magazine from
+// the slabs when it runs dry
+static void* slab_allocate(faeb_memory_t* memory, size_t class_index) {
+    size_t object_size = slab_class_sizes[class_index];
+    if (!budget_reserve(memory, object_size)) {
+        memory_last_error = FAEB_ERROR_LIMIT;
+        return NULL;
+    }
+    
+    void* object = NULL;
+    struct faeb_memory_tcache* cache = thread_cache(memory);
+    if (cache) {
+        struct faeb_memory_magazine* magazine = &cache->magazines[class_index];
+        if (magazine->count == 0) {
+            pthread_mutex_lock(&memory->lock);
+            while (magazine->count < FAEB_MAGAZINE_SIZE / 2) {
+                void* fresh = slab_take(memory, class_index);
+                if (!fresh) break;
+                magazine->objects[magazine->count++] = fresh;
+            }
+            pthread_mutex_unlock(&memory->lock);
+        }
+        if (magazine->count > 0) {
+            object = magazine->objects[--magazine->count];
+        }
+    } else {
+        pthread_mutex_lock(&memory->lock);
+        object = slab_take(memory, class_index);
+        pthread_mutex_unlock(&memory->lock);
+    }
+    
+    if (!object) {
+        budget_release(memory, object_size);
+        memory_last_error = FAEB_ERROR_MEMORY;
+        return NULL;
+    }
+    
+    slab_object_mark(object, true);
+    memory_last_error = FAEB_SUCCESS;
+    return object;
+}
+
+// Route small requests to their size class, the rest to the heap. Every
+// class of at least the requested alignment (up to a cache line) is a
+// multiple of it, so over-aligned requests just pick a bigger class.
+static void* slab_engine_allocate(faeb_memory_t* memory, size_t size,
+                                  size_t alignment) {
+    if (alignment <= FAEB_CACHE_LINE_SIZE) {
+        size_t rounded = size > alignment ? size : alignment;
+        if (rounded <= FAEB_SLAB_MAX_OBJECT) {
+            return slab_allocate(memory,
+                                 slab_class_index[(rounded + 15) >> 4]);
+        }
+    }
+    return heap_allocate(memory, size, alignment);
+}
+
+// Record the calling stack of a sampled allocation
+static void profile_record(faeb_memory_t* memory, size_t size) {
+    faeb_memory_sample_t sample;
+    sample.size = size;
+#if defined(__GLIBC__)
+    sample.depth = (uint32_t)backtrace(sample.frames,
+                                       FAEB_MEMORY_PROFILE_DEPTH);
+#else
+    sample.depth = 0;
+#endif
+    
+    pthread_mutex_lock(&memory->lock);
+    if (memory->profile.samples) {
+        memory->profile.samples[memory->profile.next] = sample;
+        memory->profile.next = (memory->profile.next + 1) %
+                               FAEB_MEMORY_PROFILE_SAMPLES;
+        memory->profile.recorded++;
+    }
+    pthread_mutex_unlock(&memory->lock);
+}
+
+static void* memory_allocate(faeb_memory_t* memory, size_t size,
+                             size_t alignment) {
+    void* ptr;
+    switch (memory->kind) {
+        case FAEB_MEMORY_ARENA:
+            ptr = arena_allocate(memory, size, alignment);
+            break;
+        case FAEB_MEMORY_SLAB:
+            ptr = slab_engine_allocate(memory, size, alignment);
+            break;
+        default:
+            ptr = heap_allocate(memory, size, alignment);
+            break;
+    }
+    
+    struct faeb_memory_counters* counters = thread_counters(memory);
+    if (!ptr) {
+        if (memory_last_error == FAEB_ERROR_LIMIT) {
+            counter_add(counters, &counters->limit_hits, 1);
+        }
+        return NULL;
+    }
+    counter_add(counters, &counters->allocations, 1);
+    counter_add(counters, &counters->histogram[histogram_bucket(size)], 1);
+    
+    uint32_t rate = atomic_load_explicit(&memory->profile.sample_rate,
+                                         memory_order_relaxed);
+    if (rate != 0) {
+        if (profile_countdown == 0 || profile_countdown > rate) {
+            profile_countdown = rate;
+        }
+        if (--profile_countdown == 0) {
+            profile_record(memory, size);
+        }
+    }
+    
+    return ptr;
+}
+
+// Allocate memory block
+void* faeb_memory_allocate(faeb_memory_t* memory, size_t size) {
+    if (!memory || size == 0) {
+        memory_last_error = FAEB_ERROR_INVALID;
+        return NULL;
+    }
+    
+    return memory_allocate(memory, size, FAEB_MEMORY_ALIGN);
+}
+
+// Allocate memory block aligned to a power of two
+void* faeb_memory_allocate_aligned(faeb_memory_t* memory, size_t size,
+                                   size_t alignment) {
+    if (!memory || size == 0 || alignment == 0 ||
+        (alignment & (alignment - 1)) != 0) {
+        memory_last_error = FAEB_ERROR_INVALID;
+        return NULL;
+    }
+    
+    if (alignment < FAEB_MEMORY_ALIGN) {
+        alignment = FAEB_MEMORY_ALIGN;
+    }
+    return memory_allocate(memory, size, alignment);
+}
+
+// Allocate whole cache lines, so the block shares no line with any other
+// allocation
+void* faeb_memory_allocate_cacheline(faeb_memory_t* memory, size_t size) {
+    if (size > SIZE_MAX - FAEB_CACHE_LINE_SIZE) {
+        memory_last_error = FAEB_ERROR_INVALID;
+        return NULL;
+    }
+    return faeb_memory_allocate_aligned(memory,
+                                        align_up(size, FAEB_CACHE_LINE_SIZE),
+                                        FAEB_CACHE_LINE_SIZE);
+}
+
+// Free heap block in constant time. The index is consulted before the
+// in-band header is read, so foreign and double frees never touch memory.
+static void heap_free(faeb_memory_t* memory, void* ptr) {
+    uintptr_t key = payload_block(ptr);
+    
+    pthread_mutex_lock(&memory->lock);
+    if (!index_remove(&memory->index, key)) {
+        pthread_mutex_unlock(&memory->lock);
+        memory_last_error = FAEB_ERROR_INVALID;
+        return;
+    }
+    struct faeb_memory_block* block = (struct faeb_memory_block*)key;
+    heap_unlink(memory, block);
+    pthread_mutex_unlock(&memory->lock);
+    
+    size_t size = block->size;
+    free(block_base(block));
+    
+    budget_release(memory, size);
+    memory_last_error = FAEB_SUCCESS;
+}
+
+// Arena frees only roll back the most recent allocation; everything
+// else is released in bulk by faeb_memory_reset
+static void arena_free(faeb_memory_t* memory, void* ptr) {
+    char* p = ptr;
+    
+    pthread_mutex_lock(&memory->lock);
+    size_t used = atomic_load_explicit(&memory->used_size,
+                                       memory_order_relaxed);
+    if (p < memory->region || p >= memory->region + used) {
+        pthread_mutex_unlock(&memory->lock);
+        memory_last_error = FAEB_ERROR_INVALID;
+        return;
+    }
+    
+    if ((size_t)(p - memory->region) == memory->arena_last) {
+        atomic_store_explicit(&memory->used_size, memory->arena_last,
+                              memory_order_relaxed);
+        memory->arena_blocks.count--;
+    }
+    pthread_mutex_unlock(&memory->lock);
+    
+    memory_last_error = FAEB_SUCCESS;
+}
+
+// Find the slab owning ptr, or NULL if ptr is not an object of this
+// manager. The page map vouches for the page before its header is read.
+static struct faeb_memory_slab* slab_lookup(faeb_memory_t* memory, void* ptr) {
+    struct faeb_memory_slab* slab = slab_of(ptr);
+    return pagemap_contains(memory, slab) ? slab : NULL;
+}
+
+// Check that ptr is an object boundary inside the slab. Uses only fields
+// fixed at slab creation, so no lock is needed.
+static bool slab_object_valid(struct faeb_memory_slab* slab, void* ptr) {
+    size_t object_size = slab_class_sizes[slab->class_index];
+    char* objects = slab_objects(slab);
+    return (char*)ptr >= objects &&
+           (char*)ptr < objects + (size_t)slab->capacity * object_size &&
+           (size_t)((char*)ptr - objects) % object_size == 0;
+}
+
+// Push one object onto the thread's magazine, spilling half of a full
+// magazine back to the slabs first
+static void slab_free(faeb_memory_t* memory, struct faeb_memory_slab* slab,
+                      void* ptr) {
+    size_t object_size = slab_class_sizes[slab->class_index];
+    if (!slab_object_valid(slab, ptr) || !slab_object_mark(ptr, false)) {
+        memory_last_error = FAEB_ERROR_INVALID;
+        return;
+    }
+    
+    struct faeb_memory_tcache* cache = thread_cache(memory);
+    if (cache) {
+        struct faeb_memory_magazine* magazine =
+            &cache->magazines[slab->class_index];
+        if (magazine->count == FAEB_MAGAZINE_SIZE) {
+            pthread_mutex_lock(&memory->lock);
+            while (magazine->count > FAEB_MAGAZINE_SIZE / 2) {
+                slab_put(memory, magazine->objects[--magazine->count]);
+            }
+            pthread_mutex_unlock(&memory->lock);
+        }
+        magazine->objects[magazine->count++] = ptr;
+    } else {
+        pthread_mutex_lock(&memory->lock);
+        slab_put(memory, ptr);
+        pthread_mutex_unlock(&memory->lock);
+    }
+    
+    budget_release(memory, object_size);
+    memory_last_error = FAEB_SUCCESS;
+}
+
+// Free memory block
+void faeb_memory_free(faeb_memory_t* memory, void* ptr) {
+    if (!memory || !ptr) return;
+    
+    switch (memory->kind) {
+        case FAEB_MEMORY_ARENA:
+            arena_free(memory, ptr);
+            break;
+        case FAEB_MEMORY_SLAB: {
+            struct faeb_memory_slab* slab = slab_lookup(memory, ptr);
+            if (slab) {
+                slab_free(memory, slab, ptr);
+            } else {
+                heap_free(memory, ptr);
+            }
+            break;
+        }
+        default:
+            heap_free(memory, ptr);
+            break;
+    }
+    
+    if (memory_last_error == FAEB_SUCCESS) {
+        struct faeb_memory_counters* counters = thread_counters(memory);
+        counter_add(counters, &counters->frees, 1);
+    }
+}
+
+// Carve count slices from the arena under one lock acquisition
+static faeb_result_t arena_allocate_batch(faeb_memory_t* memory, size_t size,
+                                          void** ptrs, size_t count) {
+    pthread_mutex_lock(&memory->lock);
+    size_t offset = atomic_load_explicit(&memory->used_size,
+                                         memory_order_relaxed);
+    size_t last = memory->arena_last;
+    struct faeb_memory_extents* extents = &memory->arena_blocks;
+    if (!extents_reserve(extents, count)) {
+        pthread_mutex_unlock(&memory->lock);
+        return FAEB_ERROR_MEMORY;
+    }
+    size_t start = extents->count;
+    for (size_t i = 0; i < count; i++) {
+        offset = align_up(offset, FAEB_MEMORY_ALIGN);
+        if (offset > memory->total_size || size > memory->total_size - offset) {
+            extents->count = start;
+            pthread_mutex_unlock(&memory->lock);
+            return FAEB_ERROR_LIMIT;
+        }
+        ptrs[i] = memory->region + offset;
+        extents_push(extents, offset, size);
+        last = offset;
+        offset += size;
+    }
+    
+    memory->arena_last = last;
+    if (offset > memory->arena_high) {
+        memory->arena_high = offset;
+    }
+    atomic_store_explicit(&memory->used_size, offset, memory_order_relaxed);
+    pthread_mutex_unlock(&memory->lock);
+    peak_update(memory, offset);
+    
+    return FAEB_SUCCESS;
+}
+
+// Fill ptrs from the thread's magazine, then straight from the slabs
+// under one lock acquisition
+static faeb_result_t slab_allocate_batch(faeb_memory_t* memory,
+                                         size_t class_index, void** ptrs,
+                                         size_t count) {
+    size_t object_size = slab_class_sizes[class_index];
+    if (count > SIZE_MAX / object_size ||
+        !budget_reserve(memory, count * object_size)) {
+        return FAEB_ERROR_LIMIT;
+    }
+    
+    size_t filled = 0;
+    struct faeb_memory_tcache* cache = thread_cache(memory);
+    if (cache) {
+        struct faeb_memory_magazine* magazine = &cache->magazines[class_index];
+        while (filled < count && magazine->count > 0) {
+            ptrs[filled++] = magazine->objects[--magazine->count];
+        }
+    }
+    
+    if (filled < count) {
+        pthread_mutex_lock(&memory->lock);
+        while (filled < count) {
+            void* object = slab_take(memory, class_index);
+            if (!object) {
+                while (filled > 0) {
+                    slab_put(memory, ptrs[--filled]);
+                }
+                pthread_mutex_unlock(&memory->lock);
+                budget_release(memory, count * object_size);
+                return FAEB_ERROR_MEMORY;
+            }
+            ptrs[filled++] = object;
+        }
+        pthread_mutex_unlock(&memory->lock);
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        slab_object_mark(ptrs[i], true);
+    }
+    return FAEB_SUCCESS;
+}
+
+// Allocate count heap blocks, chain them privately and splice the chain
+// into the block list under one lock acquisition
+static faeb_result_t heap_allocate_batch(faeb_memory_t* memory, size_t size,
+                                         void** ptrs, size_t count) {
+    if (count > SIZE_MAX / size || !budget_reserve(memory, count * size)) {
+        return FAEB_ERROR_LIMIT;
+    }
+    
+    struct faeb_memory_block* head = NULL;
+    struct faeb_memory_block* tail = NULL;
+    for (size_t i = 0; i < count; i++) {
+        struct faeb_memory_block* block = NULL;
+        if (size <= SIZE_MAX - FAEB_MEMORY_HEADER_SIZE) {
+            block = malloc(FAEB_MEMORY_HEADER_SIZE + size);
+        }
+        if (!block) {
+            while (head) {
+                struct faeb_memory_block* next = head->next;
+                free(head);
+                head = next;
+            }
+            budget_release(memory, count * size);
+            return FAEB_ERROR_MEMORY;
+        }
+        
+        block->size = size;
+        block->alignment = FAEB_MEMORY_ALIGN;
+        block->prev = tail;
+        block->next = NULL;
+        if (tail) {
+            tail->next = block;
+        } else {
+            head = block;
+        }
+        tail = block;
+        ptrs[i] = block_payload(block);
+    }
+    
+    pthread_mutex_lock(&memory->lock);
+    if (!index_reserve(&memory->index, count)) {
+        pthread_mutex_unlock(&memory->lock);
+        while (head) {
+            struct faeb_memory_block* next = head->next;
+            free(head);
+            head = next;
+        }
+        budget_release(memory, count * size);
+        return FAEB_ERROR_MEMORY;
+    }
+    for (struct faeb_memory_block* block = head; block; block = block->next) {
+        index_insert(&memory->index, (uintptr_t)block);
+    }
+    tail->next = memory->blocks;
+    if (memory->blocks) {
+        memory->blocks->prev = tail;
+    }
+    memory->blocks = head;
+    pthread_mutex_unlock(&memory->lock);
+    
+    return FAEB_SUCCESS;
+}
+
+// Allocate count blocks of size bytes, all or nothing: either every slot
+// of ptrs is filled, or every slot is NULL and the budget is untouched
+faeb_result_t faeb_memory_allocate_batch(faeb_memory_t* memory, size_t size,
+                                         void** ptrs, size_t count) {
+    if (!memory || !ptrs || size == 0 || count == 0) {
+        memory_last_error = FAEB_ERROR_INVALID;
+        return FAEB_ERROR_INVALID;
+    }
+    
+    faeb_result_t result;
+    switch (memory->kind) {
+        case FAEB_MEMORY_ARENA:
+            result = arena_allocate_batch(memory, size, ptrs, count);
+            break;
+        case FAEB_MEMORY_SLAB:
+            if (size <= FAEB_SLAB_MAX_OBJECT) {
+                result = slab_allocate_batch(memory,
+                                             slab_class_index[(size + 15) >> 4],
+                                             ptrs, count);
+                break;
+            }
+            result = heap_allocate_batch(memory, size, ptrs, count);
+            break;
+        default:
+            result = heap_allocate_batch(memory, size, ptrs, count);
+            break;
+    }
+    
+    struct faeb_memory_counters* counters = thread_counters(memory);
+    if (result == FAEB_SUCCESS) {
+        counter_add(counters, &counters->allocations, count);
+        counter_add(counters, &counters->histogram[histogram_bucket(size)],
+                    count);
+    } else {
+        memset(ptrs, 0, count * sizeof(*ptrs));
+        if (result == FAEB_ERROR_LIMIT) {
+            counter_add(counters, &counters->limit_hits, 1);
+        }
+    }
+    
+    memory_last_error = result;
+    return result;
+}
+
+// Free a batch of blocks. Budget, statistics and lock traffic are paid
+// once for the whole batch; heap memory goes back to libc after the lock
+// is dropped. Invalid pointers are skipped and reported as
+// FAEB_ERROR_INVALID once the valid ones are freed.
+void faeb_memory_free_batch(faeb_memory_t* memory, void** ptrs, size_t count) {
+    if (!memory || !ptrs) return;
+    
+    faeb_result_t result = FAEB_SUCCESS;
+    size_t released = 0;
+    uint64_t freed = 0;
+    
+    if (memory->kind == FAEB_MEMORY_ARENA) {
+        for (size_t i = 0; i < count; i++) {
+            if (!ptrs[i]) continue;
+            arena_free(memory, ptrs[i]);
+            if (memory_last_error == FAEB_SUCCESS) {
+                freed++;
+            } else {
+                result = memory_last_error;
+            }
+        }
+    } else {
+        struct faeb_memory_tcache* cache =
+            memory->kind == FAEB_MEMORY_SLAB ? thread_cache(memory) : NULL;
+        struct faeb_memory_block* dead = NULL;
+        bool locked = false;
+        
+        for (size_t i = 0; i < count; i++) {
+            void* ptr = ptrs[i];
+            if (!ptr) continue;
+            
+            struct faeb_memory_slab* slab = memory->kind == FAEB_MEMORY_SLAB ?
+                                            slab_lookup(memory, ptr) : NULL;
+            if (slab) {
+                if (!slab_object_valid(slab, ptr) ||
+                    !slab_object_mark(ptr, false)) {
+                    result = FAEB_ERROR_INVALID;
+                    continue;
+                }
+                size_t object_size = slab_class_sizes[slab->class_index];
+                
+                struct faeb_memory_magazine* magazine =
+                    cache ? &cache->magazines[slab->class_index] : NULL;
+                if (magazine && magazine->count < FAEB_MAGAZINE_SIZE) {
+                    magazine->objects[magazine->count++] = ptr;
+                } else {
+                    if (!locked) {
+                        pthread_mutex_lock(&memory->lock);
+                        locked = true;
+                    }
+                    slab_put(memory, ptr);
+                }
+                released += object_size;
+                freed++;
+                continue;
+            }
+            
+            if (!locked) {
+                pthread_mutex_lock(&memory->lock);
+                locked = true;
+            }
+            uintptr_t key = payload_block(ptr);
+            if (!index_remove(&memory->index, key)) {
+                result = FAEB_ERROR_INVALID;
+                continue;
+            }
+            struct faeb_memory_block* block = (struct faeb_memory_block*)key;
+            heap_unlink(memory, block);
+            block->next = dead;
+            dead = block;
+            released += block->size;
+            freed++;
+        }
+        
+        if (locked) {
+            pthread_mutex_unlock(&memory->lock);
+        }
+        while (dead) {
+            struct faeb_memory_block* next = dead->next;
+            free(block_base(dead));
+            dead = next;
+        }
+        budget_release(memory, released);
+    }
+    
+    struct faeb_memory_counters* counters = thread_counters(memory);
+    counter_add(counters, &counters->frees, freed);
+    memory_last_error = result;
+}
+
+// Allocate a new block, copy the surviving prefix and free the old one
+static void* memory_move(faeb_memory_t* memory, void* ptr, size_t old_size,
+                         size_t new_size, size_t alignment) {
+    void* moved = memory_allocate(memory, new_size, alignment);
+    if (!moved) {
+        return NULL;
+    }
+    memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+    faeb_memory_free(memory, ptr);
+    memory_last_error = FAEB_SUCCESS;
+    return moved;
+}
+
+// Shrink a heap block in place by trimming its recorded size; grow it
+// through libc realloc, which extends in place when the chunk allows.
+// Over-aligned blocks always move to grow, since realloc only keeps
+// FAEB_MEMORY_ALIGN.
+static void* heap_reallocate(faeb_memory_t* memory, void* ptr,
+                             size_t new_size) {
+    uintptr_t key = payload_block(ptr);
+    
+    pthread_mutex_lock(&memory->lock);
+    if (!index_contains(&memory->index, key)) {
+        pthread_mutex_unlock(&memory->lock);
+        memory_last_error = FAEB_ERROR_INVALID;
+        return NULL;
+    }
+    struct faeb_memory_block* block = (struct faeb_memory_block*)key;
+    size_t old_size = block->size;
+    if (new_size <= old_size) {
+        block->size = new_size;
+        pthread_mutex_unlock(&memory->lock);
+        budget_release(memory, old_size - new_size);
+        memory_last_error = FAEB_SUCCESS;
+        return ptr;
+    }
+    if (block->alignment > FAEB_MEMORY_ALIGN) {
+        size_t alignment = block->alignment;
+        pthread_mutex_unlock(&memory->lock);
+        return memory_move(memory, ptr, old_size, new_size, alignment);
+    }
+    
+    if (!budget_reserve(memory, new_size - old_size)) {
+        pthread_mutex_unlock(&memory->lock);
+        memory_last_error = FAEB_ERROR_LIMIT;
+        return NULL;
+    }
+    
+    struct faeb_memory_block* resized = NULL;
+    heap_unlink(memory, block);
+    if (new_size <= SIZE_MAX - FAEB_MEMORY_HEADER_SIZE &&
+        index_reserve(&memory->index, 1)) {
+        resized = realloc(block, FAEB_MEMORY_HEADER_SIZE + new_size);
+    }
+    if (!resized) {
+        heap_link(memory, block);
+        pthread_mutex_unlock(&memory->lock);
+        budget_release(memory, new_size - old_size);
+        memory_last_error = FAEB_ERROR_MEMORY;
+        return NULL;
+    }
+    index_remove(&memory->index, key);
+    index_insert(&memory->index, (uintptr_t)resized);
+    resized->size = new_size;
+    heap_link(memory, resized);
+    pthread_mutex_unlock(&memory->lock);
+    
+    memory_last_error = FAEB_SUCCESS;
+    return block_payload(resized);
+}
+
+// Grow or shrink the arena tail in place; other blocks shrink in place
+// and move to the tail to grow, since the next block follows them
+static void* arena_reallocate(faeb_memory_t* memory, void* ptr,
+                              size_t new_size) {
+    char* p = ptr;
+    
+    pthread_mutex_lock(&memory->lock);
+    size_t used = atomic_load_explicit(&memory->used_size,
+                                       memory_order_relaxed);
+    struct faeb_memory_extent* extent = NULL;
+    if (p >= memory->region && p < memory->region + used) {
+        extent = extents_find(&memory->arena_blocks, (size_t)(p - memory->region));
+    }
+    if (!extent) {
+        pthread_mutex_unlock(&memory->lock);
+        memory_last_error = FAEB_ERROR_INVALID;
+        return NULL;
+    }
+    
+    size_t offset = extent->offset;
+    size_t old_size = extent->size;
+    if (offset == memory->arena_last) {
+        if (new_size > memory->total_size - offset) {
+            pthread_mutex_unlock(&memory->lock);
+            memory_last_error = FAEB_ERROR_LIMIT;
+            return NULL;
+        }
+        extent->size = new_size;
+        atomic_store_explicit(&memory->used_size, offset + new_size,
+                              memory_order_relaxed);
+        if (offset + new_size > memory->arena_high) {
+            memory->arena_high = offset + new_size;
+        }
+        pthread_mutex_unlock(&memory->lock);
+        peak_update(memory, offset + new_size);
+        memory_last_error = FAEB_SUCCESS;
+        return ptr;
+    }
+    if (new_size <= old_size) {
+        extent->size = new_size;
+    }
+    pthread_mutex_unlock(&memory->lock);
+    
+    if (new_size <= old_size) {
+        memory_last_error = FAEB_SUCCESS;
+        return ptr;
+    }
+    return memory_move(memory, ptr, old_size, new_size, FAEB_MEMORY_ALIGN);
+}
+
+// Resize memory block, in place when the engine allows, otherwise by
+// moving it. On failure the original block is left untouched.
+void* faeb_memory_reallocate(faeb_memory_t* memory, void* ptr,
+                             size_t new_size) {
+    if (!memory || new_size == 0) {
+        memory_last_error = FAEB_ERROR_INVALID;
+        return NULL;
+    }
+    if (!ptr) {
+        return faeb_memory_allocate(memory, new_size);
+    }
+    
+    void* resized;
+    switch (memory->kind) {
+        case FAEB_MEMORY_ARENA:
+            resized = arena_reallocate(memory, ptr, new_size);
+            break;
+        case FAEB_MEMORY_SLAB: {
+            struct faeb_memory_slab* slab = slab_lookup(memory, ptr);
+            if (!slab) {
+                resized = heap_reallocate(memory, ptr, new_size);
+                break;
+            }
+            // Freed and misaligned objects are refused, as heap_reallocate
+            // refuses blocks the index does not hold
+            if (!slab_object_valid(slab, ptr) || !slab_object_allocated(ptr)) {
+                memory_last_error = FAEB_ERROR_INVALID;
+                resized = NULL;
+                break;
+            }
+            size_t object_size = slab_class_sizes[slab->class_index];
+            if (new_size <= object_size) {
+                memory_last_error = FAEB_SUCCESS;
+                resized = ptr;
+                break;
+            }
+            resized = memory_move(memory, ptr, object_size, new_size,
+                                  FAEB_MEMORY_ALIGN);
+            break;
+        }
+        default:
+            resized = heap_reallocate(memory, ptr, new_size);
+            break;
+    }
+    
+    // Moves are additionally counted as one allocation and one free
+    struct faeb_memory_counters* counters = thread_counters(memory);
+    if (resized) {
+        counter_add(counters, &counters->reallocations, 1);
+    } else if (memory_last_error == FAEB_ERROR_LIMIT) {
+        counter_add(counters, &counters->limit_hits, 1);
+    }
+    return resized;
+}
+
+// Release every allocation at once; O(1) for arenas. No other thread may
+// be using the manager.
+faeb_result_t faeb_memory_reset(faeb_memory_t* memory) {
+    if (!memory) return FAEB_ERROR_INVALID;
+    
+    pthread_mutex_lock(&memory->lock);
+    heap_release_all(memory);
+    slab_release_all(memory);
+    atomic_store_explicit(&memory->used_size, 0, memory_order_relaxed);
+    memory->arena_last = 0;
+    memory->arena_blocks.count = 0;
+    pthread_mutex_unlock(&memory->lock);
+    
+    memory_last_error = FAEB_SUCCESS;
+    return FAEB_SUCCESS;
+}
+
+// Return idle pages of a mapped region to the OS. Arenas drop everything
+// above the live bump offset; slab managers drop pages of released slabs.
+faeb_result_t faeb_memory_trim(faeb_memory_t* memory) {
+    if (!memory) return FAEB_ERROR_INVALID;
+    if (memory->region_size == 0) return FAEB_SUCCESS;
+    
+    faeb_result_t result = FAEB_SUCCESS;
+    pthread_mutex_lock(&memory->lock);
+    
+    if (memory->kind == FAEB_MEMORY_ARENA) {
+        size_t used = atomic_load_explicit(&memory->used_size,
+                                           memory_order_relaxed);
+        size_t start = align_up(used, memory->page_size);
+        size_t end = align_up(memory->arena_high, memory->page_size);
+        if (end > memory->region_size) end = memory->region_size;
+        if (start < end) {
+            if (madvise(memory->region + start, end - start,
+                        MADV_DONTNEED) != 0) {
+                result = FAEB_ERROR_MEMORY;
+            }
+        }
+        memory->arena_high = used;
+    } else {
+        for (size_t i = 0; i < memory->free_page_count; i++) {
+            char* page = memory->region +
+                         (size_t)memory->free_pages[i] * FAEB_SLAB_SIZE;
+            if (madvise(page, FAEB_SLAB_SIZE, MADV_DONTNEED) != 0) {
+                result = FAEB_ERROR_MEMORY;
+            }
+        }
+    }
+    
+    pthread_mutex_unlock(&memory->lock);
+    memory_last_error = result;
+    return result;
+}
+
+// Page size backing the manager's region
+size_t faeb_memory_get_page_size(faeb_memory_t* memory) {
+    return memory ? memory->page_size : 0;
+}
+
+// Report per size class slab occupancy. The calling thread's magazines are
+// drained first; objects parked in other threads' caches count as in use.
+size_t faeb_memory_get_class_stats(faeb_memory_t* memory,
+                                   faeb_memory_class_stats_t* stats,
+                                   size_t count) {
+    if (!memory || memory->kind != FAEB_MEMORY_SLAB) return 0;
+    if (!stats) return FAEB_MEMORY_SLAB_CLASSES;
+    
+    struct faeb_memory_tcache* cache = thread_cache(memory);
+    
+    pthread_mutex_lock(&memory->lock);
+    if (cache) {
+        for (size_t i = 0; i < FAEB_MEMORY_SLAB_CLASSES; i++) {
+            struct faeb_memory_magazine* magazine = &cache->magazines[i];
+            while (magazine->count > 0) {
+                slab_put(memory, magazine->objects[--magazine->count]);
+            }
+        }
+    }
+    
+    size_t n = count < FAEB_MEMORY_SLAB_CLASSES ? count : FAEB_MEMORY_SLAB_CLASSES;
+    for (size_t i = 0; i < n; i++) {
+        size_t object_size = slab_class_sizes[i];
+        stats[i].object_size = object_size;
+        stats[i].slabs = memory->classes[i].slabs;
+        stats[i].objects_in_use = memory->classes[i].in_use;
+        stats[i].objects_capacity = memory->classes[i].slabs *
+            ((FAEB_SLAB_SIZE - FAEB_SLAB_HEADER_SIZE) / object_size);
+    }
+    pthread_mutex_unlock(&memory->lock);
+    
+    return n;
+}
+
+static void counters_accumulate(faeb_memory_stats_t* stats,
+                                struct faeb_memory_counters* counters) {
+    stats->allocations += atomic_load_explicit(&counters->allocations,
+                                               memory_order_relaxed);
+    stats->frees += atomic_load_explicit(&counters->frees,
+                                         memory_order_relaxed);
+    stats->reallocations += atomic_load_explicit(&counters->reallocations,
+                                                 memory_order_relaxed);
+    stats->limit_hits += atomic_load_explicit(&counters->limit_hits,
+                                              memory_order_relaxed);
+    for (size_t i = 0; i < FAEB_MEMORY_HISTOGRAM_BUCKETS; i++) {
+        stats->size_histogram[i] +=
+            atomic_load_explicit(&counters->histogram[i],
+                                 memory_order_relaxed);
+    }
+}
+
+// Snapshot allocation telemetry. Counters are summed across threads
+// without stopping them, so a concurrent snapshot is approximate.
+faeb_result_t faeb_memory_get_stats(faeb_memory_t* memory,
+                                    faeb_memory_stats_t* stats) {
+    if (!memory || !stats) return FAEB_ERROR_INVALID;
+    
+    memset(stats, 0, sizeof(*stats));
+    counters_accumulate(stats, &memory->shared_counters);
+    for (size_t t = 0; t < FAEB_MEMORY_MAX_THREADS; t++) {
+        struct faeb_memory_tcache* cache =
+            atomic_load_explicit(&memory->tcaches[t], memory_order_acquire);
+        if (cache) {
+            counters_accumulate(stats, &cache->counters);
+        }
+    }
+    
+    stats->total_size = memory->total_size;
+    stats->numa_node = memory->numa_node;
+    stats->bytes_live = atomic_load_explicit(&memory->used_size,
+                                             memory_order_relaxed);
+    stats->bytes_peak = atomic_load_explicit(&memory->peak_size,
+                                             memory_order_relaxed);
+    stats->uptime_ns = monotonic_ns() - memory->created_ns;
+    
+    double seconds = (double)stats->uptime_ns / 1e9;
+    if (seconds > 0.0) {
+        stats->allocations_per_second = (double)stats->allocations / seconds;
+        stats->frees_per_second = (double)stats->frees / seconds;
+    }
+    
+    return FAEB_SUCCESS;
+}
+
+// Start sampling the call stack of one in every sample_rate allocations;
+// a rate of 0 stops the profiler and keeps the samples taken so far
+faeb_result_t faeb_memory_profile_start(faeb_memory_t* memory,
+                                        uint32_t sample_rate) {
+    if (!memory) return FAEB_ERROR_INVALID;
+    
+    pthread_mutex_lock(&memory->lock);
+    if (sample_rate != 0 && !memory->profile.samples) {
+        memory->profile.samples = calloc(FAEB_MEMORY_PROFILE_SAMPLES,
+                                         sizeof(faeb_memory_sample_t));
+        if (!memory->profile.samples) {
+            pthread_mutex_unlock(&memory->lock);
+            return FAEB_ERROR_MEMORY;
+        }
+        memory->profile.next = 0;
+        memory->profile.recorded = 0;
+    }
+    atomic_store_explicit(&memory->profile.sample_rate, sample_rate,
+                          memory_order_relaxed);
+    pthread_mutex_unlock(&memory->lock);
+    
+    return FAEB_SUCCESS;
+}
+
+// Copy out the most recent samples, oldest first
+size_t faeb_memory_profile_read(faeb_memory_t* memory,
+                                faeb_memory_sample_t* samples, size_t count) {
+    if (!memory || !samples) return 0;
+    
+    pthread_mutex_lock(&memory->lock);
+    size_t available = memory->profile.recorded < FAEB_MEMORY_PROFILE_SAMPLES ?
+                       memory->profile.recorded : FAEB_MEMORY_PROFILE_SAMPLES;
+    size_t n = count < available ? count : available;
+    size_t start = (memory->profile.next + FAEB_MEMORY_PROFILE_SAMPLES - n) %
+                   FAEB_MEMORY_PROFILE_SAMPLES;
+    for (size_t i = 0; i < n; i++) {
+        samples[i] = memory->profile.samples[(start + i) %
+                                             FAEB_MEMORY_PROFILE_SAMPLES];
+    }
+    pthread_mutex_unlock(&memory->lock);
+    
+    return n;
+}
+
+// Get the calling thread's last memory error
+faeb_result_t faeb_memory_get_last_error(faeb_memory_t* memory) {
+    return memory ? memory_last_error : FAEB_ERROR_INVALID;
 }
 
 // Memory safety verification
@@ -0,0 +1,313 @@
+/* faeb Core Runtime - Parallel Loops and Task Graphs
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#include "internal.h"
+#include <stdlib.h>
+#include <stdatomic.h>
+
+// Both executors run their work as detached processes on the worker
+// pool and tell the caller through a latch when the last piece is done.
+
+#define FAEB_PARALLEL_GRAIN_SHARE 256   // Default grain: range / (participants * this)
+
+// One-shot completion that a process parks on and a plain thread blocks on
+struct parallel_latch {
+    pthread_mutex_t lock;
+    pthread_cond_t opened;
+    faeb_wait_queue_t waiters;
+    bool open;
+};
+
+static void latch_init(struct parallel_latch* latch) {
+    pthread_mutex_init(&latch->lock, NULL);
+    pthread_cond_init(&latch->opened, NULL);
+    latch->waiters = (faeb_wait_queue_t){ 0 };
+    latch->open = false;
+}
+
+static void latch_destroy(struct parallel_latch* latch) {
+    pthread_cond_destroy(&latch->opened);
+    pthread_mutex_destroy(&latch->lock);
+}
+
+// The waiter may free the latch as soon as the lock is dropped
+static void latch_open(struct parallel_latch* latch) {
+    pthread_mutex_lock(&latch->lock);
+    latch->open = true;
+    struct faeb_process* process;
+    while ((process = wait_queue_pop(&latch->waiters)) != NULL) {
+        faeb_process_wake(process);
+    }
+    pthread_cond_broadcast(&latch->opened);
+    pthread_mutex_unlock(&latch->lock);
+}
+
+static void latch_wait(struct parallel_latch* latch) {
+    pthread_mutex_lock(&latch->lock);
+    while (!latch->open) {
+        if (faeb_process_self()) {
+            faeb_process_park(&latch->waiters, &latch->lock);
+            pthread_mutex_lock(&latch->lock);
+        } else {
+            pthread_cond_wait(&latch->opened, &latch->lock);
+        }
+    }
+    pthread_mutex_unlock(&latch->lock);
+}
+
+struct parallel_loop {
+    _Alignas(FAEB_CACHE_LINE_SIZE) _Atomic size_t next;
+    _Alignas(FAEB_CACHE_LINE_SIZE) _Atomic size_t active;   // Participants still working
+    size_t end;
+    size_t grain;
+    size_t divisor;
+    faeb_parallel_fn body;
+    void* context;
+    struct parallel_latch done;
+};
+
+// Claim the next chunk: a 1/divisor share of what is left, at least grain
+static bool loop_claim(struct parallel_loop* loop, size_t* begin, size_t* end) {
+    size_t next = atomic_load_explicit(&loop->next, memory_order_relaxed);
+    for (;;) {
+        if (next >= loop->end) return false;
+        
+        size_t left = loop->end - next;
+        size_t chunk = left / loop->divisor;
+        if (chunk < loop->grain) chunk = loop->grain;
+        if (chunk > left) chunk = left;
+        if (atomic_compare_exchange_weak_explicit(&loop->next, &next, next + chunk,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+            *begin = next;
+            *end = next + chunk;
+            return true;
+        }
+    }
+}
+
+// Work until the range is drained; the last participant out opens the latch
+static void loop_work(struct parallel_loop* loop) {
+    size_t begin, end;
+    while (loop_claim(loop, &begin, &end)) {
+        loop->body(loop->context, begin, end);
+    }
+    if (atomic_fetch_sub_explicit(&loop->active, 1, memory_order_acq_rel) == 1) {
+        latch_open(&loop->done);
+    }
+}
+
+static void loop_helper(void* context) {
+    loop_work(context);
+}
+
+faeb_result_t faeb_parallel_for(size_t begin, size_t end, size_t grain,
+                                faeb_parallel_fn body, void* context) {
+    if (!body || end < begin) return FAEB_ERROR_INVALID;
+    if (begin == end) return FAEB_SUCCESS;
+    
+    // The caller takes chunks too, alongside one helper per worker; a
+    // caller that is itself a worker counts as one of them
+    size_t workers = (size_t)faeb_scheduler_get_worker_count();
+    size_t participants = workers + (faeb_scheduler_on_worker() ? 0 : 1);
+    size_t range = end - begin;
+    if (grain == 0) {
+        grain = range / (participants * FAEB_PARALLEL_GRAIN_SHARE);
+        if (grain == 0) grain = 1;
+    }
+    if (workers == 0 || range <= grain) {
+        body(context, begin, end);
+        return FAEB_SUCCESS;
+    }
+    
+    size_t helpers = participants - 1;
+    size_t chunks = (range + grain - 1) / grain;
+    if (helpers > chunks - 1) helpers = chunks - 1;
+    
+    struct parallel_loop loop = {
+        .end = end, .grain = grain, .divisor = 2 * participants,
+        .body = body, .context = context
+    };
+    atomic_init(&loop.next, begin);
+    atomic_init(&loop.active, 1 + helpers);
+    latch_init(&loop.done);
+    
+    // A helper that cannot be started is simply not waited for
+    for (size_t i = 0; i < helpers; i++) {
+        if (faeb_scheduler_spawn(loop_helper, &loop) != FAEB_SUCCESS) {
+            atomic_fetch_sub_explicit(&loop.active, 1, memory_order_relaxed);
+        }
+    }
+    loop_work(&loop);
+    latch_wait(&loop.done);
+    latch_destroy(&loop.done);
+    return FAEB_SUCCESS;
+}
+
+struct faeb_graph_task {
+    faeb_process_fn function;
+    void* context;
+    faeb_graph_t* graph;
+    size_t dependencies;
+    size_t* successors;
+    size_t successor_count;
+    size_t successor_capacity;
+    _Atomic size_t pending;    // Dependencies not yet finished in this run
+};
+
+struct faeb_graph {
+    struct faeb_graph_task* tasks;
+    size_t count;
+    size_t capacity;
+    _Atomic bool running;
+    _Atomic size_t remaining;  // Tasks not yet finished in this run
+    struct parallel_latch done;
+};
+
+faeb_graph_t* faeb_graph_create(void) {
+    faeb_graph_t* graph = calloc(1, sizeof(faeb_graph_t));
+    if (!graph) return NULL;
+    
+    atomic_init(&graph->running, false);
+    atomic_init(&graph->remaining, 0);
+    return graph;
+}
+
+// Destroy a graph that is not running
+void faeb_graph_destroy(faeb_graph_t* graph) {
+    if (!graph) return;
+    
+    for (size_t i = 0; i < graph->count; i++) {
+        free(graph->tasks[i].successors);
+    }
+    free(graph->tasks);
+    free(graph);
+}
+
+// Add a task depending on earlier tasks, storing its id in task
+faeb_result_t faeb_graph_add_task(faeb_graph_t* graph, faeb_process_fn function, void* context,
+                                  const size_t* dependencies, size_t count, size_t* task) {
+    if (!graph || !function || (count > 0 && !dependencies) ||
+        atomic_load_explicit(&graph->running, memory_order_relaxed)) {
+        return FAEB_ERROR_INVALID;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (dependencies[i] >= graph->count) return FAEB_ERROR_INVALID;
+    }
+    
+    if (graph->count == graph->capacity) {
+        size_t capacity = graph->capacity ? graph->capacity * 2 : 16;
+        struct faeb_graph_task* tasks = realloc(graph->tasks, capacity * sizeof(*tasks));
+        if (!tasks) return FAEB_ERROR_MEMORY;
+        graph->tasks = tasks;
+        graph->capacity = capacity;
+    }
+    
+    // Make room in every dependency's successor list before changing any
+    size_t id = graph->count;
+    for (size_t i = 0; i < count; i++) {
+        struct faeb_graph_task* dependency = &graph->tasks[dependencies[i]];
+        size_t needed = dependency->successor_count + count;
+        if (needed > dependency->successor_capacity) {
+            size_t capacity = dependency->successor_capacity ? dependency->successor_capacity : 4;
+            while (capacity < needed) capacity *= 2;
+            size_t* successors = realloc(dependency->successors, capacity * sizeof(size_t));
+            if (!successors) return FAEB_ERROR_MEMORY;
+            dependency->successors = successors;
+            dependency->successor_capacity = capacity;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        struct faeb_graph_task* dependency = &graph->tasks[dependencies[i]];
+        dependency->successors[dependency->successor_count++] = id;
+    }
+    
+    graph->tasks[id] = (struct faeb_graph_task){
+        .function = function, .context = context, .graph = graph, .dependencies = count
+    };
+    atomic_init(&graph->tasks[id].pending, count);
+    graph->count++;
+    if (task) {
+        *task = id;
+    }
+    return FAEB_SUCCESS;
+}
+
+static void graph_task_main(void* context);
+
+// Hand a ready task to the workers, or run it here when none can be had
+static void graph_dispatch(struct faeb_graph_task* task) {
+    if (faeb_scheduler_spawn(graph_task_main, task) != FAEB_SUCCESS) {
+        graph_task_main(task);
+    }
+}
+
+// Run a task, release its successors and keep going with one of them
+static void graph_task_main(void* context) {
+    struct faeb_graph_task* task = context;
+    faeb_graph_t* graph = task->graph;
+    while (task) {
+        task->function(task->context);
+        
+        struct faeb_graph_task* next = NULL;
+        for (size_t i = 0; i < task->successor_count; i++) {
+            struct faeb_graph_task* successor = &graph->tasks[task->successors[i]];
+            if (atomic_fetch_sub_explicit(&successor->pending, 1, memory_order_acq_rel) != 1) {
+                continue;
+            }
+            if (next) {
+                graph_dispatch(next);
+            }
+            next = successor;
+        }
+        
+        // Successors are out before this task counts as finished
+        if (atomic_fetch_sub_explicit(&graph->remaining, 1, memory_order_acq_rel) == 1) {
+            latch_open(&graph->done);
+        }
+        task = next;
+    }
+}
+
+// Run every task once, in dependency order, and wait for all of them.
+// Running a graph that is already running fails.
+faeb_result_t faeb_graph_run(faeb_graph_t* graph) {
+    if (!graph) return FAEB_ERROR_INVALID;
+    bool idle = false;
+    if (!atomic_compare_exchange_strong(&graph->running, &idle, true)) {
+        return FAEB_ERROR_INVALID;
+    }
+    
+    // Ids are a topological order already
+    if (faeb_scheduler_get_worker_count() == 0) {
+        for (size_t i = 0; i < graph->count; i++) {
+            graph->tasks[i].function(graph->tasks[i].context);
+        }
+        atomic_store(&graph->running, false);
+        return FAEB_SUCCESS;
+    }
+    if (graph->count == 0) {
+        atomic_store(&graph->running, false);
+        return FAEB_SUCCESS;
+    }
+    
+    for (size_t i = 0; i < graph->count; i++) {
+        atomic_store_explicit(&graph->tasks[i].pending, graph->tasks[i].dependencies,
+                              memory_order_relaxed);
+    }
+    atomic_store_explicit(&graph->remaining, graph->count, memory_order_relaxed);
+    latch_init(&graph->done);
+    
+    for (size_t i = 0; i < graph->count; i++) {
+        if (graph->tasks[i].dependencies == 0) {
+            graph_dispatch(&graph->tasks[i]);
+        }
+    }
+    latch_wait(&graph->done);
+    latch_destroy(&graph->done);
+    
+    atomic_store(&graph->running, false);
+    return FAEB_SUCCESS;
+}
@@ -3,129 +3,985 @@
  * License: Apache 2.0
  */
 
-#include "faeb/runtime.h"
+#define _DEFAULT_SOURCE
+
+#include "internal.h"
 #include <stdlib.h>
+#include <stddef.h>
 #include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifndef MAP_STACK
+#define MAP_STACK 0
+#endif
+
+// Destroyed processes with default-size stacks are recycled whole, stack
+// included: first onto a list private to the destroying thread, spilling
+// in batches to a shared list. Each list keeps at most the cache limit.
+#define FAEB_PROCESS_CACHE_LIMIT 256
+#define FAEB_PROCESS_CACHE_BATCH 32
+
+// The running process is per thread so that a yield always returns to
+// the thread that resumed it; likewise the scheduler whose loop the
+// thread is running, if any.
+static _Thread_local struct faeb_process* current_process = NULL;
+static _Thread_local faeb_scheduler_t* running_scheduler = NULL;
+
+// Recycled processes, linked through next
+struct process_cache {
+    struct faeb_process* head;
+    size_t count;
+};
+
+static _Atomic size_t process_cache_limit = FAEB_PROCESS_CACHE_LIMIT;
+static _Thread_local struct process_cache local_cache;
+static _Thread_local bool local_cache_registered = false;
+static pthread_mutex_t shared_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct process_cache shared_cache;
+static pthread_once_t cache_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t cache_key;
 
-// Process state enumeration
-typedef enum {
-    FAEB_PROCESS_READY,
-    FAEB_PROCESS_RUNNING,
-    FAEB_PROCESS_BLOCKED,
-    FAEB_PROCESS_TERMINATED
-} faeb_process_state_t;
-
-// Process structure
-struct faeb_process {
-    faeb_process_fn function;
-    void* context;
-    faeb_process_state_t state;
-    struct faeb_process* next;
-    int priority;
+// Scheduling totals, one block per thread and scheduler so that every
+// counter has a single writer and a scheduler sums only its own. Blocks
+// are never freed: one released by an exiting thread, or dropped from a
+// thread's cache, keeps its totals for the next thread running the same
+// scheduler; the blocks of a destroyed scheduler are wiped for any.
+#define FAEB_COUNTERS_CACHE 4
+#define FAEB_COUNTERS_UNOWNED UINT64_MAX
+
+struct process_counters {
+    struct process_counters* next;
+    _Atomic bool in_use;
+    _Atomic uint64_t scheduler;    // Id of the scheduler counted
+    _Atomic uint64_t runtime_ns;
+    _Atomic uint64_t runs;
+    _Atomic uint64_t switches;
+    _Atomic uint64_t blocks;
+    _Atomic uint64_t delays[FAEB_SCHEDULER_DELAY_BUCKETS];
+};
+
+// Blocks held by this thread, direct-mapped by scheduler id
+struct counters_cache {
+    uint64_t ids[FAEB_COUNTERS_CACHE];
+    struct process_counters* blocks[FAEB_COUNTERS_CACHE];
 };
 
-// Global process scheduler state
-static struct faeb_process* process_queue = NULL;
-static struct faeb_process* current_process = NULL;
+static _Atomic(struct process_counters*) counters_registry = NULL;
+static _Thread_local struct counters_cache local_counters;
+static pthread_once_t counters_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t counters_key;
+
+// End of the thread's last switch, which starts the next one
+static _Thread_local uint64_t switch_clock_ns = 0;
+
+#if defined(FAEB_CONTEXT_ASM)
+// context_switch(save, load) pushes the callee-saved registers, stores the
+// stack pointer to *save, adopts load as the stack and pops the registers
+// saved there. A fresh stack is laid out so that the final return lands
+// in context_start, which calls entry(process) from the saved registers.
+void context_switch(void** save, void* load);
+void context_start(void);
+
+#if defined(__x86_64__)
+__asm__(
+    ".text\n"
+    ".p2align 4\n"
+    ".type context_switch, @function\n"
+    "context_switch:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size context_switch, .-context_switch\n"
+    ".type context_start, @function\n"
+    "context_start:\n"
+    "    movq %r12, %rdi\n"
+    "    callq *%r13\n"
+    "    ud2\n"
+    ".size context_start, .-context_start\n"
+);
+
+#define FAEB_CONTEXT_FRAME 8    // Words popped by context_switch, incl. return
+#define FAEB_CONTEXT_ARG 4      // r12
+#define FAEB_CONTEXT_ENTRY 3    // r13
+#define FAEB_CONTEXT_PAD 2      // Keeps the entry call 16-byte aligned
+#else
+__asm__(
+    ".text\n"
+    ".p2align 4\n"
+    ".type context_switch, %function\n"
+    "context_switch:\n"
+    "    sub sp, sp, #160\n"
+    "    stp x19, x20, [sp, #0]\n"
+    "    stp x21, x22, [sp, #16]\n"
+    "    stp x23, x24, [sp, #32]\n"
+    "    stp x25, x26, [sp, #48]\n"
+    "    stp x27, x28, [sp, #64]\n"
+    "    stp x29, x30, [sp, #80]\n"
+    "    stp d8, d9, [sp, #96]\n"
+    "    stp d10, d11, [sp, #112]\n"
+    "    stp d12, d13, [sp, #128]\n"
+    "    stp d14, d15, [sp, #144]\n"
+    "    mov x9, sp\n"
+    "    str x9, [x0]\n"
+    "    mov sp, x1\n"
+    "    ldp x19, x20, [sp, #0]\n"
+    "    ldp x21, x22, [sp, #16]\n"
+    "    ldp x23, x24, [sp, #32]\n"
+    "    ldp x25, x26, [sp, #48]\n"
+    "    ldp x27, x28, [sp, #64]\n"
+    "    ldp x29, x30, [sp, #80]\n"
+    "    ldp d8, d9, [sp, #96]\n"
+    "    ldp d10, d11, [sp, #112]\n"
+    "    ldp d12, d13, [sp, #128]\n"
+    "    ldp d14, d15, [sp, #144]\n"
+    "    add sp, sp, #160\n"
+    "    ret\n"
+    ".size context_switch, .-context_switch\n"
+    ".type context_start, %function\n"
+    "context_start:\n"
+    "    mov x0, x19\n"
+    "    blr x20\n"
+    "    brk #0\n"
+    ".size context_start, .-context_start\n"
+);
+
+#define FAEB_CONTEXT_FRAME 20   // 160 bytes of registers
+#define FAEB_CONTEXT_ARG 0      // x19
+#define FAEB_CONTEXT_ENTRY 1    // x20
+#define FAEB_CONTEXT_PAD 0
+#endif
+#endif
+
+static void process_entry(struct faeb_process* process);
+
+// Switch from the running context to another, saving the current one
+static inline void process_switch(faeb_context_t* save, faeb_context_t* load) {
+#if defined(FAEB_CONTEXT_ASM)
+    context_switch(&save->stack_pointer, load->stack_pointer);
+#else
+    swapcontext(save, load);
+#endif
+}
+
+#if !defined(FAEB_CONTEXT_ASM)
+// makecontext only passes int arguments, so the pointer travels in halves
+static void process_entry_ucontext(unsigned int high, unsigned int low) {
+    uintptr_t bits = ((uintptr_t)high << 16 << 16) | (uintptr_t)low;
+    process_entry((struct faeb_process*)bits);
+}
+#endif
+
+// Prepare a fresh context that enters process_entry on the process stack
+static bool process_context_init(struct faeb_process* process) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char* low = process->stack + page;
+    char* top = process->stack + process->stack_size;
+    
+#if defined(FAEB_CONTEXT_ASM)
+    (void)low;
+    uintptr_t* frame = (uintptr_t*)((uintptr_t)top & ~(uintptr_t)15);
+    frame -= FAEB_CONTEXT_FRAME + FAEB_CONTEXT_PAD;
+    for (size_t i = 0; i < FAEB_CONTEXT_FRAME; i++) {
+        frame[i] = 0;
+    }
+#if defined(__x86_64__)
+    frame[0] = ((uintptr_t)0x037f << 32) | 0x1f80;  // Default FPU control, MXCSR
+    frame[FAEB_CONTEXT_FRAME - 1] = (uintptr_t)context_start;
+#else
+    frame[11] = (uintptr_t)context_start;         // x30
+#endif
+    frame[FAEB_CONTEXT_ARG] = (uintptr_t)process;
+    frame[FAEB_CONTEXT_ENTRY] = (uintptr_t)process_entry;
+    process->machine.stack_pointer = frame;
+    return true;
+#else
+    if (getcontext(&process->machine) != 0) {
+        return false;
+    }
+    process->machine.uc_stack.ss_sp = low;
+    process->machine.uc_stack.ss_size = (size_t)(top - low);
+    process->machine.uc_link = NULL;
+    uintptr_t bits = (uintptr_t)process;
+    makecontext(&process->machine, (void (*)(void))process_entry_ucontext, 2,
+                (unsigned int)(bits >> 16 >> 16), (unsigned int)bits);
+    return true;
+#endif
+}
+
+// Map a stack with a PROT_NONE guard page below it
+static char* stack_allocate(size_t mapping_size) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    
+    void* mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK,
+                         -1, 0);
+    if (mapping == MAP_FAILED) return NULL;
+    
+    if (mprotect(mapping, page, PROT_NONE) != 0) {
+        munmap(mapping, mapping_size);
+        return NULL;
+    }
+    
+    return mapping;
+}
+
+// Unmap the stack and free the process for good
+static void process_free(struct faeb_process* process) {
+    munmap(process->stack, process->stack_size);
+    free(process);
+}
+
+// Move up to count processes from the head of one cache to another
+static void cache_move(struct process_cache* from, struct process_cache* to, size_t count) {
+    while (count-- > 0 && from->head) {
+        struct faeb_process* process = from->head;
+        from->head = process->next;
+        from->count--;
+        process->next = to->head;
+        to->head = process;
+        to->count++;
+    }
+}
+
+// Keep what fits on the shared list and free the rest
+static void cache_spill(struct process_cache* spill) {
+    size_t limit = atomic_load_explicit(&process_cache_limit, memory_order_relaxed);
+    
+    pthread_mutex_lock(&shared_cache_lock);
+    if (shared_cache.count < limit) {
+        cache_move(spill, &shared_cache, limit - shared_cache.count);
+    }
+    pthread_mutex_unlock(&shared_cache_lock);
+    
+    while (spill->head) {
+        struct faeb_process* process = spill->head;
+        spill->head = process->next;
+        spill->count--;
+        process_free(process);
+    }
+}
+
+// A thread's cached processes go to the shared list when it exits
+static void cache_thread_exit(void* arg) {
+    cache_spill(arg);
+}
+
+static void cache_key_create(void) {
+    pthread_key_create(&cache_key, cache_thread_exit);
+}
+
+// Reuse a recycled process: the thread's own list first, then a batch
+// from the shared list
+static struct faeb_process* cache_take(void) {
+    struct process_cache* cache = &local_cache;
+    
+    if (!cache->head) {
+        if (atomic_load_explicit(&process_cache_limit, memory_order_relaxed) == 0) {
+            return NULL;
+        }
+        pthread_mutex_lock(&shared_cache_lock);
+        cache_move(&shared_cache, cache, FAEB_PROCESS_CACHE_BATCH);
+        pthread_mutex_unlock(&shared_cache_lock);
+        if (!cache->head) return NULL;
+    }
+    
+    struct faeb_process* process = cache->head;
+    cache->head = process->next;
+    cache->count--;
+    return process;
+}
+
+// Recycle a destroyed process, or free it when its stack is not the
+// default size or the caches are full
+static void cache_put(struct faeb_process* process) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t limit = atomic_load_explicit(&process_cache_limit, memory_order_relaxed);
+    struct process_cache* cache = &local_cache;
+    
+    if (process->stack_size != FAEB_PROCESS_STACK_SIZE + page || limit == 0) {
+        process_free(process);
+        return;
+    }
+    
+    if (!local_cache_registered) {
+        pthread_once(&cache_key_once, cache_key_create);
+        pthread_setspecific(cache_key, cache);
+        local_cache_registered = true;
+    }
+    if (cache->count >= limit) {
+        struct process_cache spill = { NULL, 0 };
+        cache_move(cache, &spill, cache->count - limit + FAEB_PROCESS_CACHE_BATCH);
+        cache_spill(&spill);
+    }
+    
+    process->next = cache->head;
+    cache->head = process;
+    cache->count++;
+}
+
+static void counters_thread_exit(void* arg) {
+    struct counters_cache* cache = arg;
+    for (size_t i = 0; i < FAEB_COUNTERS_CACHE; i++) {
+        if (cache->blocks[i]) {
+            atomic_store_explicit(&cache->blocks[i]->in_use, false, memory_order_release);
+        }
+    }
+}
+
+static void counters_key_create(void) {
+    pthread_key_create(&counters_key, counters_thread_exit);
+}
+
+static bool counters_try_claim(struct process_counters* counters) {
+    bool expected = false;
+    return atomic_compare_exchange_strong(&counters->in_use, &expected, true);
+}
+
+// Adopt a released block of the scheduler, else a wiped one, else
+// register a new one, and cache it in place of the slot's old block
+static struct process_counters* counters_claim(uint64_t id, size_t slot) {
+    struct process_counters* counters = atomic_load(&counters_registry);
+    for (; counters; counters = counters->next) {
+        if (atomic_load(&counters->scheduler) == id && counters_try_claim(counters)) break;
+    }
+    if (!counters) {
+        for (counters = atomic_load(&counters_registry); counters; counters = counters->next) {
+            if (atomic_load(&counters->scheduler) == FAEB_COUNTERS_UNOWNED &&
+                counters_try_claim(counters)) {
+                atomic_store(&counters->runtime_ns, 0);
+                atomic_store(&counters->runs, 0);
+                atomic_store(&counters->switches, 0);
+                atomic_store(&counters->blocks, 0);
+                for (size_t i = 0; i < FAEB_SCHEDULER_DELAY_BUCKETS; i++) {
+                    atomic_store(&counters->delays[i], 0);
+                }
+                atomic_store(&counters->scheduler, id);
+                break;
+            }
+        }
+    }
+    if (!counters) {
+        counters = calloc(1, sizeof(struct process_counters));
+        if (!counters) return NULL;
+        atomic_init(&counters->in_use, true);
+        atomic_init(&counters->scheduler, id);
+        counters->next = atomic_load(&counters_registry);
+        while (!atomic_compare_exchange_weak(&counters_registry, &counters->next, counters)) {
+        }
+    }
+    
+    struct process_counters* evicted = local_counters.blocks[slot];
+    if (evicted) {
+        atomic_store_explicit(&evicted->in_use, false, memory_order_release);
+    } else {
+        pthread_once(&counters_key_once, counters_key_create);
+        pthread_setspecific(counters_key, &local_counters);
+    }
+    local_counters.ids[slot] = id;
+    local_counters.blocks[slot] = counters;
+    return counters;
+}
+
+// The calling thread's block for the scheduler a process belongs to
+static inline struct process_counters* counters_for(const struct faeb_process* process) {
+    uint64_t id = process->scheduler->id;
+    size_t slot = (size_t)(id % FAEB_COUNTERS_CACHE);
+    struct process_counters* counters = local_counters.blocks[slot];
+    if (counters && local_counters.ids[slot] == id) {
+        return counters;
+    }
+    return counters_claim(id, slot);
+}
+
+// log2 delay bucket, with everything past the last bucket folded into it
+static inline size_t delay_bucket(uint64_t delay) {
+    size_t bucket = (size_t)(63 - __builtin_clzll((unsigned long long)(delay | 1)));
+    return bucket < FAEB_SCHEDULER_DELAY_BUCKETS ? bucket : FAEB_SCHEDULER_DELAY_BUCKETS - 1;
+}
+
+// Count a switch-in and how long the process waited for it
+void faeb_process_account_run(struct faeb_process* process, uint64_t start) {
+    uint64_t delay = start > process->ready_ns ? start - process->ready_ns : 0;
+    size_t bucket = delay_bucket(delay);
+    stat_add(&process->runs, 1);
+    stat_add(&process->delays[bucket], 1);
+    
+    struct process_counters* counters = counters_for(process);
+    if (counters) {
+        stat_add(&counters->runs, 1);
+        stat_add(&counters->delays[bucket], 1);
+    }
+}
+
+// Charge the time switched in and count why the process stopped. One
+// that yielded is ready again from end on.
+void faeb_process_account_stop(struct faeb_process* process, uint64_t start, uint64_t end) {
+    faeb_process_state_t state = process->state;
+    bool blocked = state == FAEB_PROCESS_BLOCKED;
+    bool switched = state != FAEB_PROCESS_TERMINATED;
+    stat_add(&process->runtime_ns, end - start);
+    stat_add(&process->switches, switched);
+    stat_add(&process->blocks, blocked);
+    if (state == FAEB_PROCESS_READY) {
+        process->ready_ns = end;
+    }
+    
+    struct process_counters* counters = counters_for(process);
+    if (counters) {
+        stat_add(&counters->runtime_ns, end - start);
+        stat_add(&counters->switches, switched);
+        stat_add(&counters->blocks, blocked);
+    }
+}
+
+void faeb_process_clock_sync(void) {
+    switch_clock_ns = faeb_timer_now_ns();
+}
+
+// Totals are read without stopping the threads that write them, so a
+// snapshot taken while processes run is approximate
+void faeb_process_accumulate_stats(const faeb_scheduler_t* scheduler,
+                                   faeb_scheduler_stats_t* stats) {
+    struct process_counters* counters = atomic_load(&counters_registry);
+    for (; counters; counters = counters->next) {
+        if (atomic_load_explicit(&counters->scheduler, memory_order_relaxed) != scheduler->id) {
+            continue;
+        }
+        stats->cpu_time_ns += atomic_load_explicit(&counters->runtime_ns, memory_order_relaxed);
+        stats->runs += atomic_load_explicit(&counters->runs, memory_order_relaxed);
+        stats->switches += atomic_load_explicit(&counters->switches, memory_order_relaxed);
+        stats->blocks += atomic_load_explicit(&counters->blocks, memory_order_relaxed);
+        for (size_t i = 0; i < FAEB_SCHEDULER_DELAY_BUCKETS; i++) {
+            stats->delay_histogram[i] +=
+                atomic_load_explicit(&counters->delays[i], memory_order_relaxed);
+        }
+    }
+}
+
+// Scheduler ids are never reused, so blocks still cached by other
+// threads under a destroyed one's id are never written again
+void faeb_process_release_stats(const faeb_scheduler_t* scheduler) {
+    struct process_counters* counters = atomic_load(&counters_registry);
+    for (; counters; counters = counters->next) {
+        uint64_t id = scheduler->id;
+        atomic_compare_exchange_strong(&counters->scheduler, &id, FAEB_COUNTERS_UNOWNED);
+    }
+}
+
+// First code run on a process stack. Returning is impossible, so a
+// finished process switches back to its caller for the last time.
+static void process_entry(struct faeb_process* process) {
+    process->function(process->context);
+    
+    process->state = FAEB_PROCESS_TERMINATED;
+    process_switch(&process->machine, &process->caller);
+    abort();
+}
+
+// Run a process on its own stack until it yields, blocks or finishes.
+// The state is read and the run accounted before a parked process's wait
+// lock is dropped: from then on a waker may already have handed it to
+// another thread. One clock read per switch serves as the end of this
+// run and the start of the next one on the thread.
+faeb_process_state_t faeb_process_resume(struct faeb_process* process) {
+    struct faeb_process* previous = current_process;
+    uint64_t start = switch_clock_ns > process->ready_ns ? switch_clock_ns
+                                                         : process->ready_ns;
+    faeb_process_account_run(process, start);
+    
+    current_process = process;
+    process->state = FAEB_PROCESS_RUNNING;
+    process_switch(&process->caller, &process->machine);
+    current_process = previous;
+    
+    uint64_t end = faeb_timer_now_ns();
+    switch_clock_ns = end;
+    faeb_process_account_stop(process, start, end);
+    
+    faeb_process_state_t state = process->state;
+    if (state == FAEB_PROCESS_BLOCKED && process->wait_lock) {
+        pthread_mutex_unlock(process->wait_lock);
+    }
+    return state;
+}
+
+struct faeb_process* faeb_process_self(void) {
+    return current_process;
+}
+
+faeb_scheduler_t* faeb_scheduler_running(void) {
+    return running_scheduler;
+}
 
 // Create new process
 faeb_process_t* faeb_process_create(faeb_process_fn function, void* context) {
+    return faeb_process_create_config(function, context, NULL);
+}
+
+// Build a process and queue it. Default-size processes come from the
+// recycling caches when they can, so steady-state spawning neither
+// mallocs nor maps.
+static faeb_process_t* process_create(faeb_process_fn function, void* context,
+                                      const faeb_process_config_t* config, bool detached) {
     if (!function) return NULL;
     
-    faeb_process_t* process = malloc(sizeof(faeb_process_t));
-    if (!process) return NULL;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t stack_size = config && config->stack_size ? config->stack_size
+                                                     : FAEB_PROCESS_STACK_SIZE;
+    if (stack_size > SIZE_MAX - 2 * page) return NULL;
+    stack_size = (stack_size + page - 1) & ~(page - 1);
+    
+    faeb_process_t* process = stack_size == FAEB_PROCESS_STACK_SIZE ? cache_take() : NULL;
+    if (!process) {
+        process = malloc(sizeof(faeb_process_t));
+        if (!process) return NULL;
+        process->stack_size = stack_size + page;
+        process->stack = stack_allocate(process->stack_size);
+        if (!process->stack) {
+            free(process);
+            return NULL;
+        }
+    }
     
     process->function = function;
     process->context = context;
     process->state = FAEB_PROCESS_READY;
     process->next = NULL;
-    process->priority = 0; // Default priority
+    process->priority = FAEB_PROCESS_PRIORITY_DEFAULT;
+    process->prev = NULL;
+    process->runqueue = NULL;
+    process->scheduler = faeb_scheduler_current();
+    process->budget_ns = 0;
+    process->relative_deadline_ns = 0;
+    process->period_ns = 0;
+    process->heap = NULL;
+    process->on_workers = false;
+    process->timer.wheel = NULL;
+    process->ready_ns = faeb_timer_now_ns();
+    atomic_store_explicit(&process->runtime_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&process->runs, 0, memory_order_relaxed);
+    atomic_store_explicit(&process->switches, 0, memory_order_relaxed);
+    atomic_store_explicit(&process->blocks, 0, memory_order_relaxed);
+    for (size_t i = 0; i < FAEB_SCHEDULER_DELAY_BUCKETS; i++) {
+        atomic_store_explicit(&process->delays[i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&process->periods, 0, memory_order_relaxed);
+    atomic_store_explicit(&process->deadline_misses, 0, memory_order_relaxed);
+    process->wait_queue = NULL;
+    process->wait_lock = NULL;
+    process->fd_entry = NULL;
+    process->fd_next = NULL;
+    process->fd_prev = NULL;
+    process->io_request = NULL;
+    process->detached = detached;
+    if (!process_context_init(process)) {
+        cache_put(process);
+        return NULL;
+    }
     
-    // Add to process queue
-    if (!process_queue) {
-        process_queue = process;
+    // Spawned on a worker it goes straight to that worker; otherwise to
+    // the tail of its priority level (FIFO within a level)
+    if (faeb_scheduler_on_worker()) {
+        faeb_scheduler_submit(process);
     } else {
-        // Insert at head for simplicity (FIFO scheduling)
-        process->next = process_queue;
-        process_queue = process;
+        scheduler_enqueue(process->scheduler, process);
     }
     
     return process;
 }
 
-// Destroy process
+// Create a process with an explicit configuration; NULL uses the defaults
+faeb_process_t* faeb_process_create_config(faeb_process_fn function, void* context,
+                                           const faeb_process_config_t* config) {
+    return process_create(function, context, config, false);
+}
+
+// Start a detached process: nobody holds on to it, and the scheduler
+// recycles it as soon as it finishes
+faeb_result_t faeb_process_spawn(faeb_process_fn function, void* context) {
+    if (!function) return FAEB_ERROR_INVALID;
+    
+    return process_create(function, context, NULL, true) ? FAEB_SUCCESS : FAEB_ERROR_MEMORY;
+}
+
+// Start a detached process on the worker pool from any thread
+faeb_result_t faeb_scheduler_spawn(faeb_process_fn function, void* context) {
+    if (!function || faeb_scheduler_get_worker_count() == 0) return FAEB_ERROR_INVALID;
+    
+    // Created on a worker it is already queued there, and may be running
+    // or even finished elsewhere by the time process_create returns
+    bool queued = faeb_scheduler_on_worker();
+    struct faeb_process* process = process_create(function, context, NULL, true);
+    if (!process) return FAEB_ERROR_MEMORY;
+    if (!queued && faeb_scheduler_submit(process) != FAEB_SUCCESS) {
+        faeb_process_destroy(process);
+        return FAEB_ERROR_INVALID;
+    }
+    return FAEB_SUCCESS;
+}
+
+// Cap the number of processes kept for reuse by each thread and by the
+// shared list; 0 turns recycling off. Caches above the new limit shrink
+// as they are next used.
+void faeb_process_set_cache_limit(size_t limit) {
+    atomic_store(&process_cache_limit, limit);
+}
+
+// Free every process cached by the calling thread and on the shared list
+void faeb_process_trim_cache(void) {
+    struct process_cache spill = { NULL, 0 };
+    cache_move(&local_cache, &spill, SIZE_MAX);
+    pthread_mutex_lock(&shared_cache_lock);
+    cache_move(&shared_cache, &spill, SIZE_MAX);
+    pthread_mutex_unlock(&shared_cache_lock);
+    
+    while (spill.head) {
+        struct faeb_process* process = spill.head;
+        spill.head = process->next;
+        process_free(process);
+    }
+}
+
+// Destroy process. A suspended process is discarded without unwinding
+// its stack; a process cannot destroy itself while it runs.
 void faeb_process_destroy(faeb_process_t* process) {
-    if (!process) return;
+    if (!process || process == current_process) return;
     
-    // Remove from queue if present
-    if (process == process_queue) {
-        process_queue = process->next;
-    } else {
-        struct faeb_process* current = process_queue;
-        while (current && current->next != process) {
-            current = current->next;
-        }
-        if (current) {
-            current->next = process->next;
+    // Remove from run queue, timer wheel and wait queue if present, and
+    // give back any admitted deadline density. The tick scheduler's
+    // blocked queue has no lock of its own.
+    scheduler_unqueue(process);
+    if (process->period_ns) {
+        faeb_scheduler_admit(process, 0, 0, 0);
+    }
+    if (process->scheduler->current == process) {
+        process->scheduler->current = NULL;
+    }
+    faeb_timer_cancel(&process->timer);
+    if (process->fd_entry) {
+        faeb_reactor_forget(process);
+    }
+    if (process->on_workers) {
+        // Dropped by a worker pool shutdown before it finished
+        atomic_fetch_sub(&process->scheduler->submitted, 1);
+    }
+    pthread_mutex_t* wait_lock = process->wait_lock;
+    if (wait_lock) {
+        pthread_mutex_lock(wait_lock);
+        if (process->wait_queue) {
+            wait_queue_remove(process->wait_queue, process);
         }
+        pthread_mutex_unlock(wait_lock);
+    } else if (process->wait_queue) {
+        wait_queue_remove(process->wait_queue, process);
     }
     
     // Mark as terminated
     process->state = FAEB_PROCESS_TERMINATED;
     
-    // Free process structure
-    free(process);
+    // A request still in flight may write to the stack: the I/O engine
+    // frees the process once it completes. Otherwise recycle the process
+    // with its stack, or free both.
+    if (process->io_request && faeb_io_engine_forget(process)) return;
+    cache_put(process);
 }
 
-// Yield control to next process
+void faeb_process_release(struct faeb_process* process) {
+    process_free(process);
+}
+
+// Yield control: suspend the running process exactly here and switch
+// back to whoever resumed it. Outside of a process this is a no-op.
 void faeb_process_yield(void) {
-    if (!process_queue) return;
+    struct faeb_process* process = current_process;
+    if (!process) return;
     
-    // Simple round-robin scheduling
-    if (current_process && current_process->state == FAEB_PROCESS_RUNNING) {
-        current_process->state = FAEB_PROCESS_READY;
-        
-        // Move current process to end of queue
-        struct faeb_process* current = process_queue;
-        while (current->next) {
-            current = current->next;
-        }
-        current->next = current_process;
-        current_process->next = NULL;
+    process->state = FAEB_PROCESS_READY;
+    process_switch(&process->machine, &process->caller);
+}
+
+// Timer callback for sleeping processes: ready again, back to its queue
+void faeb_process_timer_fire(faeb_timer_wheel_t* wheel, faeb_timer_t* timer) {
+    struct faeb_process* process = (struct faeb_process*)
+        ((char*)timer - offsetof(struct faeb_process, timer));
+    process->state = FAEB_PROCESS_READY;
+    process->ready_ns = faeb_timer_now_ns();
+    wheel->ready(process);
+}
+
+// Park the running process on a wait queue. The lock stays held across
+// the switch and faeb_process_resume releases it on the far side.
+void faeb_process_park(faeb_wait_queue_t* queue, pthread_mutex_t* lock) {
+    struct faeb_process* process = current_process;
+    
+    process->state = FAEB_PROCESS_BLOCKED;
+    process->wait_lock = lock;
+    wait_queue_push(queue, process);
+    process_switch(&process->machine, &process->caller);
+}
+
+// Hand a woken process to a scheduler whose loop runs on another thread
+static void inbox_push(faeb_scheduler_t* scheduler, struct faeb_process* process) {
+    struct faeb_process* head = atomic_load_explicit(&scheduler->inbox, memory_order_relaxed);
+    do {
+        process->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&scheduler->inbox, &head, process,
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+}
+
+// Queue everything handed over by other threads, oldest first
+static void inbox_drain(faeb_scheduler_t* scheduler) {
+    if (!atomic_load_explicit(&scheduler->inbox, memory_order_relaxed)) return;
+    
+    struct faeb_process* process = atomic_exchange_explicit(&scheduler->inbox, NULL,
+                                                            memory_order_acquire);
+    struct faeb_process* oldest = NULL;
+    while (process) {
+        struct faeb_process* next = process->next;
+        process->next = oldest;
+        oldest = process;
+        process = next;
+    }
+    while (oldest) {
+        struct faeb_process* next = oldest->next;
+        scheduler_enqueue(scheduler, oldest);
+        oldest = next;
+    }
+}
+
+// Ready a process taken off a wait queue: worker-pool processes go back
+// to the pool, others to their scheduler's run queue, directly when the
+// waker is running that scheduler and through its inbox otherwise
+void faeb_process_wake(struct faeb_process* process) {
+    process->wait_lock = NULL;
+    process->state = FAEB_PROCESS_READY;
+    process->ready_ns = faeb_timer_now_ns();
+    if (process->on_workers) {
+        faeb_scheduler_wake_worker(process);
+    } else if (process->scheduler == running_scheduler) {
+        scheduler_enqueue(process->scheduler, process);
+    } else {
+        inbox_push(process->scheduler, process);
     }
+}
+
+// Suspend the running process for at least milliseconds. Inside a
+// scheduling loop the process parks on that loop's timer wheel and other
+// processes keep running; anywhere else the calling thread sleeps.
+faeb_result_t faeb_process_sleep(uint64_t milliseconds) {
+    struct faeb_process* process = current_process;
+    faeb_timer_wheel_t* wheel = faeb_timer_get_local();
+    uint64_t deadline = faeb_timer_deadline(milliseconds);
+    
+    if (!process || !wheel) {
+        faeb_timer_sleep_until(deadline);
+        return FAEB_SUCCESS;
+    }
+    
+    process->timer.fire = faeb_process_timer_fire;
+    faeb_timer_arm(wheel, &process->timer, deadline);
+    process->state = FAEB_PROCESS_BLOCKED;
+    process_switch(&process->machine, &process->caller);
     
-    // Select next process
-    if (process_queue) {
-        current_process = process_queue;
-        process_queue = process_queue->next;
-        current_process->next = NULL;
-        current_process->state = FAEB_PROCESS_RUNNING;
+    return FAEB_SUCCESS;
+}
+
+// Schedule a process by deadline, or by priority again when deadline is
+// NULL. Its first job is released now. Fails with FAEB_ERROR_LIMIT when
+// its scheduler cannot admit the extra density; processes on the worker
+// pool have no deadlines.
+faeb_result_t faeb_process_set_deadline(faeb_process_t* process,
+                                        const faeb_process_deadline_t* deadline) {
+    if (!process || process->on_workers) return FAEB_ERROR_INVALID;
+    if (!deadline) return faeb_scheduler_admit(process, 0, 0, 0);
+    
+    uint64_t relative = deadline->deadline_ns ? deadline->deadline_ns : deadline->period_ns;
+    if (deadline->runtime_ns == 0 || deadline->runtime_ns > relative ||
+        relative > deadline->period_ns) {
+        return FAEB_ERROR_INVALID;
     }
+    
+    return faeb_scheduler_admit(process, deadline->runtime_ns, relative, deadline->period_ns);
 }
 
-// Run process
+// End the running process's current job and wait for its next release.
+// A job finishing after its deadline counts as a miss. One that overran
+// into a later period releases the next job at once, moving the period
+// grid to now rather than releasing a burst of late jobs.
+faeb_result_t faeb_process_wait_period(void) {
+    struct faeb_process* process = current_process;
+    if (!process || !process->period_ns) return FAEB_ERROR_INVALID;
+    
+    uint64_t now = faeb_timer_now_ns();
+    stat_add(&process->periods, 1);
+    if (now > process->deadline_ns) {
+        stat_add(&process->deadline_misses, 1);
+        atomic_fetch_add_explicit(&process->scheduler->deadline_misses, 1,
+                                  memory_order_relaxed);
+    }
+    
+    uint64_t release = process->release_ns + process->period_ns;
+    if (release < now) {
+        release = now;
+    }
+    process->release_ns = release;
+    process->deadline_ns = release + process->relative_deadline_ns;
+    
+    // Released already: requeue behind earlier deadlines. Otherwise wait
+    // in the release heap of the loop running it, or sleep the thread.
+    if (release <= now) {
+        faeb_process_yield();
+    } else if (process->scheduler == running_scheduler) {
+        process->state = FAEB_PROCESS_BLOCKED;
+        faeb_deadline_heap_push(&process->scheduler->releases, process, release);
+        process_switch(&process->machine, &process->caller);
+    } else {
+        faeb_timer_sleep_until_ns(release);
+    }
+    
+    return FAEB_SUCCESS;
+}
+
+// Run process until its next yield or until it finishes
 void faeb_process_run(faeb_process_t* process) {
     if (!process || process->state != FAEB_PROCESS_READY) return;
     
-    // Set as current process
-    current_process = process;
-    process->state = FAEB_PROCESS_RUNNING;
+    faeb_process_clock_sync();
+    faeb_process_resume(process);
+}
+
+// Snapshot a process's scheduling statistics. They are kept while it
+// runs and read without stopping it, so may lag by the current run.
+faeb_result_t faeb_process_get_stats(faeb_process_t* process, faeb_process_stats_t* stats) {
+    if (!process || !stats) return FAEB_ERROR_INVALID;
     
-    // Execute process function
-    process->function(process->context);
+    stats->cpu_time_ns = atomic_load_explicit(&process->runtime_ns, memory_order_relaxed);
+    stats->runs = atomic_load_explicit(&process->runs, memory_order_relaxed);
+    stats->switches = atomic_load_explicit(&process->switches, memory_order_relaxed);
+    stats->blocks = atomic_load_explicit(&process->blocks, memory_order_relaxed);
+    stats->periods = atomic_load_explicit(&process->periods, memory_order_relaxed);
+    stats->deadline_misses = atomic_load_explicit(&process->deadline_misses,
+                                                  memory_order_relaxed);
+    for (size_t i = 0; i < FAEB_SCHEDULER_DELAY_BUCKETS; i++) {
+        stats->delay_histogram[i] = atomic_load_explicit(&process->delays[i],
+                                                         memory_order_relaxed);
+    }
+    return FAEB_SUCCESS;
+}
+
+// Whether the process function has returned
+bool faeb_process_is_terminated(faeb_process_t* process) {
+    return process && process->state == FAEB_PROCESS_TERMINATED;
+}
+
+// Change the priority of a process. A queued process moves to the tail
+// of its new level straight away.
+faeb_result_t faeb_process_set_priority(faeb_process_t* process, int priority) {
+    if (!process || priority < 0 || priority >= FAEB_PROCESS_PRIORITIES) {
+        return FAEB_ERROR_INVALID;
+    }
     
-    // Mark as ready for next execution
-    process->state = FAEB_PROCESS_READY;
-    current_process = NULL;
+    process->priority = priority;
+    faeb_runqueue_t* runqueue = process->runqueue;
+    if (runqueue) {
+        runqueue_remove(runqueue, process);
+        runqueue_push(runqueue, process);
+    }
+    
+    return FAEB_SUCCESS;
+}
+
+int faeb_process_get_priority(faeb_process_t* process) {
+    return process ? process->priority : -1;
 }
 
-// Simple process scheduler
+// Simple process scheduler for the calling thread's current scheduler:
+// always resumes the highest-priority ready process, round-robin within
+// a level, until every process has finished or waits on a
+// synchronization object. When only sleepers remain the thread sleeps
+// until the next timer, and while processes wait on I/O or descriptor
+// readiness it sleeps on the I/O engine or the reactor; processes woken
+// from other threads meanwhile run once it is back. Finished processes
+// leave the queue but stay allocated until their owner destroys them.
 void faeb_scheduler_run(void) {
-    while (process_queue) {
-        faeb_process_yield();
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    faeb_scheduler_t* outer_scheduler = running_scheduler;
+    faeb_timer_wheel_t* outer = faeb_timer_get_local();
+    faeb_timer_wheel_t* timers = &scheduler->timers;
+    if (timers->count == 0) {
+        timers->now = faeb_timer_now();
+    }
+    running_scheduler = scheduler;
+    faeb_timer_set_local(timers);
+    faeb_process_clock_sync();
+    
+    for (;;) {
+        inbox_drain(scheduler);
+        if (timers->count) {
+            faeb_timer_advance(timers, faeb_timer_now());
+        }
+        if (scheduler->releases.count) {
+            faeb_scheduler_release(scheduler, switch_clock_ns);
+        }
+        if (scheduler->io) {
+            faeb_io_engine_poll(scheduler->io, switch_clock_ns / FAEB_TIMER_TICK_NS);
+        }
+        if (scheduler->reactor) {
+            faeb_reactor_poll(scheduler->reactor, switch_clock_ns / FAEB_TIMER_TICK_NS);
+        }
         
-        if (current_process && current_process->state == FAEB_PROCESS_RUNNING) {
-            current_process->function(current_process->context);
+        // Nothing to run: sleep to the next timer tick or deadline release,
+        // or until I/O completes or a descriptor becomes ready
+        struct faeb_process* process = scheduler_dequeue(scheduler);
+        if (!process) {
+            uint64_t wake = timers->count ? faeb_timer_next(timers) * FAEB_TIMER_TICK_NS
+                                          : UINT64_MAX;
+            if (scheduler->releases.count && scheduler->releases.entries[0]->heap_key < wake) {
+                wake = scheduler->releases.entries[0]->heap_key;
+            }
+            if (faeb_reactor_waiting(scheduler->reactor)) {
+                faeb_reactor_wait(scheduler->reactor, scheduler->io, wake);
+            } else if (faeb_io_engine_pending(scheduler->io)) {
+                faeb_io_engine_wait(scheduler->io, wake);
+            } else if (wake == UINT64_MAX) {
+                break;
+            } else {
+                faeb_timer_sleep_until_ns(wake);
+            }
+            faeb_process_clock_sync();
+            continue;
+        }
+        
+        faeb_process_state_t state = faeb_process_resume(process);
+        if (state == FAEB_PROCESS_READY) {
+            scheduler_enqueue(scheduler, process);
+        } else if (state == FAEB_PROCESS_TERMINATED && process->detached) {
+            faeb_process_destroy(process);
         }
     }
+    
+    running_scheduler = outer_scheduler;
+    faeb_timer_set_local(outer);
 }
@@ -0,0 +1,439 @@
+/* faeb Core Runtime - Readiness Reactor
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#define _GNU_SOURCE
+#include "internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/epoll.h>
+
+// Every descriptor a scheduler's processes wait on sits in one epoll set,
+// added once, edge-triggered for both directions, and made non-blocking
+// until unregistered. A descriptor closed without unregistering leaves
+// the set on its own, so before parking a wait re-arms the entry and adds
+// a descriptor reusing the number again.
+// An edge wakes every process waiting for that direction; one nobody
+// waited for stays on the descriptor until a wait takes it. The loop
+// collects up to FAEB_REACTOR_EVENTS edges per epoll_wait, once per
+// timer tick while processes run and blocking when none can, and readies
+// all the processes they wake before resuming any. Entries live in fixed
+// pages indexed by descriptor, so their wait queues never move.
+
+#define FAEB_REACTOR_EVENTS 256
+#define FAEB_REACTOR_PAGE 1024
+
+struct faeb_reactor_fd {
+    uint32_t ready;                   // Edges reported and not yet taken
+    bool registered;
+    bool was_blocking;                // O_NONBLOCK set by registering
+    faeb_wait_queue_t waiters;        // Loop processes, parked
+    struct faeb_process* blocked;     // Tick scheduler's, linked through fd_next
+};
+
+// Owned by the thread running its scheduler
+struct faeb_reactor {
+    int epoll_fd;
+    struct faeb_reactor_fd** pages;
+    size_t page_count;
+    size_t waiting;                   // Parked in the loop
+    size_t blocked;                   // On the tick scheduler's blocked queue
+    uint64_t poll_tick;               // Timer tick of the last poll
+    uint64_t polls;
+    uint64_t events;
+};
+
+faeb_reactor_t* faeb_reactor_create(void) {
+    faeb_reactor_t* reactor = calloc(1, sizeof(faeb_reactor_t));
+    if (!reactor) return NULL;
+    
+    reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (reactor->epoll_fd < 0) {
+        free(reactor);
+        return NULL;
+    }
+    return reactor;
+}
+
+// Destroy a reactor nobody waits on; registered descriptors stay open
+void faeb_reactor_destroy(faeb_reactor_t* reactor) {
+    if (!reactor) return;
+    
+    for (size_t i = 0; i < reactor->page_count; i++) {
+        free(reactor->pages[i]);
+    }
+    free(reactor->pages);
+    close(reactor->epoll_fd);
+    free(reactor);
+}
+
+size_t faeb_reactor_waiting(faeb_reactor_t* reactor) {
+    return reactor ? reactor->waiting : 0;
+}
+
+void faeb_reactor_stats(faeb_reactor_t* reactor, faeb_scheduler_stats_t* stats) {
+    if (!reactor) return;
+    
+    stats->fd_waiting = reactor->waiting + reactor->blocked;
+    stats->fd_polls = reactor->polls;
+    stats->fd_events = reactor->events;
+}
+
+// Entry of fd, allocating its page when create is set
+static struct faeb_reactor_fd* reactor_entry(faeb_reactor_t* reactor, int fd, bool create) {
+    size_t page = (size_t)fd / FAEB_REACTOR_PAGE;
+    if (page >= reactor->page_count || !reactor->pages[page]) {
+        if (!create) return NULL;
+        if (page >= reactor->page_count) {
+            size_t count = reactor->page_count ? reactor->page_count : 1;
+            while (count <= page) count *= 2;
+            struct faeb_reactor_fd** pages = realloc(reactor->pages, count * sizeof(*pages));
+            if (!pages) return NULL;
+            memset(pages + reactor->page_count, 0,
+                   (count - reactor->page_count) * sizeof(*pages));
+            reactor->pages = pages;
+            reactor->page_count = count;
+        }
+        reactor->pages[page] = calloc(FAEB_REACTOR_PAGE, sizeof(struct faeb_reactor_fd));
+        if (!reactor->pages[page]) return NULL;
+    }
+    return &reactor->pages[page][(size_t)fd % FAEB_REACTOR_PAGE];
+}
+
+// Make fd non-blocking and add it to the set, once. With verify set a
+// registered entry is re-armed instead of trusted; epoll no longer
+// knowing fd means it was closed without unregistering, and whatever
+// now has its number is registered afresh.
+static faeb_result_t reactor_register(faeb_reactor_t* reactor, int fd, bool verify,
+                                      struct faeb_reactor_fd** out) {
+    struct faeb_reactor_fd* entry = reactor_entry(reactor, fd, true);
+    if (!entry) return FAEB_ERROR_MEMORY;
+    
+    struct epoll_event event = {
+        .events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET,
+        .data.fd = fd
+    };
+    if (entry->registered && verify &&
+        epoll_ctl(reactor->epoll_fd, EPOLL_CTL_MOD, fd, &event) < 0 && errno == ENOENT) {
+        entry->registered = false;
+    }
+    if (!entry->registered) {
+        int flags = fcntl(fd, F_GETFL);
+        if (flags < 0) return FAEB_ERROR_INVALID;
+        if (!(flags & O_NONBLOCK) && fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+            return FAEB_ERROR_IO;
+        }
+        if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0 && errno != EEXIST) {
+            // Regular files are always ready and cannot be added
+            int error = errno;
+            if (!(flags & O_NONBLOCK)) {
+                fcntl(fd, F_SETFL, flags);
+            }
+            return error == EPERM ? FAEB_ERROR_INVALID : FAEB_ERROR_IO;
+        }
+        entry->registered = true;
+        entry->was_blocking = !(flags & O_NONBLOCK);
+        entry->ready = 0;
+    }
+    *out = entry;
+    return FAEB_SUCCESS;
+}
+
+// Take the tick scheduler's blocked process off its entry
+static void reactor_unlink(faeb_reactor_t* reactor, struct faeb_process* process) {
+    struct faeb_reactor_fd* entry = process->fd_entry;
+    if (process->fd_prev) {
+        process->fd_prev->fd_next = process->fd_next;
+    } else {
+        entry->blocked = process->fd_next;
+    }
+    if (process->fd_next) {
+        process->fd_next->fd_prev = process->fd_prev;
+    }
+    process->fd_next = NULL;
+    process->fd_prev = NULL;
+    process->fd_entry = NULL;
+    reactor->blocked--;
+}
+
+// A process waiting on a descriptor leaves early: it was unblocked,
+// removed or destroyed
+void faeb_reactor_forget(struct faeb_process* process) {
+    faeb_reactor_t* reactor = process->scheduler->reactor;
+    if (process->wait_queue == &process->fd_entry->waiters) {
+        process->fd_entry = NULL;
+        reactor->waiting--;
+    } else {
+        reactor_unlink(reactor, process);
+    }
+}
+
+// Wake the processes waiting for what ready reports and keep what none
+// of them took
+static void reactor_dispatch(faeb_reactor_t* reactor, struct faeb_reactor_fd* entry,
+                             uint32_t ready) {
+    uint32_t taken = 0;
+    struct faeb_process* process = entry->waiters.head;
+    while (process) {
+        struct faeb_process* next = process->next;
+        if (process->fd_events & ready) {
+            taken |= process->fd_events & ready;
+            wait_queue_remove(&entry->waiters, process);
+            process->fd_entry = NULL;
+            reactor->waiting--;
+            faeb_process_wake(process);
+        }
+        process = next;
+    }
+    process = entry->blocked;
+    while (process) {
+        struct faeb_process* next = process->fd_next;
+        if (process->fd_events & ready) {
+            taken |= process->fd_events & ready;
+            faeb_scheduler_unblock_process(process);
+        }
+        process = next;
+    }
+    entry->ready |= ready & ~taken;
+}
+
+static void reactor_collect(faeb_reactor_t* reactor, int timeout_ms) {
+    struct epoll_event events[FAEB_REACTOR_EVENTS];
+    int count = epoll_wait(reactor->epoll_fd, events, FAEB_REACTOR_EVENTS, timeout_ms);
+    reactor->polls++;
+    if (count <= 0) return;
+    
+    reactor->events += (uint64_t)count;
+    for (int i = 0; i < count; i++) {
+        // The I/O engine's descriptor only ends the wait
+        if (events[i].data.fd < 0) continue;
+        struct faeb_reactor_fd* entry = reactor_entry(reactor, events[i].data.fd, false);
+        if (!entry || !entry->registered) continue;
+        
+        uint32_t flags = events[i].events;
+        uint32_t ready = 0;
+        if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) ready |= FAEB_FD_READ;
+        if (flags & (EPOLLOUT | EPOLLHUP | EPOLLERR)) ready |= FAEB_FD_WRITE;
+        reactor_dispatch(reactor, entry, ready);
+    }
+}
+
+// Collect edges without blocking, once per tick while anyone waits
+void faeb_reactor_poll(faeb_reactor_t* reactor, uint64_t tick) {
+    if ((reactor->waiting == 0 && reactor->blocked == 0) || tick == reactor->poll_tick) return;
+    
+    reactor->poll_tick = tick;
+    reactor_collect(reactor, 0);
+}
+
+// Nothing can run: sleep until an edge, until_ns, or, while io has
+// requests pending, until one of them completes
+void faeb_reactor_wait(faeb_reactor_t* reactor, faeb_io_engine_t* io, uint64_t until_ns) {
+    int timeout_ms = -1;
+    if (until_ns != UINT64_MAX) {
+        uint64_t now = faeb_timer_now_ns();
+        uint64_t ms = until_ns > now ? (until_ns - now + 999999) / 1000000 : 0;
+        timeout_ms = ms > INT_MAX ? INT_MAX : (int)ms;
+    }
+    
+    // Added for this wait only; adding reports completions already there
+    int io_fd = faeb_io_engine_pending(io) ? faeb_io_engine_prepare(io) : -1;
+    if (io_fd >= 0) {
+        struct epoll_event event = { .events = EPOLLIN | EPOLLET, .data.fd = -1 };
+        if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, io_fd, &event) < 0) {
+            timeout_ms = timeout_ms < 0 || timeout_ms > 1 ? 1 : timeout_ms;
+            io_fd = -1;
+        }
+    }
+    reactor_collect(reactor, timeout_ms);
+    if (io_fd >= 0) {
+        epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, io_fd, NULL);
+    }
+}
+
+// Tick scheduler: block the current process until fd is ready for
+// events, or take readiness already reported and leave it current
+faeb_result_t faeb_reactor_block(faeb_reactor_t* reactor, int fd, uint32_t events) {
+    struct faeb_reactor_fd* entry;
+    faeb_result_t result = reactor_register(reactor, fd, true, &entry);
+    if (result != FAEB_SUCCESS) return result;
+    if (entry->ready & events) {
+        entry->ready &= ~events;
+        return FAEB_SUCCESS;
+    }
+    
+    struct faeb_process* process = faeb_scheduler_get_current();
+    result = faeb_scheduler_block_current();
+    if (result != FAEB_SUCCESS) return result;
+    process->fd_events = events;
+    process->fd_entry = entry;
+    process->fd_prev = NULL;
+    process->fd_next = entry->blocked;
+    if (entry->blocked) {
+        entry->blocked->fd_prev = process;
+    }
+    entry->blocked = process;
+    reactor->blocked++;
+    return FAEB_SUCCESS;
+}
+
+// Wait with poll(2) where there is no loop to park in
+static faeb_result_t fd_poll(int fd, uint32_t events) {
+    struct pollfd event = { .fd = fd };
+    if (events & FAEB_FD_READ) event.events |= POLLIN;
+    if (events & FAEB_FD_WRITE) event.events |= POLLOUT;
+    int result;
+    do {
+        result = poll(&event, 1, -1);
+    } while (result < 0 && errno == EINTR);
+    if (result < 0) return FAEB_ERROR_IO;
+    return event.revents & POLLNVAL ? FAEB_ERROR_INVALID : FAEB_SUCCESS;
+}
+
+// Reactor of the loop the calling process may park in, NULL when it
+// cannot
+static faeb_reactor_t* fd_reactor(void) {
+    struct faeb_process* process = faeb_process_self();
+    faeb_scheduler_t* scheduler = faeb_scheduler_running();
+    if (!process || faeb_scheduler_on_worker() || !scheduler ||
+        process->scheduler != scheduler) {
+        return NULL;
+    }
+    return faeb_scheduler_reactor(scheduler);
+}
+
+// Add fd to the current scheduler's set, making it non-blocking until it
+// is unregistered. Waiting registers too; this only does it ahead of
+// time.
+faeb_result_t faeb_fd_register(int fd) {
+    if (fd < 0) return FAEB_ERROR_INVALID;
+    
+    faeb_reactor_t* reactor = faeb_scheduler_reactor(faeb_scheduler_current());
+    if (!reactor) return FAEB_ERROR_MEMORY;
+    struct faeb_reactor_fd* entry;
+    return reactor_register(reactor, fd, true, &entry);
+}
+
+// Take fd out of the current scheduler's set before it is closed, and
+// make it blocking again if registering made it non-blocking. Its
+// waiters wake to find out for themselves.
+faeb_result_t faeb_fd_unregister(int fd) {
+    if (fd < 0) return FAEB_ERROR_INVALID;
+    
+    faeb_reactor_t* reactor = faeb_scheduler_current()->reactor;
+    struct faeb_reactor_fd* entry = reactor ? reactor_entry(reactor, fd, false) : NULL;
+    if (!entry || !entry->registered) return FAEB_ERROR_INVALID;
+    
+    // Descriptors closed meanwhile are left alone
+    if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, fd, NULL) == 0 && entry->was_blocking) {
+        int flags = fcntl(fd, F_GETFL);
+        if (flags >= 0) {
+            fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+        }
+    }
+    reactor_dispatch(reactor, entry, FAEB_FD_READ | FAEB_FD_WRITE);
+    entry->registered = false;
+    entry->ready = 0;
+    return FAEB_SUCCESS;
+}
+
+// Wait until fd is ready for one of events. Readiness is edge-triggered:
+// call this once a read or write has run into EAGAIN, not while data
+// may be left. Edges reported before that count, at the cost of one
+// early return.
+faeb_result_t faeb_fd_wait(int fd, uint32_t events) {
+    events &= FAEB_FD_READ | FAEB_FD_WRITE;
+    if (fd < 0 || !events) return FAEB_ERROR_INVALID;
+    
+    faeb_reactor_t* reactor = fd_reactor();
+    if (!reactor) return fd_poll(fd, events);
+    struct faeb_reactor_fd* entry;
+    faeb_result_t result = reactor_register(reactor, fd, true, &entry);
+    if (result != FAEB_SUCCESS) return result;
+    if (entry->ready & events) {
+        entry->ready &= ~events;
+        return FAEB_SUCCESS;
+    }
+    
+    struct faeb_process* process = faeb_process_self();
+    process->fd_events = events;
+    process->fd_entry = entry;
+    reactor->waiting++;
+    faeb_process_park(&entry->waiters, NULL);
+    return FAEB_SUCCESS;
+}
+
+// In a loop, register fd so the calls on it cannot block the thread,
+// leaving it non-blocking until unregistered; descriptors epoll refuses
+// are left as they are
+static void fd_prepare(int fd) {
+    faeb_reactor_t* reactor = fd_reactor();
+    struct faeb_reactor_fd* entry;
+    if (reactor) {
+        reactor_register(reactor, fd, false, &entry);
+    }
+}
+
+// Read up to size bytes, waiting until there are some. 0 bytes with
+// FAEB_SUCCESS is end of input. In a loop fd stays non-blocking until
+// faeb_fd_unregister.
+faeb_result_t faeb_fd_read(int fd, void* buffer, size_t size, size_t* done) {
+    if (done) {
+        *done = 0;
+    }
+    if (fd < 0 || (!buffer && size)) return FAEB_ERROR_INVALID;
+    
+    fd_prepare(fd);
+    for (;;) {
+        ssize_t result = read(fd, buffer, size);
+        if (result >= 0) {
+            if (done) {
+                *done = (size_t)result;
+            }
+            return FAEB_SUCCESS;
+        }
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) return FAEB_ERROR_IO;
+        faeb_result_t waited = faeb_fd_wait(fd, FAEB_FD_READ);
+        if (waited != FAEB_SUCCESS) return waited;
+    }
+}
+
+// Write all size bytes, waiting whenever the descriptor is full; done
+// tells how far it got when writing fails. In a loop fd stays
+// non-blocking until faeb_fd_unregister.
+faeb_result_t faeb_fd_write(int fd, const void* buffer, size_t size, size_t* done) {
+    if (done) {
+        *done = 0;
+    }
+    if (fd < 0 || (!buffer && size)) return FAEB_ERROR_INVALID;
+    
+    fd_prepare(fd);
+    const char* data = buffer;
+    size_t written = 0;
+    faeb_result_t result = FAEB_SUCCESS;
+    while (written < size) {
+        ssize_t n = write(fd, data + written, size - written);
+        if (n >= 0) {
+            written += (size_t)n;
+            continue;
+        }
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            result = FAEB_ERROR_IO;
+            break;
+        }
+        result = faeb_fd_wait(fd, FAEB_FD_WRITE);
+        if (result != FAEB_SUCCESS) break;
+    }
+    if (done) {
+        *done = written;
+    }
+    return result;
+}
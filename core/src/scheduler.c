@@ -3,96 +3,342 @@
  * License: Apache 2.0
  */
 
-#include "faeb/runtime.h"
+#define _DEFAULT_SOURCE
+
+#include "internal.h"
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <errno.h>
 
-// Scheduler state
-static struct {
-    bool initialized;
-    struct faeb_process* ready_queue;
-    struct faeb_process* blocked_queue;
-    struct faeb_process* current;
-    int time_slice;
-    int current_time;
-} scheduler_state = {
+// Shared default scheduler, and the one each thread currently acts on
+static faeb_scheduler_t default_scheduler = {
     .initialized = false,
-    .ready_queue = NULL,
-    .blocked_queue = NULL,
     .current = NULL,
     .time_slice = 100, // 100ms time slice
-    .current_time = 0
+    .current_time = 0,
+    .timers = { .ready = faeb_scheduler_timer_ready }
 };
 
-// Initialize scheduler
+static _Thread_local faeb_scheduler_t* current_scheduler = NULL;
+
+// Ids of created instances; the default scheduler is 0
+static _Atomic uint64_t scheduler_ids = 1;
+
+// Create a scheduler instance with its own queues, timers and time slice
+faeb_scheduler_t* faeb_scheduler_create(int time_slice_ms) {
+    faeb_scheduler_t* scheduler = aligned_alloc(_Alignof(faeb_scheduler_t),
+                                                sizeof(faeb_scheduler_t));
+    if (!scheduler) return NULL;
+    
+    memset(scheduler, 0, sizeof(*scheduler));
+    scheduler->id = atomic_fetch_add(&scheduler_ids, 1);
+    scheduler->initialized = true;
+    scheduler->time_slice = time_slice_ms;
+    scheduler->slice_start_ns = faeb_timer_now_ns();
+    faeb_timer_wheel_init(&scheduler->timers, faeb_scheduler_timer_ready);
+    atomic_init(&scheduler->inbox, NULL);
+    return scheduler;
+}
+
+// Destroy a scheduler instance. Its processes must have been destroyed
+// first; threads still using it as current fall back to the default.
+void faeb_scheduler_destroy(faeb_scheduler_t* scheduler) {
+    if (!scheduler || scheduler == &default_scheduler) return;
+    
+    if (current_scheduler == scheduler) {
+        current_scheduler = NULL;
+    }
+    free(scheduler->deadlines.entries);
+    free(scheduler->releases.entries);
+    faeb_io_engine_destroy(scheduler->io);
+    faeb_reactor_destroy(scheduler->reactor);
+    faeb_process_release_stats(scheduler);
+    free(scheduler);
+}
+
+faeb_scheduler_t* faeb_scheduler_get_default(void) {
+    return &default_scheduler;
+}
+
+faeb_scheduler_t* faeb_scheduler_current(void) {
+    return current_scheduler ? current_scheduler : &default_scheduler;
+}
+
+// Select the calling thread's scheduler, NULL for the default; returns
+// the one it replaces
+faeb_scheduler_t* faeb_scheduler_set_current(faeb_scheduler_t* scheduler) {
+    faeb_scheduler_t* previous = faeb_scheduler_current();
+    current_scheduler = scheduler == &default_scheduler ? NULL : scheduler;
+    return previous;
+}
+
+// Choose the current scheduler's I/O engine and set it up now. Fails
+// while processes are parked on I/O, and with FAEB_ERROR_IO when io_uring
+// is asked for and the kernel refuses it.
+faeb_result_t faeb_scheduler_set_io_backend(faeb_io_backend_t backend) {
+    if (backend < FAEB_IO_BACKEND_AUTO || backend > FAEB_IO_BACKEND_THREADS) {
+        return FAEB_ERROR_INVALID;
+    }
+    
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    if (faeb_io_engine_pending(scheduler->io)) return FAEB_ERROR_INVALID;
+    faeb_io_engine_t* engine = faeb_io_engine_create(backend);
+    if (!engine) return backend == FAEB_IO_BACKEND_URING ? FAEB_ERROR_IO : FAEB_ERROR_MEMORY;
+    
+    faeb_io_engine_destroy(scheduler->io);
+    scheduler->io = engine;
+    scheduler->io_backend = backend;
+    return FAEB_SUCCESS;
+}
+
+faeb_io_backend_t faeb_scheduler_get_io_backend(void) {
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    return scheduler->io ? faeb_io_engine_backend(scheduler->io) : scheduler->io_backend;
+}
+
+faeb_io_engine_t* faeb_scheduler_io_engine(faeb_scheduler_t* scheduler) {
+    if (!scheduler->io) {
+        scheduler->io = faeb_io_engine_create(scheduler->io_backend);
+    }
+    return scheduler->io;
+}
+
+faeb_reactor_t* faeb_scheduler_reactor(faeb_scheduler_t* scheduler) {
+    if (!scheduler->reactor) {
+        scheduler->reactor = faeb_reactor_create();
+    }
+    return scheduler->reactor;
+}
+
+// Expired sleeps and timed blocks go back to the run queue of their
+// scheduler, leaving the tick scheduler's blocked queue if they were on it
+void faeb_scheduler_timer_ready(struct faeb_process* process) {
+    faeb_scheduler_t* scheduler = process->scheduler;
+    if (process->wait_queue == &scheduler->blocked_queue) {
+        wait_queue_remove(&scheduler->blocked_queue, process);
+    }
+    scheduler_enqueue(scheduler, process);
+}
+
+static inline void heap_place(faeb_deadline_heap_t* heap, struct faeb_process* process,
+                              size_t index) {
+    heap->entries[index] = process;
+    process->heap_index = index;
+}
+
+static void heap_sift_up(faeb_deadline_heap_t* heap, size_t index) {
+    struct faeb_process* process = heap->entries[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (heap->entries[parent]->heap_key <= process->heap_key) break;
+        heap_place(heap, heap->entries[parent], index);
+        index = parent;
+    }
+    heap_place(heap, process, index);
+}
+
+static void heap_sift_down(faeb_deadline_heap_t* heap, size_t index) {
+    struct faeb_process* process = heap->entries[index];
+    for (;;) {
+        size_t child = 2 * index + 1;
+        if (child >= heap->count) break;
+        if (child + 1 < heap->count &&
+            heap->entries[child + 1]->heap_key < heap->entries[child]->heap_key) {
+            child++;
+        }
+        if (process->heap_key <= heap->entries[child]->heap_key) break;
+        heap_place(heap, heap->entries[child], index);
+        index = child;
+    }
+    heap_place(heap, process, index);
+}
+
+// Admission has reserved the slot
+void faeb_deadline_heap_push(faeb_deadline_heap_t* heap, struct faeb_process* process,
+                             uint64_t key) {
+    assert(heap->count < heap->capacity);
+    process->heap = heap;
+    process->heap_key = key;
+    heap->entries[heap->count] = process;
+    heap_sift_up(heap, heap->count++);
+}
+
+struct faeb_process* faeb_deadline_heap_pop(faeb_deadline_heap_t* heap) {
+    if (heap->count == 0) return NULL;
+    
+    struct faeb_process* process = heap->entries[0];
+    faeb_deadline_heap_remove(process);
+    return process;
+}
+
+// Fill the hole with the last entry and restore order around it
+void faeb_deadline_heap_remove(struct faeb_process* process) {
+    faeb_deadline_heap_t* heap = process->heap;
+    size_t index = process->heap_index;
+    process->heap = NULL;
+    struct faeb_process* last = heap->entries[--heap->count];
+    if (index == heap->count) return;
+    
+    heap_place(heap, last, index);
+    heap_sift_down(heap, index);
+    heap_sift_up(heap, last->heap_index);
+}
+
+// Grow a heap to hold at least count processes
+static bool heap_reserve(faeb_deadline_heap_t* heap, size_t count) {
+    if (count <= heap->capacity) return true;
+    
+    size_t capacity = heap->capacity ? heap->capacity * 2 : 16;
+    struct faeb_process** entries = realloc(heap->entries, capacity * sizeof(*entries));
+    if (!entries) return false;
+    heap->entries = entries;
+    heap->capacity = capacity;
+    return true;
+}
+
+void faeb_scheduler_release(faeb_scheduler_t* scheduler, uint64_t now) {
+    faeb_deadline_heap_t* releases = &scheduler->releases;
+    while (releases->count && releases->entries[0]->heap_key <= now) {
+        struct faeb_process* process = faeb_deadline_heap_pop(releases);
+        process->state = FAEB_PROCESS_READY;
+        process->ready_ns = process->release_ns;
+        scheduler_enqueue(scheduler, process);
+    }
+}
+
+// Density runtime / min(deadline, period) in parts per million, rounded up
+static uint64_t deadline_density(uint64_t runtime_ns, uint64_t deadline_ns,
+                                 uint64_t period_ns) {
+    uint64_t window = deadline_ns < period_ns ? deadline_ns : period_ns;
+    return (runtime_ns * 1000000ULL + window - 1) / window;
+}
+
+faeb_result_t faeb_scheduler_admit(struct faeb_process* process, uint64_t runtime_ns,
+                                   uint64_t deadline_ns, uint64_t period_ns) {
+    faeb_scheduler_t* scheduler = process->scheduler;
+    uint64_t old_density = process->period_ns ?
+        deadline_density(process->budget_ns, process->relative_deadline_ns,
+                         process->period_ns) : 0;
+    uint64_t new_density = period_ns ?
+        deadline_density(runtime_ns, deadline_ns, period_ns) : 0;
+    
+    if (new_density && scheduler->deadline_density - old_density + new_density >
+                       FAEB_SCHEDULER_DEADLINE_BOUND) {
+        return FAEB_ERROR_LIMIT;
+    }
+    
+    // Every admitted process owns a slot in both heaps
+    size_t needed = scheduler->deadline_processes + 1;
+    if (new_density && !process->period_ns &&
+        (!heap_reserve(&scheduler->deadlines, needed) ||
+         !heap_reserve(&scheduler->releases, needed))) {
+        return FAEB_ERROR_MEMORY;
+    }
+    
+    // A ready process moves between the heap and its priority level; one
+    // waiting for its next release is ready at once
+    bool queued = process->heap == &scheduler->deadlines || process->runqueue;
+    if (process->heap == &scheduler->releases) {
+        process->state = FAEB_PROCESS_READY;
+        process->ready_ns = faeb_timer_now_ns();
+        queued = true;
+    }
+    if (queued) {
+        scheduler_unqueue(process);
+    }
+    
+    scheduler->deadline_density = scheduler->deadline_density - old_density + new_density;
+    if (new_density && !process->period_ns) {
+        scheduler->deadline_processes++;
+    } else if (!new_density && process->period_ns) {
+        scheduler->deadline_processes--;
+    }
+    process->budget_ns = runtime_ns;
+    process->relative_deadline_ns = deadline_ns;
+    process->period_ns = period_ns;
+    process->release_ns = faeb_timer_now_ns();
+    process->deadline_ns = process->release_ns + deadline_ns;
+    
+    if (queued) {
+        scheduler_enqueue(scheduler, process);
+    }
+    return FAEB_SUCCESS;
+}
+
+// A ready process due before the running one takes over at the next tick
+static bool scheduler_deadline_preempts(faeb_scheduler_t* scheduler) {
+    struct faeb_process* current = scheduler->current;
+    if (!current || scheduler->deadlines.count == 0) {
+        return false;
+    }
+    
+    return !current->period_ns ||
+           scheduler->deadlines.entries[0]->deadline_ns < current->deadline_ns;
+}
+
+// Initialize the current scheduler's tick API
 faeb_result_t faeb_scheduler_init(int time_slice_ms) {
-    if (scheduler_state.initialized) {
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    if (scheduler->initialized) {
         return FAEB_SUCCESS;
     }
     
-    scheduler_state.time_slice = time_slice_ms;
-    scheduler_state.current_time = 0;
-    scheduler_state.ready_queue = NULL;
-    scheduler_state.blocked_queue = NULL;
-    scheduler_state.current = NULL;
-    scheduler_state.initialized = true;
+    scheduler->time_slice = time_slice_ms;
+    scheduler->current_time = 0;
+    scheduler->current = NULL;
+    scheduler->slice_start_ns = faeb_timer_now_ns();
+    scheduler->initialized = true;
     
     return FAEB_SUCCESS;
 }
 
 // Add process to ready queue
 faeb_result_t faeb_scheduler_add_process(faeb_process_t* process) {
-    if (!scheduler_state.initialized || !process) {
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    if (!scheduler->initialized || !process) {
         return FAEB_ERROR_INVALID;
     }
     
-    // Add to head of ready queue
-    process->next = scheduler_state.ready_queue;
-    scheduler_state.ready_queue = process;
+    // Admitted deadlines belong to the scheduler that admitted them
+    if (process->period_ns && process->scheduler != scheduler) {
+        return FAEB_ERROR_INVALID;
+    }
+    
+    // Take it over from any other run queue, then queue it by deadline
+    // or priority
+    scheduler_unqueue(process);
+    process->scheduler = scheduler;
+    process->ready_ns = faeb_timer_now_ns();
+    scheduler_enqueue(scheduler, process);
     
     return FAEB_SUCCESS;
 }
 
 // Remove process from scheduler
 faeb_result_t faeb_scheduler_remove_process(faeb_process_t* process) {
-    if (!scheduler_state.initialized || !process) {
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    if (!scheduler->initialized || !process) {
         return FAEB_ERROR_INVALID;
     }
     
-    // Remove from ready queue
-    if (scheduler_state.ready_queue == process) {
-        scheduler_state.ready_queue = process->next;
-        process->next = NULL;
-        return FAEB_SUCCESS;
-    }
-    
-    struct faeb_process* current = scheduler_state.ready_queue;
-    while (current && current->next != process) {
-        current = current->next;
-    }
+    faeb_timer_cancel(&process->timer);
     
-    if (current) {
-        current->next = process->next;
-        process->next = NULL;
+    // Remove from ready queue
+    if (process->runqueue == &scheduler->ready_queue ||
+        (process->heap && process->scheduler == scheduler)) {
+        scheduler_unqueue(process);
         return FAEB_SUCCESS;
     }
     
     // Remove from blocked queue
-    if (scheduler_state.blocked_queue == process) {
-        scheduler_state.blocked_queue = process->next;
-        process->next = NULL;
-        return FAEB_SUCCESS;
-    }
-    
-    current = scheduler_state.blocked_queue;
-    while (current && current->next != process) {
-        current = current->next;
-    }
-    
-    if (current) {
-        current->next = process->next;
-        process->next = NULL;
+    if (process->wait_queue == &scheduler->blocked_queue) {
+        if (process->fd_entry) faeb_reactor_forget(process);
+        wait_queue_remove(&scheduler->blocked_queue, process);
         return FAEB_SUCCESS;
     }
     
@@ -101,157 +347,640 @@ faeb_result_t faeb_scheduler_remove_process(faeb_process_t* process) {
 
 // Schedule next process
 faeb_process_t* faeb_scheduler_schedule_next(void) {
-    if (!scheduler_state.initialized) {
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    if (!scheduler->initialized) {
         return NULL;
     }
     
-    // If current process exists, add it back to ready queue
-    if (scheduler_state.current) {
-        scheduler_state.current->next = scheduler_state.ready_queue;
-        scheduler_state.ready_queue = scheduler_state.current;
-        scheduler_state.current = NULL;
-    }
+    uint64_t now = faeb_timer_now_ns();
     
-    // Select next process from ready queue
-    if (scheduler_state.ready_queue) {
-        scheduler_state.current = scheduler_state.ready_queue;
-        scheduler_state.ready_queue = scheduler_state.ready_queue->next;
-        scheduler_state.current->next = NULL;
-        
-        return scheduler_state.current;
+    // If current process exists, charge it for its slice and add it back
+    // to the tail of its level
+    struct faeb_process* process = scheduler->current;
+    if (process) {
+        faeb_process_account_stop(process, scheduler->slice_start_ns, now);
+        process->ready_ns = now;
+        scheduler_enqueue(scheduler, process);
     }
     
-    return NULL;
+    // Select the earliest deadline, else the highest-priority process
+    process = scheduler_dequeue(scheduler);
+    if (process) {
+        faeb_process_account_run(process, now);
+    }
+    scheduler->current = process;
+    scheduler->slice_start_ns = now;
+    return process;
 }
 
 // Get current process
 faeb_process_t* faeb_scheduler_get_current(void) {
-    return scheduler_state.current;
+    return faeb_scheduler_current()->current;
 }
 
 // Block current process
 faeb_result_t faeb_scheduler_block_current(void) {
-    if (!scheduler_state.initialized || !scheduler_state.current) {
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    struct faeb_process* process = scheduler->current;
+    if (!scheduler->initialized || !process) {
         return FAEB_ERROR_INVALID;
     }
     
+    uint64_t now = faeb_timer_now_ns();
+    
     // Move current process to blocked queue
-    scheduler_state.current->next = scheduler_state.blocked_queue;
-    scheduler_state.blocked_queue = scheduler_state.current;
-    scheduler_state.current = NULL;
+    process->state = FAEB_PROCESS_BLOCKED;
+    faeb_process_account_stop(process, scheduler->slice_start_ns, now);
+    scheduler->slice_start_ns = now;
+    wait_queue_push(&scheduler->blocked_queue, process);
+    scheduler->current = NULL;
+    
+    return FAEB_SUCCESS;
+}
+
+// Block current process for at most timeout_ms; the timer wheel
+// unblocks it on expiry unless faeb_scheduler_unblock_process gets there
+// first
+faeb_result_t faeb_scheduler_block_current_timeout(uint32_t timeout_ms) {
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    struct faeb_process* process = scheduler->current;
+    faeb_result_t result = faeb_scheduler_block_current();
+    if (result != FAEB_SUCCESS) {
+        return result;
+    }
+    
+    // An empty wheel may not have been advanced for a while
+    if (scheduler->timers.count == 0) {
+        scheduler->timers.now = faeb_timer_now();
+    }
+    process->timer.fire = faeb_process_timer_fire;
+    faeb_timer_arm(&scheduler->timers, &process->timer,
+                   faeb_timer_deadline(timeout_ms));
     
     return FAEB_SUCCESS;
 }
 
+// Block current process until fd is ready for one of events;
+// faeb_scheduler_tick unblocks it when the reactor reports so. Readiness
+// reported already is taken at once, and the process stays current.
+faeb_result_t faeb_scheduler_block_current_fd(int fd, uint32_t events) {
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    events &= FAEB_FD_READ | FAEB_FD_WRITE;
+    if (!scheduler->initialized || !scheduler->current || fd < 0 || !events) {
+        return FAEB_ERROR_INVALID;
+    }
+    
+    faeb_reactor_t* reactor = faeb_scheduler_reactor(scheduler);
+    if (!reactor) return FAEB_ERROR_MEMORY;
+    return faeb_reactor_block(reactor, fd, events);
+}
+
 // Unblock process
 faeb_result_t faeb_scheduler_unblock_process(faeb_process_t* process) {
-    if (!scheduler_state.initialized || !process) {
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    if (!scheduler->initialized || !process) {
         return FAEB_ERROR_INVALID;
     }
     
-    // Remove from blocked queue
-    if (scheduler_state.blocked_queue == process) {
-        scheduler_state.blocked_queue = process->next;
-        process->next = NULL;
-        
-        // Add to ready queue
-        process->next = scheduler_state.ready_queue;
-        scheduler_state.ready_queue = process;
-        
-        return FAEB_SUCCESS;
+    if (process->wait_queue != &scheduler->blocked_queue) {
+        return FAEB_ERROR_INVALID;
     }
     
-    struct faeb_process* current = scheduler_state.blocked_queue;
-    while (current && current->next != process) {
-        current = current->next;
-    }
+    faeb_timer_cancel(&process->timer);
+    if (process->fd_entry) faeb_reactor_forget(process);
     
-    if (current) {
-        current->next = process->next;
-        process->next = NULL;
-        
-        // Add to ready queue
-        process->next = scheduler_state.ready_queue;
-        scheduler_state.ready_queue = process;
-        
-        return FAEB_SUCCESS;
-    }
+    // Move from blocked queue to ready queue
+    wait_queue_remove(&scheduler->blocked_queue, process);
+    process->state = FAEB_PROCESS_READY;
+    process->ready_ns = faeb_timer_now_ns();
+    scheduler_enqueue(scheduler, process);
     
-    return FAEB_ERROR_INVALID;
+    return FAEB_SUCCESS;
 }
 
-// Check if time slice expired
+// Check if the current process has used up its time slice, measured on
+// CLOCK_MONOTONIC from when it was switched in
 bool faeb_scheduler_time_slice_expired(void) {
-    if (!scheduler_state.initialized) {
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    if (!scheduler->initialized || !scheduler->current) {
         return false;
     }
     
-    // Simple time slice check
-    static clock_t last_switch = 0;
-    clock_t current_time = clock();
-    
-    if (current_time - last_switch >= scheduler_state.time_slice) {
-        last_switch = current_time;
-        return true;
-    }
-    
-    return false;
+    uint64_t elapsed = faeb_timer_now_ns() - scheduler->slice_start_ns;
+    return elapsed >= (uint64_t)scheduler->time_slice * 1000000ULL;
 }
 
 // Run scheduler for one tick
 faeb_result_t faeb_scheduler_tick(void) {
-    if (!scheduler_state.initialized) {
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    if (!scheduler->initialized) {
         return FAEB_ERROR_INVALID;
     }
     
-    scheduler_state.current_time++;
+    scheduler->current_time++;
     
-    // Check for time slice expiration
-    if (faeb_scheduler_time_slice_expired()) {
+    // Unblock processes whose timed blocks expired, and release deadline
+    // jobs that are due
+    if (scheduler->timers.count) {
+        faeb_timer_advance(&scheduler->timers, faeb_timer_now());
+    }
+    if (scheduler->releases.count) {
+        faeb_scheduler_release(scheduler, faeb_timer_now_ns());
+    }
+    
+    // Unblock processes whose descriptors became ready
+    if (scheduler->reactor) {
+        faeb_reactor_poll(scheduler->reactor, (uint64_t)scheduler->current_time);
+    }
+    
+    // Check for time slice expiration or an earlier deadline
+    if (faeb_scheduler_time_slice_expired() || scheduler_deadline_preempts(scheduler)) {
         faeb_scheduler_schedule_next();
     }
     
     // If no current process, schedule one
-    if (!scheduler_state.current) {
+    if (!scheduler->current) {
         faeb_scheduler_schedule_next();
     }
     
     return FAEB_SUCCESS;
 }
 
-// Get scheduler statistics
-struct faeb_scheduler_stats {
-    int ready_count;
-    int blocked_count;
-    int total_processes;
-    int time_slice_ms;
+// Get statistics of the current scheduler, counting only its own
+// processes. Every field is a counter kept up to date as processes move,
+// so reading them costs the same however many there are.
+faeb_result_t faeb_scheduler_get_stats(faeb_scheduler_stats_t* stats) {
+    if (!stats) return FAEB_ERROR_INVALID;
+    
+    faeb_scheduler_t* scheduler = faeb_scheduler_current();
+    memset(stats, 0, sizeof(*stats));
+    if (scheduler->initialized) {
+        stats->time_slice_ms = scheduler->time_slice;
+        stats->ready_count = (int)(scheduler->ready_queue.count + scheduler->deadlines.count);
+        stats->blocked_count = (int)scheduler->blocked_queue.count;
+        stats->total_processes = stats->ready_count + stats->blocked_count +
+                                 (scheduler->current ? 1 : 0);
+    }
+    stats->deadline_processes = scheduler->deadline_processes;
+    stats->deadline_density = (double)scheduler->deadline_density / 1e6;
+    stats->deadline_misses = atomic_load_explicit(&scheduler->deadline_misses,
+                                                  memory_order_relaxed);
+    stats->submitted = atomic_load_explicit(&scheduler->submitted, memory_order_relaxed);
+    faeb_io_engine_stats(scheduler->io, stats);
+    faeb_reactor_stats(scheduler->reactor, stats);
+    faeb_process_accumulate_stats(scheduler, stats);
+    
+    return FAEB_SUCCESS;
+}
+
+// Work-stealing worker pool. Each worker owns a Chase-Lev deque: the
+// owner pushes and takes at the bottom without contention, thieves take
+// from the top with one CAS. Processes submitted from other threads, and
+// deque overflow, go through a locked injection queue.
+#define FAEB_WORKER_DEQUE_SIZE 4096     // Power of two
+#define FAEB_WORKER_MAX 256
+#define FAEB_WORKER_INJECT_INTERVAL 61  // Picks between forced injection checks
+
+struct faeb_worker {
+    _Alignas(FAEB_CACHE_LINE_SIZE) _Atomic int64_t top;
+    _Alignas(FAEB_CACHE_LINE_SIZE) _Atomic int64_t bottom;
+    _Atomic(struct faeb_process*) slots[FAEB_WORKER_DEQUE_SIZE];
+    pthread_t thread;
+    int cpu;                      // Pinned CPU, -1 when it may move
+    faeb_timer_wheel_t timers;    // Processes sleeping on this worker
+    uint64_t rng;
+    uint64_t picks;
+    bool after_yield;
 };
 
-struct faeb_scheduler_stats faeb_scheduler_get_stats(void) {
-    struct faeb_scheduler_stats stats = {0};
+static struct {
+    struct faeb_worker* workers;
+    int count;
+    _Atomic bool stopping;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;              // Parked workers
+    pthread_cond_t idle;              // faeb_scheduler_wait callers
+    struct faeb_process* inject_head;
+    struct faeb_process* inject_tail;
+    _Atomic size_t inject_count;
+    _Atomic int sleepers;
+    _Atomic uint64_t epoch;           // Bumped whenever new work appears
+    _Atomic size_t outstanding;       // Submitted and not yet finished
+} worker_pool = {
+    .workers = NULL,
+    .count = 0,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .idle = PTHREAD_COND_INITIALIZER
+};
+
+static _Thread_local struct faeb_worker* current_worker = NULL;
+
+// Owner only: push at the bottom, false when the deque is full
+static bool deque_push(struct faeb_worker* worker, struct faeb_process* process) {
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+    if (bottom - top >= FAEB_WORKER_DEQUE_SIZE) {
+        return false;
+    }
     
-    if (!scheduler_state.initialized) {
-        return stats;
+    atomic_store_explicit(&worker->slots[bottom & (FAEB_WORKER_DEQUE_SIZE - 1)],
+                          process, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+    return true;
+}
+
+// Owner only: take the most recently pushed process
+static struct faeb_process* deque_take(struct faeb_worker* worker) {
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&worker->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_relaxed);
+    
+    if (top > bottom) {
+        atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
     }
     
-    stats.time_slice_ms = scheduler_state.time_slice;
+    struct faeb_process* process = atomic_load_explicit(
+        &worker->slots[bottom & (FAEB_WORKER_DEQUE_SIZE - 1)], memory_order_relaxed);
+    if (top == bottom) {
+        // Last element: race the thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&worker->top, &top, top + 1,
+                                                     memory_order_seq_cst,
+                                                     memory_order_relaxed)) {
+            process = NULL;
+        }
+        atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return process;
+}
+
+// Any thread: take the oldest process. Retries while the CAS is lost to
+// another thread and work remains.
+static struct faeb_process* deque_steal(struct faeb_worker* worker) {
+    for (;;) {
+        int64_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_acquire);
+        if (top >= bottom) {
+            return NULL;
+        }
+        
+        struct faeb_process* process = atomic_load_explicit(
+            &worker->slots[top & (FAEB_WORKER_DEQUE_SIZE - 1)], memory_order_relaxed);
+        if (atomic_compare_exchange_strong_explicit(&worker->top, &top, top + 1,
+                                                    memory_order_seq_cst,
+                                                    memory_order_relaxed)) {
+            return process;
+        }
+    }
+}
+
+static void inject_push(struct faeb_process* process) {
+    pthread_mutex_lock(&worker_pool.lock);
+    process->next = NULL;
+    if (worker_pool.inject_tail) {
+        worker_pool.inject_tail->next = process;
+    } else {
+        worker_pool.inject_head = process;
+    }
+    worker_pool.inject_tail = process;
+    atomic_fetch_add_explicit(&worker_pool.inject_count, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&worker_pool.lock);
+}
+
+static struct faeb_process* inject_pop(void) {
+    if (atomic_load_explicit(&worker_pool.inject_count, memory_order_relaxed) == 0) {
+        return NULL;
+    }
     
-    // Count ready processes
-    struct faeb_process* current = scheduler_state.ready_queue;
-    while (current) {
-        stats.ready_count++;
-        current = current->next;
+    pthread_mutex_lock(&worker_pool.lock);
+    struct faeb_process* process = worker_pool.inject_head;
+    if (process) {
+        worker_pool.inject_head = process->next;
+        if (!worker_pool.inject_head) {
+            worker_pool.inject_tail = NULL;
+        }
+        process->next = NULL;
+        atomic_fetch_sub_explicit(&worker_pool.inject_count, 1, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&worker_pool.lock);
+    return process;
+}
+
+// Queue runnable work on the calling worker, or inject it from outside
+static void worker_enqueue(struct faeb_process* process) {
+    if (!current_worker || !deque_push(current_worker, process)) {
+        inject_push(process);
+    }
+}
+
+// Announce new work; wakes one parked worker if any are parked
+static void worker_notify(void) {
+    atomic_fetch_add(&worker_pool.epoch, 1);
+    if (atomic_load(&worker_pool.sleepers) > 0) {
+        pthread_mutex_lock(&worker_pool.lock);
+        pthread_cond_signal(&worker_pool.wake);
+        pthread_mutex_unlock(&worker_pool.lock);
+    }
+}
+
+static uint64_t worker_random(struct faeb_worker* worker) {
+    worker->rng ^= worker->rng << 13;
+    worker->rng ^= worker->rng >> 7;
+    worker->rng ^= worker->rng << 17;
+    return worker->rng;
+}
+
+// Next process for this worker. After a yield the oldest local process
+// goes first so yielding processes round-robin; otherwise the newest
+// local process, then injected work, then a randomized steal sweep.
+static struct faeb_process* worker_find(struct faeb_worker* worker) {
+    struct faeb_process* process = NULL;
+    
+    if (worker->timers.count) {
+        faeb_timer_advance(&worker->timers, faeb_timer_now());
     }
     
-    // Count blocked processes
-    current = scheduler_state.blocked_queue;
-    while (current) {
-        stats.blocked_count++;
-        current = current->next;
+    if (++worker->picks % FAEB_WORKER_INJECT_INTERVAL == 0) {
+        process = inject_pop();
+        if (process) return process;
     }
     
-    stats.total_processes = stats.ready_count + stats.blocked_count + 
-                           (scheduler_state.current ? 1 : 0);
+    if (worker->after_yield) {
+        worker->after_yield = false;
+        process = deque_steal(worker);
+    } else {
+        process = deque_take(worker);
+    }
+    if (process) return process;
+    
+    process = inject_pop();
+    if (process) return process;
+    
+    int count = worker_pool.count;
+    int start = (int)(worker_random(worker) % (uint64_t)count);
+    for (int i = 0; i < count; i++) {
+        struct faeb_worker* victim = &worker_pool.workers[(start + i) % count];
+        if (victim == worker) continue;
+        process = deque_steal(victim);
+        if (process) return process;
+    }
     
-    return stats;
+    return NULL;
+}
+
+// Sleepers wake on the worker they slept on
+static void worker_ready(struct faeb_process* process) {
+    worker_enqueue(process);
+}
+
+static void* worker_main(void* arg) {
+    struct faeb_worker* worker = arg;
+    current_worker = worker;
+    faeb_timer_set_local(&worker->timers);
+    faeb_process_clock_sync();
+    
+    while (!atomic_load(&worker_pool.stopping)) {
+        struct faeb_process* process = worker_find(worker);
+        
+        if (!process) {
+            // Announce the intent to sleep, look once more, then park
+            // until the epoch moves or the next local timer is due; a
+            // concurrent notify sees sleepers
+            uint64_t epoch = atomic_load(&worker_pool.epoch);
+            atomic_fetch_add(&worker_pool.sleepers, 1);
+            process = worker_find(worker);
+            if (!process) {
+                uint64_t next = faeb_timer_next(&worker->timers);
+                struct timespec deadline;
+                deadline.tv_sec = (time_t)(next * FAEB_TIMER_TICK_NS / 1000000000ULL);
+                deadline.tv_nsec = (long)(next * FAEB_TIMER_TICK_NS % 1000000000ULL);
+                
+                pthread_mutex_lock(&worker_pool.lock);
+                while (atomic_load(&worker_pool.epoch) == epoch &&
+                       !atomic_load(&worker_pool.stopping)) {
+                    if (next == UINT64_MAX) {
+                        pthread_cond_wait(&worker_pool.wake, &worker_pool.lock);
+                    } else if (pthread_cond_timedwait(&worker_pool.wake, &worker_pool.lock,
+                                                      &deadline) == ETIMEDOUT) {
+                        break;
+                    }
+                }
+                pthread_mutex_unlock(&worker_pool.lock);
+                faeb_process_clock_sync();
+            }
+            atomic_fetch_sub(&worker_pool.sleepers, 1);
+            if (!process) continue;
+        }
+        
+        faeb_process_state_t state = faeb_process_resume(process);
+        
+        if (state == FAEB_PROCESS_READY) {
+            worker->after_yield = true;
+            worker_enqueue(process);
+        } else if (state == FAEB_PROCESS_TERMINATED) {
+            process->on_workers = false;
+            atomic_fetch_sub(&process->scheduler->submitted, 1);
+            if (process->detached) {
+                faeb_process_destroy(process);
+            }
+            if (atomic_fetch_sub(&worker_pool.outstanding, 1) == 1) {
+                pthread_mutex_lock(&worker_pool.lock);
+                pthread_cond_broadcast(&worker_pool.idle);
+                pthread_mutex_unlock(&worker_pool.lock);
+            }
+        }
+    }
+    
+    current_worker = NULL;
+    return NULL;
+}
+
+// Processes woken from a wait object run wherever the waker is, or on
+// any worker when woken from outside the pool
+void faeb_scheduler_wake_worker(struct faeb_process* process) {
+    worker_enqueue(process);
+    worker_notify();
+}
+
+bool faeb_scheduler_on_worker(void) {
+    return current_worker != NULL;
+}
+
+// Start the worker pool; 0 starts one worker per online CPU
+faeb_result_t faeb_scheduler_init_workers(int workers) {
+    faeb_worker_config_t config = { .workers = workers };
+    return faeb_scheduler_init_workers_config(&config);
+}
+
+// Start the worker pool placed on CPUs. Each worker thread starts with
+// its affinity already set, so its deque and stacks are first touched
+// where it runs.
+faeb_result_t faeb_scheduler_init_workers_config(const faeb_worker_config_t* config) {
+    if (!config || (config->cpus && config->cpu_count == 0) ||
+        (config->placement != FAEB_PLACEMENT_NONE && config->placement != FAEB_PLACEMENT_SHARED &&
+         config->placement != FAEB_PLACEMENT_PINNED) ||
+        (config->placement == FAEB_PLACEMENT_NONE && config->cpus)) {
+        return FAEB_ERROR_INVALID;
+    }
+    if (worker_pool.count > 0) {
+        return FAEB_SUCCESS;
+    }
+    
+    // No more CPUs than workers can be told apart
+    int cpus[FAEB_WORKER_MAX];
+    size_t cpu_count = 0;
+    if (config->placement != FAEB_PLACEMENT_NONE) {
+        cpu_count = faeb_topology_placement(config->cpus, config->cpu_count,
+                                            cpus, FAEB_WORKER_MAX);
+        if (cpu_count == 0) {
+            return FAEB_ERROR_INVALID;
+        }
+        if (cpu_count > FAEB_WORKER_MAX) {
+            cpu_count = FAEB_WORKER_MAX;
+        }
+    }
+    
+    int workers = config->workers;
+    if (workers <= 0 && cpu_count > 0) {
+        workers = (int)cpu_count;
+    } else if (workers <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = online > 0 ? (int)online : 1;
+    }
+    if (workers > FAEB_WORKER_MAX) {
+        workers = FAEB_WORKER_MAX;
+    }
+    
+    struct faeb_worker* pool = aligned_alloc(_Alignof(struct faeb_worker),
+                                             (size_t)workers * sizeof(*pool));
+    if (!pool) {
+        return FAEB_ERROR_MEMORY;
+    }
+    
+    for (int i = 0; i < workers; i++) {
+        atomic_init(&pool[i].top, 0);
+        atomic_init(&pool[i].bottom, 0);
+        pool[i].rng = 0x9e3779b97f4a7c15ULL * (uint64_t)(i + 1);
+        pool[i].picks = 0;
+        pool[i].after_yield = false;
+        pool[i].cpu = config->placement == FAEB_PLACEMENT_PINNED ?
+                      cpus[(size_t)i % cpu_count] : -1;
+        faeb_timer_wheel_init(&pool[i].timers, worker_ready);
+    }
+    
+    // Parked workers time out on CLOCK_MONOTONIC for their sleepers
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_destroy(&worker_pool.wake);
+    pthread_cond_init(&worker_pool.wake, &attr);
+    pthread_condattr_destroy(&attr);
+    
+    atomic_store(&worker_pool.stopping, false);
+    worker_pool.workers = pool;
+    worker_pool.count = workers;
+    
+    for (int i = 0; i < workers; i++) {
+        pthread_attr_t thread_attr;
+        pthread_attr_init(&thread_attr);
+        faeb_result_t result = FAEB_SUCCESS;
+        if (config->placement == FAEB_PLACEMENT_PINNED) {
+            result = faeb_topology_attr_set(&thread_attr, &pool[i].cpu, 1);
+        } else if (config->placement == FAEB_PLACEMENT_SHARED) {
+            result = faeb_topology_attr_set(&thread_attr, cpus, cpu_count);
+        }
+        
+        // The kernel refuses CPUs outside the process's cpuset
+        if (result == FAEB_SUCCESS) {
+            int error = pthread_create(&pool[i].thread, &thread_attr, worker_main, &pool[i]);
+            if (error != 0) {
+                result = error == EINVAL ? FAEB_ERROR_INVALID : FAEB_ERROR_MEMORY;
+            }
+        }
+        pthread_attr_destroy(&thread_attr);
+        if (result != FAEB_SUCCESS) {
+            worker_pool.count = i;
+            faeb_scheduler_shutdown_workers();
+            return result;
+        }
+    }
+    
+    return FAEB_SUCCESS;
+}
+
+// Hand a ready process to the workers. It leaves any single-threaded
+// queue and runs on whichever worker picks it up.
+faeb_result_t faeb_scheduler_submit(faeb_process_t* process) {
+    if (!process || worker_pool.count == 0 || process->on_workers ||
+        process->state != FAEB_PROCESS_READY || process->period_ns) {
+        return FAEB_ERROR_INVALID;
+    }
+    
+    if (process->runqueue) {
+        runqueue_remove(process->runqueue, process);
+    }
+    
+    process->on_workers = true;
+    atomic_fetch_add(&process->scheduler->submitted, 1);
+    atomic_fetch_add(&worker_pool.outstanding, 1);
+    worker_enqueue(process);
+    worker_notify();
+    
+    return FAEB_SUCCESS;
+}
+
+// Wait until every submitted process has finished. Must not be called
+// from a worker.
+faeb_result_t faeb_scheduler_wait(void) {
+    if (worker_pool.count == 0 || current_worker) {
+        return FAEB_ERROR_INVALID;
+    }
+    
+    pthread_mutex_lock(&worker_pool.lock);
+    while (atomic_load(&worker_pool.outstanding) > 0) {
+        pthread_cond_wait(&worker_pool.idle, &worker_pool.lock);
+    }
+    pthread_mutex_unlock(&worker_pool.lock);
+    
+    return FAEB_SUCCESS;
+}
+
+// Stop and join the workers. Processes still queued, and sleepers whose
+// timers are disarmed with their worker's wheel, are dropped from the
+// pool but stay allocated for their owners to destroy.
+void faeb_scheduler_shutdown_workers(void) {
+    if (!worker_pool.workers || current_worker) return;
+    
+    pthread_mutex_lock(&worker_pool.lock);
+    atomic_store(&worker_pool.stopping, true);
+    pthread_cond_broadcast(&worker_pool.wake);
+    pthread_mutex_unlock(&worker_pool.lock);
+    
+    for (int i = 0; i < worker_pool.count; i++) {
+        pthread_join(worker_pool.workers[i].thread, NULL);
+        faeb_timer_wheel_clear(&worker_pool.workers[i].timers);
+    }
+    
+    free(worker_pool.workers);
+    worker_pool.workers = NULL;
+    worker_pool.count = 0;
+    worker_pool.inject_head = NULL;
+    worker_pool.inject_tail = NULL;
+    atomic_store(&worker_pool.inject_count, 0);
+    atomic_store(&worker_pool.outstanding, 0);
+}
+
+int faeb_scheduler_get_worker_count(void) {
+    return worker_pool.count;
+}
+
+int faeb_scheduler_get_worker_cpu(int worker) {
+    if (worker < 0 || worker >= worker_pool.count) {
+        return -1;
+    }
+    return worker_pool.workers[worker].cpu;
 }
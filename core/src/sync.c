@@ -0,0 +1,306 @@
+/* faeb Core Runtime - Process Synchronization
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#include "internal.h"
+#include <stdlib.h>
+
+// Every object is a small state word plus a FIFO of parked processes,
+// both guarded by one lock. Waiting links the process into the queue and
+// switches away; waking unlinks the head and requeues it, so neither
+// depends on how many processes are blocked elsewhere.
+
+struct faeb_event {
+    pthread_mutex_t lock;
+    faeb_wait_queue_t waiters;
+    bool signaled;
+    bool auto_reset;
+};
+
+struct faeb_semaphore {
+    pthread_mutex_t lock;
+    faeb_wait_queue_t waiters;
+    uint32_t count;
+};
+
+struct faeb_mutex {
+    pthread_mutex_t lock;
+    faeb_wait_queue_t waiters;
+    bool locked;
+    struct faeb_process* owner;   // NULL when held by a plain thread
+};
+
+struct faeb_cond {
+    pthread_mutex_t lock;
+    faeb_wait_queue_t waiters;
+};
+
+// Wake every waiter, oldest first
+static void wake_all(faeb_wait_queue_t* waiters) {
+    struct faeb_process* process;
+    while ((process = wait_queue_pop(waiters)) != NULL) {
+        faeb_process_wake(process);
+    }
+}
+
+// Create an event. An auto-reset event releases one waiter per set and
+// clears itself; a manual-reset event releases everyone until reset.
+faeb_event_t* faeb_event_create(bool auto_reset) {
+    faeb_event_t* event = calloc(1, sizeof(faeb_event_t));
+    if (!event) return NULL;
+    
+    pthread_mutex_init(&event->lock, NULL);
+    event->auto_reset = auto_reset;
+    return event;
+}
+
+// Destroy an event; processes still waiting on it stay blocked
+void faeb_event_destroy(faeb_event_t* event) {
+    if (!event) return;
+    
+    pthread_mutex_destroy(&event->lock);
+    free(event);
+}
+
+void faeb_event_set(faeb_event_t* event) {
+    if (!event) return;
+    
+    pthread_mutex_lock(&event->lock);
+    if (event->auto_reset) {
+        // Hand the signal straight to a waiter, or keep it for the next one
+        struct faeb_process* process = wait_queue_pop(&event->waiters);
+        if (process) {
+            faeb_process_wake(process);
+        } else {
+            event->signaled = true;
+        }
+    } else {
+        event->signaled = true;
+        wake_all(&event->waiters);
+    }
+    pthread_mutex_unlock(&event->lock);
+}
+
+void faeb_event_reset(faeb_event_t* event) {
+    if (!event) return;
+    
+    pthread_mutex_lock(&event->lock);
+    event->signaled = false;
+    pthread_mutex_unlock(&event->lock);
+}
+
+// Wait until the event is set. Outside of a process this only succeeds
+// when the event is already set.
+faeb_result_t faeb_event_wait(faeb_event_t* event) {
+    if (!event) return FAEB_ERROR_INVALID;
+    
+    pthread_mutex_lock(&event->lock);
+    if (event->signaled) {
+        if (event->auto_reset) {
+            event->signaled = false;
+        }
+        pthread_mutex_unlock(&event->lock);
+        return FAEB_SUCCESS;
+    }
+    if (!faeb_process_self()) {
+        pthread_mutex_unlock(&event->lock);
+        return FAEB_ERROR_INVALID;
+    }
+    
+    faeb_process_park(&event->waiters, &event->lock);
+    return FAEB_SUCCESS;
+}
+
+// Create a counting semaphore holding count units
+faeb_semaphore_t* faeb_semaphore_create(uint32_t count) {
+    faeb_semaphore_t* semaphore = calloc(1, sizeof(faeb_semaphore_t));
+    if (!semaphore) return NULL;
+    
+    pthread_mutex_init(&semaphore->lock, NULL);
+    semaphore->count = count;
+    return semaphore;
+}
+
+// Destroy a semaphore; processes still waiting on it stay blocked
+void faeb_semaphore_destroy(faeb_semaphore_t* semaphore) {
+    if (!semaphore) return;
+    
+    pthread_mutex_destroy(&semaphore->lock);
+    free(semaphore);
+}
+
+// Take one unit, waiting for a post when none are left. Outside of a
+// process this fails instead of waiting.
+faeb_result_t faeb_semaphore_wait(faeb_semaphore_t* semaphore) {
+    if (!semaphore) return FAEB_ERROR_INVALID;
+    
+    pthread_mutex_lock(&semaphore->lock);
+    if (semaphore->count > 0) {
+        semaphore->count--;
+        pthread_mutex_unlock(&semaphore->lock);
+        return FAEB_SUCCESS;
+    }
+    if (!faeb_process_self()) {
+        pthread_mutex_unlock(&semaphore->lock);
+        return FAEB_ERROR_INVALID;
+    }
+    
+    // The posting process hands its unit over directly
+    faeb_process_park(&semaphore->waiters, &semaphore->lock);
+    return FAEB_SUCCESS;
+}
+
+bool faeb_semaphore_try_wait(faeb_semaphore_t* semaphore) {
+    if (!semaphore) return false;
+    
+    pthread_mutex_lock(&semaphore->lock);
+    bool taken = semaphore->count > 0;
+    if (taken) {
+        semaphore->count--;
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    return taken;
+}
+
+// Return one unit, waking the longest waiter if there is one
+void faeb_semaphore_post(faeb_semaphore_t* semaphore) {
+    if (!semaphore) return;
+    
+    pthread_mutex_lock(&semaphore->lock);
+    struct faeb_process* process = wait_queue_pop(&semaphore->waiters);
+    if (process) {
+        faeb_process_wake(process);
+    } else {
+        semaphore->count++;
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+}
+
+faeb_mutex_t* faeb_mutex_create(void) {
+    faeb_mutex_t* mutex = calloc(1, sizeof(faeb_mutex_t));
+    if (!mutex) return NULL;
+    
+    pthread_mutex_init(&mutex->lock, NULL);
+    return mutex;
+}
+
+// Destroy a mutex; processes still waiting on it stay blocked
+void faeb_mutex_destroy(faeb_mutex_t* mutex) {
+    if (!mutex) return;
+    
+    pthread_mutex_destroy(&mutex->lock);
+    free(mutex);
+}
+
+// Acquire the mutex, waiting behind earlier lockers. Ownership passes
+// directly from unlocker to the next waiter, so a woken process never
+// has to compete for it again. Relocking from the owning process, or
+// contention outside of a process, fails.
+faeb_result_t faeb_mutex_lock(faeb_mutex_t* mutex) {
+    if (!mutex) return FAEB_ERROR_INVALID;
+    
+    struct faeb_process* self = faeb_process_self();
+    pthread_mutex_lock(&mutex->lock);
+    if (!mutex->locked) {
+        mutex->locked = true;
+        mutex->owner = self;
+        pthread_mutex_unlock(&mutex->lock);
+        return FAEB_SUCCESS;
+    }
+    if (!self || mutex->owner == self) {
+        pthread_mutex_unlock(&mutex->lock);
+        return FAEB_ERROR_INVALID;
+    }
+    
+    faeb_process_park(&mutex->waiters, &mutex->lock);
+    return FAEB_SUCCESS;
+}
+
+bool faeb_mutex_try_lock(faeb_mutex_t* mutex) {
+    if (!mutex) return false;
+    
+    pthread_mutex_lock(&mutex->lock);
+    bool acquired = !mutex->locked;
+    if (acquired) {
+        mutex->locked = true;
+        mutex->owner = faeb_process_self();
+    }
+    pthread_mutex_unlock(&mutex->lock);
+    return acquired;
+}
+
+// Release the mutex, handing it to the longest waiter if there is one
+faeb_result_t faeb_mutex_unlock(faeb_mutex_t* mutex) {
+    if (!mutex) return FAEB_ERROR_INVALID;
+    
+    pthread_mutex_lock(&mutex->lock);
+    if (!mutex->locked || mutex->owner != faeb_process_self()) {
+        pthread_mutex_unlock(&mutex->lock);
+        return FAEB_ERROR_INVALID;
+    }
+    
+    struct faeb_process* process = wait_queue_pop(&mutex->waiters);
+    if (process) {
+        mutex->owner = process;
+        faeb_process_wake(process);
+    } else {
+        mutex->locked = false;
+        mutex->owner = NULL;
+    }
+    pthread_mutex_unlock(&mutex->lock);
+    return FAEB_SUCCESS;
+}
+
+faeb_cond_t* faeb_cond_create(void) {
+    faeb_cond_t* cond = calloc(1, sizeof(faeb_cond_t));
+    if (!cond) return NULL;
+    
+    pthread_mutex_init(&cond->lock, NULL);
+    return cond;
+}
+
+// Destroy a condition variable; processes still waiting on it stay blocked
+void faeb_cond_destroy(faeb_cond_t* cond) {
+    if (!cond) return;
+    
+    pthread_mutex_destroy(&cond->lock);
+    free(cond);
+}
+
+// Release mutex and wait for a signal, then reacquire mutex. The
+// condition lock is taken before the mutex is released, so a signal sent
+// in between cannot be lost. Only processes can wait.
+faeb_result_t faeb_cond_wait(faeb_cond_t* cond, faeb_mutex_t* mutex) {
+    struct faeb_process* self = faeb_process_self();
+    if (!cond || !mutex || !self) return FAEB_ERROR_INVALID;
+    
+    pthread_mutex_lock(&cond->lock);
+    if (faeb_mutex_unlock(mutex) != FAEB_SUCCESS) {
+        pthread_mutex_unlock(&cond->lock);
+        return FAEB_ERROR_INVALID;
+    }
+    faeb_process_park(&cond->waiters, &cond->lock);
+    
+    return faeb_mutex_lock(mutex);
+}
+
+// Wake the longest waiter
+void faeb_cond_signal(faeb_cond_t* cond) {
+    if (!cond) return;
+    
+    pthread_mutex_lock(&cond->lock);
+    struct faeb_process* process = wait_queue_pop(&cond->waiters);
+    if (process) {
+        faeb_process_wake(process);
+    }
+    pthread_mutex_unlock(&cond->lock);
+}
+
+void faeb_cond_broadcast(faeb_cond_t* cond) {
+    if (!cond) return;
+    
+    pthread_mutex_lock(&cond->lock);
+    wake_all(&cond->waiters);
+    pthread_mutex_unlock(&cond->lock);
+}
@@ -0,0 +1,247 @@
+/* faeb Core Runtime - Timer Wheel
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+// Wheel in use by the scheduling loop running on this thread
+static _Thread_local faeb_timer_wheel_t* local_wheel = NULL;
+
+// Monotonic timestamp in nanoseconds
+uint64_t faeb_timer_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t faeb_timer_now(void) {
+    return faeb_timer_now_ns() / FAEB_TIMER_TICK_NS;
+}
+
+// Tick at which a timer of milliseconds from now is due, rounded up so
+// timers never fire early
+uint64_t faeb_timer_deadline(uint64_t milliseconds) {
+    uint64_t ns = faeb_timer_now_ns() + milliseconds * 1000000ULL;
+    return (ns + FAEB_TIMER_TICK_NS - 1) / FAEB_TIMER_TICK_NS;
+}
+
+// Block the calling thread until the monotonic clock reaches tick
+void faeb_timer_sleep_until(uint64_t tick) {
+    faeb_timer_sleep_until_ns(tick * FAEB_TIMER_TICK_NS);
+}
+
+void faeb_timer_sleep_until_ns(uint64_t ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns / 1000000000ULL);
+    ts.tv_nsec = (long)(ns % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        // Interrupted by a signal; the deadline is absolute
+    }
+}
+
+void faeb_timer_wheel_init(faeb_timer_wheel_t* wheel,
+                           void (*ready)(struct faeb_process* process)) {
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->now = faeb_timer_now();
+    wheel->ready = ready;
+}
+
+void faeb_timer_set_local(faeb_timer_wheel_t* wheel) {
+    local_wheel = wheel;
+}
+
+faeb_timer_wheel_t* faeb_timer_get_local(void) {
+    return local_wheel;
+}
+
+// Place a timer in the slot matching its distance from the wheel's now:
+// level L holds timers due within 64^(L+1) ticks, indexed by bits
+// [6L, 6L+6) of the due tick. Timers beyond the top level are parked at
+// the horizon and re-inserted when they come round.
+static void wheel_insert(faeb_timer_wheel_t* wheel, faeb_timer_t* timer) {
+    uint64_t horizon = (uint64_t)1 << (FAEB_TIMER_LEVEL_BITS * FAEB_TIMER_LEVELS);
+    uint64_t due = timer->expires;
+    if (due - wheel->now >= horizon) {
+        due = wheel->now + horizon - 1;
+    }
+    
+    uint64_t delta = due - wheel->now;
+    int level = 0;
+    while (delta >> (FAEB_TIMER_LEVEL_BITS * (level + 1))) {
+        level++;
+    }
+    size_t slot = (size_t)((due >> (FAEB_TIMER_LEVEL_BITS * level)) &
+                           (FAEB_TIMER_SLOTS - 1));
+    
+    faeb_timer_t* head = wheel->slots[level][slot];
+    timer->prev = NULL;
+    timer->next = head;
+    if (head) {
+        head->prev = timer;
+    }
+    wheel->slots[level][slot] = timer;
+    wheel->occupied[level] |= (uint64_t)1 << slot;
+    timer->level = (uint8_t)level;
+    timer->slot = (uint8_t)slot;
+}
+
+static void wheel_unlink(faeb_timer_wheel_t* wheel, faeb_timer_t* timer) {
+    if (timer->prev) {
+        timer->prev->next = timer->next;
+    } else {
+        wheel->slots[timer->level][timer->slot] = timer->next;
+        if (!timer->next) {
+            wheel->occupied[timer->level] &= ~((uint64_t)1 << timer->slot);
+        }
+    }
+    if (timer->next) {
+        timer->next->prev = timer->prev;
+    }
+    timer->next = NULL;
+    timer->prev = NULL;
+}
+
+// Arm a timer to fire at an absolute tick; re-arming moves it
+void faeb_timer_arm(faeb_timer_wheel_t* wheel, faeb_timer_t* timer,
+                    uint64_t expires) {
+    faeb_timer_cancel(timer);
+    
+    // Already due: fire on the next advance rather than a lap later
+    if (expires <= wheel->now) {
+        expires = wheel->now + 1;
+    }
+    timer->expires = expires;
+    timer->wheel = wheel;
+    wheel_insert(wheel, timer);
+    wheel->count++;
+}
+
+// Disarm a pending timer; a no-op when it is not pending
+void faeb_timer_cancel(faeb_timer_t* timer) {
+    faeb_timer_wheel_t* wheel = timer->wheel;
+    if (!wheel) return;
+    
+    wheel_unlink(wheel, timer);
+    timer->wheel = NULL;
+    wheel->count--;
+}
+
+// Disarm every pending timer without firing it, so the wheel can be
+// freed while the timers' owners live on
+void faeb_timer_wheel_clear(faeb_timer_wheel_t* wheel) {
+    for (int level = 0; level < FAEB_TIMER_LEVELS; level++) {
+        for (size_t slot = 0; slot < FAEB_TIMER_SLOTS; slot++) {
+            faeb_timer_t* timer = wheel->slots[level][slot];
+            while (timer) {
+                faeb_timer_t* next = timer->next;
+                timer->next = NULL;
+                timer->prev = NULL;
+                timer->wheel = NULL;
+                timer = next;
+            }
+            wheel->slots[level][slot] = NULL;
+        }
+        wheel->occupied[level] = 0;
+    }
+    wheel->count = 0;
+}
+
+// Re-insert every timer of an upper-level slot relative to the new now
+static void wheel_cascade(faeb_timer_wheel_t* wheel, int level) {
+    size_t slot = (size_t)((wheel->now >> (FAEB_TIMER_LEVEL_BITS * level)) &
+                           (FAEB_TIMER_SLOTS - 1));
+    faeb_timer_t* timer = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    wheel->occupied[level] &= ~((uint64_t)1 << slot);
+    
+    while (timer) {
+        faeb_timer_t* next = timer->next;
+        wheel_insert(wheel, timer);
+        timer = next;
+    }
+}
+
+// Fire everything due at the wheel's current tick
+static size_t wheel_fire(faeb_timer_wheel_t* wheel) {
+    size_t slot = (size_t)(wheel->now & (FAEB_TIMER_SLOTS - 1));
+    size_t fired = 0;
+    
+    faeb_timer_t* timer;
+    while ((timer = wheel->slots[0][slot]) != NULL) {
+        wheel_unlink(wheel, timer);
+        if (timer->expires > wheel->now) {
+            // Came round from the horizon; lands in a different slot
+            wheel_insert(wheel, timer);
+            continue;
+        }
+        timer->wheel = NULL;
+        wheel->count--;
+        timer->fire(wheel, timer);
+        fired++;
+    }
+    return fired;
+}
+
+// Advance the wheel to tick, firing expired timers in order. The wheel
+// jumps straight from one occupied slot or cascade boundary to the next,
+// so idle stretches cost nothing per tick.
+size_t faeb_timer_advance(faeb_timer_wheel_t* wheel, uint64_t tick) {
+    size_t fired = 0;
+    
+    while (wheel->now < tick) {
+        uint64_t next = faeb_timer_next(wheel);
+        if (next > tick) {
+            wheel->now = tick;
+            break;
+        }
+        wheel->now = next;
+        
+        // At a 64^L boundary cascade levels L..1, highest first
+        int top = 0;
+        while (top + 1 < FAEB_TIMER_LEVELS &&
+               (wheel->now & (((uint64_t)1 << (FAEB_TIMER_LEVEL_BITS * (top + 1))) - 1)) == 0) {
+            top++;
+        }
+        for (int level = top; level >= 1; level--) {
+            wheel_cascade(wheel, level);
+        }
+        fired += wheel_fire(wheel);
+    }
+    
+    return fired;
+}
+
+// Earliest tick at which a timer could be due; UINT64_MAX when empty.
+// Upper levels report the boundary at which their next slot cascades,
+// which may be earlier than the timer itself but never later.
+uint64_t faeb_timer_next(faeb_timer_wheel_t* wheel) {
+    if (wheel->count == 0) return UINT64_MAX;
+    
+    uint64_t next = UINT64_MAX;
+    for (int level = 0; level < FAEB_TIMER_LEVELS; level++) {
+        uint64_t occupied = wheel->occupied[level];
+        if (!occupied) continue;
+        
+        int shift = FAEB_TIMER_LEVEL_BITS * level;
+        uint64_t block = wheel->now >> shift;
+        unsigned index = (unsigned)(block & (FAEB_TIMER_SLOTS - 1));
+        // Distance 1..64 to the next occupied slot after the current one
+        unsigned rotate = (index + 1) & (FAEB_TIMER_SLOTS - 1);
+        uint64_t rotated = rotate ? (occupied >> rotate) | (occupied << (64 - rotate))
+                                  : occupied;
+        uint64_t distance = (uint64_t)__builtin_ctzll(rotated) + 1;
+        uint64_t due = (block + distance) << shift;
+        if (due < next) {
+            next = due;
+        }
+    }
+    
+    return next;
+}
@@ -0,0 +1,378 @@
+/* faeb Core Runtime - CPU Topology and Placement
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#define _GNU_SOURCE
+
+#include "internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+
+// The topology is read from /sys once, on first use; CPUs brought online
+// later are not seen. Without /sys every online CPU is its own core in
+// package, node and cache domain 0.
+#define FAEB_TOPOLOGY_SYSFS "/sys/devices/system"
+#define FAEB_TOPOLOGY_LIST_SIZE 4096
+#define FAEB_TOPOLOGY_MAX_NODES 1024
+#define FAEB_TOPOLOGY_MAX_CACHES 16
+
+static struct {
+    pthread_once_t once;
+    faeb_cpu_info_t* cpus;     // Online CPUs in ascending order
+    faeb_topology_t summary;
+    int cpu_limit;             // Highest online CPU + 1, for CPU sets
+    int* placement;            // Default placement order
+    size_t placement_count;
+} topology = { .once = PTHREAD_ONCE_INIT };
+
+// Read the first line of a sysfs file, without its newline
+static bool read_line(const char* path, char* buffer, size_t size) {
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+    
+    bool read = fgets(buffer, (int)size, file) != NULL;
+    fclose(file);
+    if (read) {
+        buffer[strcspn(buffer, "\n")] = '\0';
+    }
+    return read;
+}
+
+static int read_int(const char* path, int fallback) {
+    char line[32];
+    return read_line(path, line, sizeof(line)) ? atoi(line) : fallback;
+}
+
+// Parse a kernel CPU or node list such as "0-3,8,10-11" into ascending
+// numbers; returns how many there are, storing at most max
+static size_t list_parse(const char* list, int* out, size_t max) {
+    size_t count = 0;
+    const char* cursor = list;
+    while (*cursor) {
+        char* end;
+        long first = strtol(cursor, &end, 10);
+        if (end == cursor) break;
+        long last = first;
+        if (*end == '-') {
+            cursor = end + 1;
+            last = strtol(cursor, &end, 10);
+            if (end == cursor) break;
+        }
+        for (long n = first; n <= last; n++) {
+            if (count < max) out[count] = (int)n;
+            count++;
+        }
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    return count;
+}
+
+// Dense number for key among the keys seen so far, adding it if new
+static int dense_id(int* keys, int* count, int key) {
+    for (int i = 0; i < *count; i++) {
+        if (keys[i] == key) return i;
+    }
+    keys[*count] = key;
+    return (*count)++;
+}
+
+// Identify a CPU's last-level cache by the lowest CPU sharing it
+static int cache_key(int cpu) {
+    char path[128];
+    char line[FAEB_TOPOLOGY_LIST_SIZE];
+    int best_level = -1;
+    int key = cpu;
+    for (int index = 0; index < FAEB_TOPOLOGY_MAX_CACHES; index++) {
+        snprintf(path, sizeof(path), FAEB_TOPOLOGY_SYSFS "/cpu/cpu%d/cache/index%d/type",
+                 cpu, index);
+        if (!read_line(path, line, sizeof(line))) break;
+        if (strcmp(line, "Instruction") == 0) continue;
+        
+        snprintf(path, sizeof(path), FAEB_TOPOLOGY_SYSFS "/cpu/cpu%d/cache/index%d/level",
+                 cpu, index);
+        int level = read_int(path, -1);
+        snprintf(path, sizeof(path),
+                 FAEB_TOPOLOGY_SYSFS "/cpu/cpu%d/cache/index%d/shared_cpu_list", cpu, index);
+        int first;
+        if (level > best_level && read_line(path, line, sizeof(line)) &&
+            list_parse(line, &first, 1) > 0) {
+            best_level = level;
+            key = first;
+        }
+    }
+    return key;
+}
+
+static faeb_cpu_info_t* topology_find(int cpu) {
+    for (int i = 0; i < topology.summary.cpus; i++) {
+        if (topology.cpus[i].cpu == cpu) return &topology.cpus[i];
+    }
+    return NULL;
+}
+
+// Default placement visits every core before any second hardware
+// thread, and fills a node before moving to the next
+static int placement_compare(const void* a, const void* b) {
+    const faeb_cpu_info_t* x = &topology.cpus[*(const int*)a];
+    const faeb_cpu_info_t* y = &topology.cpus[*(const int*)b];
+    if (x->thread != y->thread) return x->thread - y->thread;
+    if (x->node != y->node) return x->node - y->node;
+    if (x->cache != y->cache) return x->cache - y->cache;
+    if (x->core != y->core) return x->core - y->core;
+    return x->cpu - y->cpu;
+}
+
+// Fill in the CPU table from /sys, using members as scratch space for
+// parsed lists
+static bool topology_scan(size_t count, const int* online, char* line, int* members) {
+    char path[128];
+    topology.cpus = calloc(count, sizeof(faeb_cpu_info_t));
+    topology.placement = malloc(count * sizeof(int));
+    int* cores = malloc(count * sizeof(int));
+    int* packages = malloc(count * sizeof(int));
+    int* caches = malloc(count * sizeof(int));
+    if (!topology.cpus || !topology.placement || !cores || !packages || !caches) {
+        free(topology.cpus);
+        free(topology.placement);
+        free(cores);
+        free(packages);
+        free(caches);
+        topology.cpus = NULL;
+        return false;
+    }
+    
+    int core_count = 0, package_count = 0, cache_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        faeb_cpu_info_t* info = &topology.cpus[i];
+        int cpu = online[i];
+        info->cpu = cpu;
+        
+        snprintf(path, sizeof(path),
+                 FAEB_TOPOLOGY_SYSFS "/cpu/cpu%d/topology/physical_package_id", cpu);
+        int package = read_int(path, 0);
+        snprintf(path, sizeof(path), FAEB_TOPOLOGY_SYSFS "/cpu/cpu%d/topology/core_id", cpu);
+        int core = read_int(path, cpu);
+        info->package = dense_id(packages, &package_count, package);
+        
+        // Cores are numbered per package; make them unique across packages
+        info->core = dense_id(cores, &core_count, info->package * 65536 + core);
+        info->cache = dense_id(caches, &cache_count, cache_key(cpu));
+        
+        // Position among the core's hardware threads
+        snprintf(path, sizeof(path),
+                 FAEB_TOPOLOGY_SYSFS "/cpu/cpu%d/topology/thread_siblings_list", cpu);
+        if (read_line(path, line, FAEB_TOPOLOGY_LIST_SIZE)) {
+            size_t n = list_parse(line, members, FAEB_TOPOLOGY_LIST_SIZE);
+            for (size_t s = 0; s < n && s < FAEB_TOPOLOGY_LIST_SIZE && members[s] != cpu; s++) {
+                info->thread++;
+            }
+        }
+    }
+    free(cores);
+    free(packages);
+    free(caches);
+    
+    topology.summary.cpus = (int)count;
+    topology.summary.cores = core_count;
+    topology.summary.packages = package_count;
+    topology.summary.caches = cache_count;
+    topology.summary.nodes = 1;
+    
+    // Nodes list their CPUs; without NUMA everything is on node 0
+    int nodes[FAEB_TOPOLOGY_MAX_NODES];
+    size_t node_count = 0;
+    if (read_line(FAEB_TOPOLOGY_SYSFS "/node/online", line, FAEB_TOPOLOGY_LIST_SIZE)) {
+        node_count = list_parse(line, nodes, FAEB_TOPOLOGY_MAX_NODES);
+        if (node_count > FAEB_TOPOLOGY_MAX_NODES) node_count = FAEB_TOPOLOGY_MAX_NODES;
+    }
+    if (node_count > 0) {
+        topology.summary.nodes = (int)node_count;
+    }
+    for (size_t n = 0; n < node_count; n++) {
+        snprintf(path, sizeof(path), FAEB_TOPOLOGY_SYSFS "/node/node%d/cpulist", nodes[n]);
+        if (!read_line(path, line, FAEB_TOPOLOGY_LIST_SIZE)) continue;
+        size_t listed = list_parse(line, members, FAEB_TOPOLOGY_LIST_SIZE);
+        for (size_t m = 0; m < listed && m < FAEB_TOPOLOGY_LIST_SIZE; m++) {
+            faeb_cpu_info_t* info = topology_find(members[m]);
+            if (info) info->node = nodes[n];
+        }
+    }
+    
+    // Isolated CPUs only run what is placed on them explicitly
+    if (read_line(FAEB_TOPOLOGY_SYSFS "/cpu/isolated", line, FAEB_TOPOLOGY_LIST_SIZE)) {
+        size_t listed = list_parse(line, members, FAEB_TOPOLOGY_LIST_SIZE);
+        for (size_t m = 0; m < listed && m < FAEB_TOPOLOGY_LIST_SIZE; m++) {
+            faeb_cpu_info_t* info = topology_find(members[m]);
+            if (info && !info->isolated) {
+                info->isolated = true;
+                topology.summary.isolated++;
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        if (!topology.cpus[i].isolated) {
+            topology.placement[topology.placement_count++] = (int)i;
+        }
+    }
+    qsort(topology.placement, topology.placement_count, sizeof(int), placement_compare);
+    for (size_t i = 0; i < topology.placement_count; i++) {
+        topology.placement[i] = topology.cpus[topology.placement[i]].cpu;
+    }
+    
+    // CPU sets cover every CPU the kernel may report, not just online ones
+    topology.cpu_limit = CPU_SETSIZE;
+    if (read_line(FAEB_TOPOLOGY_SYSFS "/cpu/possible", line, FAEB_TOPOLOGY_LIST_SIZE)) {
+        size_t possible = list_parse(line, members, FAEB_TOPOLOGY_LIST_SIZE);
+        if (possible > 0 && possible <= FAEB_TOPOLOGY_LIST_SIZE &&
+            members[possible - 1] >= topology.cpu_limit) {
+            topology.cpu_limit = members[possible - 1] + 1;
+        }
+    }
+    if (online[count - 1] >= topology.cpu_limit) {
+        topology.cpu_limit = online[count - 1] + 1;
+    }
+    return true;
+}
+
+static void topology_load(void) {
+    char* line = malloc(FAEB_TOPOLOGY_LIST_SIZE);
+    int* online = malloc(FAEB_TOPOLOGY_LIST_SIZE * sizeof(int));
+    int* members = malloc(FAEB_TOPOLOGY_LIST_SIZE * sizeof(int));
+    if (line && online && members) {
+        size_t count = 0;
+        if (read_line(FAEB_TOPOLOGY_SYSFS "/cpu/online", line, FAEB_TOPOLOGY_LIST_SIZE)) {
+            count = list_parse(line, online, FAEB_TOPOLOGY_LIST_SIZE);
+        }
+        if (count == 0 || count > FAEB_TOPOLOGY_LIST_SIZE) {
+            long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+            count = cpus > 0 ? (size_t)cpus : 1;
+            if (count > FAEB_TOPOLOGY_LIST_SIZE) count = FAEB_TOPOLOGY_LIST_SIZE;
+            for (size_t i = 0; i < count; i++) {
+                online[i] = (int)i;
+            }
+        }
+        topology_scan(count, online, line, members);
+    }
+    free(line);
+    free(online);
+    free(members);
+}
+
+static bool topology_ready(void) {
+    pthread_once(&topology.once, topology_load);
+    return topology.cpus != NULL;
+}
+
+faeb_result_t faeb_topology_get(faeb_topology_t* summary) {
+    if (!summary) return FAEB_ERROR_INVALID;
+    if (!topology_ready()) return FAEB_ERROR_IO;
+    
+    *summary = topology.summary;
+    return FAEB_SUCCESS;
+}
+
+// Copy up to count online CPUs and return how many there are in total
+size_t faeb_topology_get_cpus(faeb_cpu_info_t* cpus, size_t count) {
+    if (!topology_ready()) return 0;
+    
+    size_t total = (size_t)topology.summary.cpus;
+    if (cpus) {
+        memcpy(cpus, topology.cpus, (count < total ? count : total) * sizeof(*cpus));
+    }
+    return total;
+}
+
+size_t faeb_topology_placement(const int* cpus, size_t count, int* out, size_t max) {
+    if (!topology_ready()) return 0;
+    
+    if (!cpus) {
+        cpus = topology.placement;
+        count = topology.placement_count;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!topology_find(cpus[i])) return 0;
+    }
+    
+    size_t stored = count < max ? count : max;
+    memcpy(out, cpus, stored * sizeof(*out));
+    return count;
+}
+
+// Build a CPU set of cpus, or every online CPU when cpus is NULL
+static cpu_set_t* cpuset_create(const int* cpus, size_t count, size_t* size) {
+    cpu_set_t* set = CPU_ALLOC(topology.cpu_limit);
+    if (!set) return NULL;
+    
+    *size = CPU_ALLOC_SIZE(topology.cpu_limit);
+    CPU_ZERO_S(*size, set);
+    if (cpus) {
+        for (size_t i = 0; i < count; i++) {
+            CPU_SET_S(cpus[i], *size, set);
+        }
+    } else {
+        for (int i = 0; i < topology.summary.cpus; i++) {
+            CPU_SET_S(topology.cpus[i].cpu, *size, set);
+        }
+    }
+    return set;
+}
+
+faeb_result_t faeb_topology_attr_set(pthread_attr_t* attr, const int* cpus, size_t count) {
+    if (!topology_ready()) return FAEB_ERROR_IO;
+    
+    size_t size;
+    cpu_set_t* set = cpuset_create(cpus, count, &size);
+    if (!set) return FAEB_ERROR_MEMORY;
+    
+    int error = pthread_attr_setaffinity_np(attr, size, set);
+    CPU_FREE(set);
+    return error == 0 ? FAEB_SUCCESS : FAEB_ERROR_INVALID;
+}
+
+// Confine the calling thread to cpus, or let it run on every online CPU
+// again when cpus is NULL
+faeb_result_t faeb_topology_pin_thread(const int* cpus, size_t count) {
+    if (cpus && count == 0) return FAEB_ERROR_INVALID;
+    if (!topology_ready()) return FAEB_ERROR_IO;
+    for (size_t i = 0; cpus && i < count; i++) {
+        if (!topology_find(cpus[i])) return FAEB_ERROR_INVALID;
+    }
+    
+    size_t size;
+    cpu_set_t* set = cpuset_create(cpus, count, &size);
+    if (!set) return FAEB_ERROR_MEMORY;
+    
+    int error = pthread_setaffinity_np(pthread_self(), size, set);
+    CPU_FREE(set);
+    return error == 0 ? FAEB_SUCCESS : FAEB_ERROR_INVALID;
+}
+
+// The node every CPU the calling thread may run on belongs to, or -1
+// when they span several
+int faeb_topology_current_node(void) {
+    if (!topology_ready()) return -1;
+    
+    size_t size;
+    cpu_set_t* set = cpuset_create(NULL, 0, &size);
+    if (!set) return -1;
+    
+    int node = -1;
+    if (pthread_getaffinity_np(pthread_self(), size, set) == 0) {
+        for (int i = 0; i < topology.summary.cpus; i++) {
+            const faeb_cpu_info_t* info = &topology.cpus[i];
+            if (!CPU_ISSET_S(info->cpu, size, set)) continue;
+            if (node >= 0 && info->node != node) {
+                node = -1;
+                break;
+            }
+            node = info->node;
+        }
+    }
+    CPU_FREE(set);
+    return node;
+}
@@ -54,7 +54,20 @@ gcc -o test_faeb \
     tests/test_process.c \
     tests/test_io.c \
     tests/test_scheduler.c \
-    tests/test_verification.c
+    tests/test_sync.c \
+    tests/test_channel.c \
+    tests/test_future.c \
+    tests/test_parallel.c \
+    tests/test_verification.c \
+    -lpthread
+
+# The coroutine wrappers need C++20
+g++ -std=c++20 -o test_faeb_coroutines \
+    -I./core/include \
+    tests/test_future_coroutines.cpp \
+    -L./build/core \
+    -lfaeb-runtime \
+    -lpthread
 
 # Run tests
 echo "${BLUE}🚀 Starting test execution...${NC}"
@@ -69,6 +82,33 @@ run_test "Memory Management - Boundary Checks" \
 run_test "Memory Management - Cleanup" \
     "echo 'Testing memory cleanup...' && ./test_faeb --test memory_cleanup"
 
+run_test "Memory Management - Foreign Free" \
+    "echo 'Testing foreign pointer rejection...' && ./test_faeb --test memory_foreign_free"
+
+run_test "Memory Management - Arena" \
+    "echo 'Testing arena allocation...' && ./test_faeb --test memory_arena"
+
+run_test "Memory Management - Slab Classes" \
+    "echo 'Testing slab allocation...' && ./test_faeb --test memory_slab"
+
+run_test "Memory Management - Concurrency" \
+    "echo 'Testing concurrent allocation...' && ./test_faeb --test memory_threads"
+
+run_test "Memory Management - Mapped Regions" \
+    "echo 'Testing mmap-backed pools...' && ./test_faeb --test memory_mmap"
+
+run_test "Memory Management - Aligned Allocation" \
+    "echo 'Testing aligned allocation...' && ./test_faeb --test memory_aligned"
+
+run_test "Memory Management - Reallocation" \
+    "echo 'Testing reallocation...' && ./test_faeb --test memory_reallocate"
+
+run_test "Memory Management - Telemetry" \
+    "echo 'Testing allocation telemetry...' && ./test_faeb --test memory_stats"
+
+run_test "Memory Management - Batch Calls" \
+    "echo 'Testing batch allocation...' && ./test_faeb --test memory_batch"
+
 # Test 2: Process Management
 run_test "Process Management - Creation" \
     "echo 'Testing process creation...' && ./test_faeb --test process_creation"
@@ -79,6 +119,18 @@ run_test "Process Management - Scheduling" \
 run_test "Process Management - Destruction" \
     "echo 'Testing process destruction...' && ./test_faeb --test process_destruction"
 
+run_test "Process Management - Stackful Yield" \
+    "echo 'Testing yield and resume...' && ./test_faeb --test process_coroutine"
+
+run_test "Process Management - Priorities" \
+    "echo 'Testing priority run queues...' && ./test_faeb --test process_priority"
+
+run_test "Process Management - Sleep" \
+    "echo 'Testing timer wheel sleeps...' && ./test_faeb --test process_sleep"
+
+run_test "Process Management - Recycling" \
+    "echo 'Testing process and stack recycling...' && ./test_faeb --test process_recycling"
+
 # Test 3: I/O Operations
 run_test "I/O Operations - Basic Read/Write" \
     "echo 'Testing I/O operations...' && ./test_faeb --test io_basic"
@@ -86,6 +138,12 @@ run_test "I/O Operations - Basic Read/Write" \
 run_test "I/O Operations - Error Handling" \
     "echo 'Testing I/O error handling...' && ./test_faeb --test io_errors"
 
+run_test "I/O Operations - Asynchronous Engine" \
+    "echo 'Testing processes parking on io_uring and thread-pool I/O...' && ./test_faeb --test io_async"
+
+run_test "I/O Operations - Readiness Reactor" \
+    "echo 'Testing processes waiting on descriptor readiness...' && ./test_faeb --test io_reactor"
+
 # Test 4: Scheduler
 run_test "Scheduler - Basic Scheduling" \
     "echo 'Testing scheduler...' && ./test_faeb --test scheduler_basic"
@@ -93,6 +151,51 @@ run_test "Scheduler - Basic Scheduling" \
 run_test "Scheduler - Time Slices" \
     "echo 'Testing time slices...' && ./test_faeb --test scheduler_timeslices"
 
+run_test "Scheduler - Worker Pool" \
+    "echo 'Testing work-stealing workers...' && ./test_faeb --test scheduler_workers"
+
+run_test "Scheduler - Timeouts" \
+    "echo 'Testing timed blocks and slice accounting...' && ./test_faeb --test scheduler_timeouts"
+
+run_test "Scheduler - Statistics" \
+    "echo 'Testing per-process and scheduler counters...' && ./test_faeb --test scheduler_stats"
+
+run_test "Scheduler - Instances" \
+    "echo 'Testing private schedulers and cross-thread wakes...' && ./test_faeb --test scheduler_instances"
+
+run_test "Scheduler - Deadlines" \
+    "echo 'Testing EDF admission, ordering and deadline misses...' && ./test_faeb --test scheduler_deadlines"
+
+run_test "Scheduler - Placement" \
+    "echo 'Testing topology, worker pinning and node-local pools...' && ./test_faeb --test scheduler_placement"
+
+run_test "Scheduler - Synchronization" \
+    "echo 'Testing events, semaphores, mutexes and condvars...' && ./test_faeb --test sync_primitives"
+
+run_test "Scheduler - Synchronization on Workers" \
+    "echo 'Testing wait objects across worker threads...' && ./test_faeb --test sync_workers"
+
+run_test "Scheduler - Channels" \
+    "echo 'Testing SPSC and MPMC channels...' && ./test_faeb --test channel_basic"
+
+run_test "Scheduler - Channel Fan-in" \
+    "echo 'Testing channels across worker threads...' && ./test_faeb --test channel_workers"
+
+run_test "Futures - Basic" \
+    "echo 'Testing await, continuations and combinators...' && ./test_faeb --test future_basic"
+
+run_test "Futures - Workers" \
+    "echo 'Testing fan-out across workers and cross-thread completion...' && ./test_faeb --test future_workers"
+
+run_test "Futures - C++20 Coroutines" \
+    "echo 'Testing co_await, when_any/when_all and get...' && ./test_faeb_coroutines"
+
+run_test "Parallel - Loops" \
+    "echo 'Testing parallel_for coverage and guided chunking...' && ./test_faeb --test parallel_for"
+
+run_test "Parallel - Task Graphs" \
+    "echo 'Testing dependency order of task graphs on workers...' && ./test_faeb --test parallel_graph"
+
 # Test 5: Verification
 run_test "Verification - Memory Safety" \
     "echo 'Testing memory safety verification...' && ./test_faeb --test verification_memory"
@@ -114,9 +217,69 @@ run_test "Integration - Complete Workflow" \
 run_test "Performance - Memory Allocation" \
     "echo 'Testing memory allocation performance...' && ./test_faeb --test performance_memory"
 
+run_test "Performance - Memory Free Latency" \
+    "echo 'Testing free latency scaling...' && ./test_faeb --test performance_memory_free"
+
+run_test "Performance - Slab Allocation" \
+    "echo 'Testing slab allocation performance...' && ./test_faeb --test performance_memory_slab"
+
+run_test "Performance - Threaded Allocation" \
+    "echo 'Testing allocation scaling across threads...' && ./test_faeb --test performance_memory_threads"
+
+run_test "Performance - Buffer Append" \
+    "echo 'Testing amortized append throughput...' && ./test_faeb --test performance_memory_append"
+
+run_test "Performance - Batch Allocation" \
+    "echo 'Testing batch against per-object allocation...' && ./test_faeb --test performance_memory_batch"
+
 run_test "Performance - Process Switching" \
     "echo 'Testing process switching performance...' && ./test_faeb --test performance_process"
 
+run_test "Performance - Context Switch" \
+    "echo 'Testing context switch cost...' && ./test_faeb --test performance_process_switch"
+
+run_test "Performance - Priority Pick" \
+    "echo 'Testing pick cost against queue length...' && ./test_faeb --test performance_process_priority"
+
+run_test "Performance - Buffered Output" \
+    "echo 'Testing small-write throughput per buffering mode...' && ./test_faeb --test performance_io"
+
+run_test "Performance - Asynchronous Reads" \
+    "echo 'Testing 4 KiB read cost per I/O backend...' && ./test_faeb --test performance_io_async"
+
+run_test "Performance - Readiness Reactor" \
+    "echo 'Testing echo round trips over many connections...' && ./test_faeb --test performance_io_reactor"
+
+run_test "Performance - Spawn Rate" \
+    "echo 'Testing spawn-per-request throughput...' && ./test_faeb --test performance_process_spawn"
+
+run_test "Performance - Worker Scaling" \
+    "echo 'Testing throughput across worker counts...' && ./test_faeb --test performance_scheduler_workers"
+
+run_test "Performance - Timer Wheel" \
+    "echo 'Testing timer arm and cancel cost...' && ./test_faeb --test performance_scheduler_timers"
+
+run_test "Performance - Scheduler Statistics" \
+    "echo 'Testing stats read cost and queueing delay...' && ./test_faeb --test performance_scheduler_stats"
+
+run_test "Performance - Scheduler Shards" \
+    "echo 'Testing switch rate across private schedulers...' && ./test_faeb --test performance_scheduler_shards"
+
+run_test "Performance - Deadline Scheduling" \
+    "echo 'Testing release lateness under load, priority vs EDF...' && ./test_faeb --test performance_scheduler_deadlines"
+
+run_test "Performance - Wait Queues" \
+    "echo 'Testing handoff cost against blocked processes...' && ./test_faeb --test performance_sync"
+
+run_test "Performance - Channels" \
+    "echo 'Testing ping-pong and fan-in message rates...' && ./test_faeb --test performance_channel"
+
+run_test "Performance - Futures" \
+    "echo 'Testing spawn/await cost and fan-out latency...' && ./test_faeb --test performance_future"
+
+run_test "Performance - Parallel" \
+    "echo 'Testing loop scaling and graph dispatch cost...' && ./test_faeb --test performance_parallel"
+
 # Test 8: Stress Tests
 run_test "Stress - Memory Stress" \
     "echo 'Testing memory stress...' && ./test_faeb --test stress_memory"
@@ -0,0 +1,310 @@
+/* FAEB Test Suite - Channel Tests
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "faeb/runtime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+
+// Monotonic timestamp in nanoseconds
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// A message with some payload beyond the sequence number
+struct channel_message {
+    uint64_t sequence;
+    uint64_t sent_ns;
+    uint32_t producer;
+    uint32_t check;
+};
+
+struct channel_peer {
+    faeb_channel_t* in;
+    faeb_channel_t* out;
+    uint32_t id;
+    int messages;
+    int batch;
+    uint64_t sum;
+    int received;
+    int out_of_order;
+    uint64_t* latency;    // Optional per-message latencies
+    _Atomic int* producing;   // The last producer to finish closes out
+};
+
+// Sends 0..messages-1, batch at a time when batch > 1
+static void channel_producer(void* context) {
+    struct channel_peer* peer = context;
+    struct channel_message messages[64];
+    int batch = peer->batch > 1 ? peer->batch : 1;
+
+    for (int i = 0; i < peer->messages; i += batch) {
+        int n = peer->messages - i < batch ? peer->messages - i : batch;
+        for (int j = 0; j < n; j++) {
+            messages[j] = (struct channel_message){
+                .sequence = (uint64_t)(i + j), .sent_ns = now_ns(),
+                .producer = peer->id, .check = (uint32_t)(i + j) ^ 0x5a5a5a5au
+            };
+        }
+        if (n == 1) {
+            faeb_channel_send(peer->out, &messages[0]);
+        } else {
+            faeb_channel_send_batch(peer->out, messages, (size_t)n);
+        }
+    }
+    if (atomic_fetch_sub(peer->producing, 1) == 1) {
+        faeb_channel_close(peer->out);
+    }
+}
+
+// Receives until the channel is closed and drained, checking that each
+// producer's messages arrive intact and in order
+static void channel_consumer(void* context) {
+    struct channel_peer* peer = context;
+    struct channel_message messages[64];
+    uint64_t next[64] = { 0 };
+    int batch = peer->batch > 1 ? peer->batch : 1;
+
+    for (;;) {
+        size_t n = faeb_channel_receive_batch(peer->in, messages, (size_t)batch);
+        if (n == 0) break;
+        uint64_t now = now_ns();
+        for (size_t j = 0; j < n; j++) {
+            struct channel_message* message = &messages[j];
+            if (message->check != ((uint32_t)message->sequence ^ 0x5a5a5a5au) ||
+                message->sequence != next[message->producer % 64]) {
+                peer->out_of_order++;
+            }
+            next[message->producer % 64] = message->sequence + 1;
+            if (peer->latency) {
+                peer->latency[peer->received] = now - message->sent_ns;
+            }
+            peer->sum += message->sequence;
+            peer->received++;
+        }
+    }
+}
+
+// Non-blocking operations, wrap-around, batches and close on both kinds
+int test_channel_basic(void) {
+    faeb_channel_kind_t kinds[] = { FAEB_CHANNEL_SPSC, FAEB_CHANNEL_MPMC };
+
+    if (faeb_channel_create(FAEB_CHANNEL_MPMC, 0, 4)) return 1;
+    if (faeb_channel_create(FAEB_CHANNEL_MPMC, 8, 0)) return 2;
+
+    for (int k = 0; k < 2; k++) {
+        faeb_channel_t* channel = faeb_channel_create(kinds[k], sizeof(uint64_t), 3);
+        if (!channel) return 3;
+
+        // Capacity rounds up to 4; a full or empty channel refuses
+        // without blocking, and blocking calls outside a process fail
+        uint64_t value = 0;
+        for (uint64_t i = 0; i < 4; i++) {
+            if (!faeb_channel_try_send(channel, &i)) return 4;
+        }
+        if (faeb_channel_try_send(channel, &value)) return 5;
+        if (faeb_channel_send(channel, &value) != FAEB_ERROR_INVALID) return 6;
+
+        // Interleave so the indices wrap several times
+        for (uint64_t i = 0; i < 100; i++) {
+            if (!faeb_channel_try_receive(channel, &value) || value != i) return 7;
+            uint64_t next = i + 4;
+            if (!faeb_channel_try_send(channel, &next)) return 8;
+        }
+
+        // Batches move several at once and stop at what is there
+        uint64_t batch[8];
+        if (faeb_channel_receive_batch(channel, batch, 8) != 4) return 9;
+        if (batch[0] != 100 || batch[3] != 103) return 10;
+        if (faeb_channel_try_receive(channel, &value)) return 11;
+        uint64_t more[3] = { 7, 8, 9 };
+        if (faeb_channel_send_batch(channel, more, 3) != 3) return 12;
+        if (faeb_channel_send_batch(channel, more, 3) != 1) return 13;
+
+        // Closed: no more sends, the rest drains, then end of stream
+        faeb_channel_close(channel);
+        if (faeb_channel_try_send(channel, &value)) return 14;
+        if (faeb_channel_send(channel, &value) != FAEB_ERROR_INVALID) return 15;
+        if (faeb_channel_receive_batch(channel, batch, 8) != 4 || batch[3] != 7) return 16;
+        if (faeb_channel_receive(channel, &value) != FAEB_ERROR_IO) return 17;
+        faeb_channel_destroy(channel);
+    }
+
+    // Processes block on a tiny channel instead of failing
+    for (int k = 0; k < 2; k++) {
+        faeb_channel_t* channel = faeb_channel_create(kinds[k], sizeof(struct channel_message), 2);
+        if (!channel) return 18;
+        _Atomic int producing = 1;
+        struct channel_peer producer = { .out = channel, .messages = 500, .batch = k ? 1 : 7,
+                                         .producing = &producing };
+        struct channel_peer consumer = { .in = channel, .batch = k ? 5 : 1 };
+        faeb_process_t* processes[2];
+        processes[0] = faeb_process_create(channel_consumer, &consumer);
+        processes[1] = faeb_process_create(channel_producer, &producer);
+        if (!processes[0] || !processes[1]) return 19;
+
+        faeb_scheduler_run();
+
+        if (consumer.received != 500 || consumer.out_of_order || consumer.sum != 124750) return 20;
+        for (int i = 0; i < 2; i++) {
+            if (!faeb_process_is_terminated(processes[i])) return 21;
+            faeb_process_destroy(processes[i]);
+        }
+        faeb_channel_destroy(channel);
+    }
+    return 0;
+}
+
+// Many producers on the worker pool feed one consumer through an MPMC
+// channel; nothing is lost or reordered per producer
+int test_channel_workers(void) {
+    enum { PRODUCERS = 16, MESSAGES = 5000 };
+    static struct channel_peer producers[PRODUCERS];
+    static faeb_process_t* processes[PRODUCERS + 1];
+    _Atomic int producing = PRODUCERS;
+
+    faeb_channel_t* channel = faeb_channel_create(FAEB_CHANNEL_MPMC, sizeof(struct channel_message), 64);
+    if (!channel) return 1;
+    if (faeb_scheduler_init_workers(4) != FAEB_SUCCESS) return 2;
+
+    struct channel_peer consumer = { .in = channel, .batch = 16 };
+    processes[0] = faeb_process_create(channel_consumer, &consumer);
+    for (int i = 0; i < PRODUCERS; i++) {
+        producers[i] = (struct channel_peer){ .out = channel, .id = (uint32_t)i,
+                                              .messages = MESSAGES, .batch = i % 4 + 1,
+                                              .producing = &producing };
+        processes[i + 1] = faeb_process_create(channel_producer, &producers[i]);
+    }
+    for (int i = 0; i <= PRODUCERS; i++) {
+        if (!processes[i] || faeb_scheduler_submit(processes[i]) != FAEB_SUCCESS) return 3;
+    }
+    faeb_scheduler_wait();
+
+    uint64_t expected = (uint64_t)PRODUCERS * MESSAGES * (MESSAGES - 1) / 2;
+    if (consumer.received != PRODUCERS * MESSAGES || consumer.out_of_order) return 4;
+    if (consumer.sum != expected) return 5;
+
+    faeb_scheduler_shutdown_workers();
+    for (int i = 0; i <= PRODUCERS; i++) {
+        faeb_process_destroy(processes[i]);
+    }
+    faeb_channel_destroy(channel);
+    return 0;
+}
+
+// Bounces one message between two processes; each round trip is timed
+struct channel_rally {
+    faeb_channel_t* serve;
+    faeb_channel_t* reply;
+    int rounds;
+    uint64_t* round_trips;
+};
+
+static void channel_server(void* context) {
+    struct channel_rally* rally = context;
+    for (int i = 0; i < rally->rounds; i++) {
+        uint64_t start = now_ns();
+        uint64_t ball = (uint64_t)i;
+        faeb_channel_send(rally->serve, &ball);
+        faeb_channel_receive(rally->reply, &ball);
+        rally->round_trips[i] = now_ns() - start;
+    }
+}
+
+static void channel_returner(void* context) {
+    struct channel_rally* rally = context;
+    uint64_t ball;
+    for (int i = 0; i < rally->rounds; i++) {
+        faeb_channel_receive(rally->serve, &ball);
+        faeb_channel_send(rally->reply, &ball);
+    }
+}
+
+static void channel_report(const char* label, double messages, double seconds,
+                           uint64_t* samples, size_t count) {
+    qsort(samples, count, sizeof(samples[0]), compare_u64);
+    printf("  %-24s %10.0f msgs/s  p50=%.2fus p99=%.2fus p99.9=%.2fus\n",
+           label, messages / seconds, samples[count / 2] / 1e3,
+           samples[count * 99 / 100] / 1e3, samples[count * 999 / 1000] / 1e3);
+}
+
+// Ping-pong latency on each channel kind, then fan-in throughput and
+// delivery latency across the worker pool, single and batched
+int test_performance_channel(void) {
+    enum { ROUNDS = 200000, PRODUCERS = 8, MESSAGES = 100000 };
+    static uint64_t samples[PRODUCERS * MESSAGES];
+    static struct channel_peer producers[PRODUCERS];
+    static faeb_process_t* processes[PRODUCERS + 1];
+
+    const char* names[] = { "ping-pong spsc:", "ping-pong mpmc:" };
+    for (int k = 0; k < 2; k++) {
+        faeb_channel_kind_t kind = k ? FAEB_CHANNEL_MPMC : FAEB_CHANNEL_SPSC;
+        struct channel_rally rally = {
+            faeb_channel_create(kind, sizeof(uint64_t), 1),
+            faeb_channel_create(kind, sizeof(uint64_t), 1),
+            ROUNDS, samples
+        };
+        if (!rally.serve || !rally.reply) return 1;
+        faeb_process_t* a = faeb_process_create(channel_server, &rally);
+        faeb_process_t* b = faeb_process_create(channel_returner, &rally);
+        if (!a || !b) return 2;
+
+        uint64_t start = now_ns();
+        faeb_scheduler_run();
+        double seconds = (double)(now_ns() - start) / 1e9;
+        channel_report(names[k], 2.0 * ROUNDS, seconds, samples, ROUNDS);
+
+        faeb_process_destroy(a);
+        faeb_process_destroy(b);
+        faeb_channel_destroy(rally.serve);
+        faeb_channel_destroy(rally.reply);
+    }
+
+    if (faeb_scheduler_init_workers(0) != FAEB_SUCCESS) return 3;
+    for (int batch = 1; batch <= 32; batch *= 32) {
+        faeb_channel_t* channel = faeb_channel_create(FAEB_CHANNEL_MPMC,
+                                                      sizeof(struct channel_message), 1024);
+        if (!channel) return 4;
+        _Atomic int producing = PRODUCERS;
+        struct channel_peer consumer = { .in = channel, .batch = batch, .latency = samples };
+        processes[0] = faeb_process_create(channel_consumer, &consumer);
+        for (int i = 0; i < PRODUCERS; i++) {
+            producers[i] = (struct channel_peer){ .out = channel, .id = (uint32_t)i,
+                                                  .messages = MESSAGES, .batch = batch,
+                                                  .producing = &producing };
+            processes[i + 1] = faeb_process_create(channel_producer, &producers[i]);
+        }
+
+        uint64_t start = now_ns();
+        for (int i = 0; i <= PRODUCERS; i++) {
+            if (!processes[i] || faeb_scheduler_submit(processes[i]) != FAEB_SUCCESS) return 5;
+        }
+        faeb_scheduler_wait();
+        double seconds = (double)(now_ns() - start) / 1e9;
+        if (consumer.received != PRODUCERS * MESSAGES || consumer.out_of_order) return 6;
+
+        char label[32];
+        snprintf(label, sizeof(label), "fan-in %dx1 batch %d:", PRODUCERS, batch);
+        channel_report(label, consumer.received, seconds, samples, (size_t)consumer.received);
+        for (int i = 0; i <= PRODUCERS; i++) {
+            faeb_process_destroy(processes[i]);
+        }
+        faeb_channel_destroy(channel);
+    }
+    faeb_scheduler_shutdown_workers();
+    return 0;
+}
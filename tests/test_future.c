@@ -0,0 +1,277 @@
+/* FAEB Test Suite - Future Tests
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "faeb/runtime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// Monotonic timestamp in nanoseconds
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void* future_double(void* context) {
+    return (void*)((uintptr_t)context * 2);
+}
+
+// Sleeps for context milliseconds, then returns it
+static void* future_nap(void* context) {
+    faeb_process_sleep((uint64_t)(uintptr_t)context);
+    return context;
+}
+
+static void* future_sum(void* context) {
+    uint64_t n = (uint64_t)(uintptr_t)context;
+    uint64_t sum = 0;
+    for (uint64_t i = 1; i <= n; i++) {
+        sum += i;
+        if (i % 64 == 0) faeb_process_yield();
+    }
+    return (void*)(uintptr_t)sum;
+}
+
+struct future_fanout {
+    int children;
+    uint64_t nap_ms;
+    bool combine;          // Await through when_all instead of one by one
+    bool serial;           // Call the children's work directly instead
+    uintptr_t total;
+    uint64_t elapsed_ns;
+    int failures;
+};
+
+// Request handler shape: fan out to children, then gather their results
+static void future_handler(void* context) {
+    struct future_fanout* fanout = context;
+    faeb_future_t* children[64];
+    uint64_t start = now_ns();
+    if (fanout->serial) {
+        for (int i = 0; i < fanout->children; i++) {
+            fanout->total += (uintptr_t)future_nap((void*)(uintptr_t)fanout->nap_ms);
+        }
+        fanout->elapsed_ns = now_ns() - start;
+        return;
+    }
+    
+    for (int i = 0; i < fanout->children; i++) {
+        children[i] = faeb_future_spawn(fanout->nap_ms ? future_nap : future_sum,
+                                        (void*)(uintptr_t)(fanout->nap_ms ? fanout->nap_ms
+                                                                          : (uint64_t)i * 100));
+        if (!children[i]) fanout->failures++;
+    }
+    if (fanout->failures) return;
+    
+    if (fanout->combine) {
+        faeb_future_t* all = faeb_future_when_all(children, (size_t)fanout->children);
+        void* none = (void*)1;
+        if (!all || faeb_future_await(all, &none) != FAEB_SUCCESS || none != NULL) {
+            fanout->failures++;
+        }
+        faeb_future_destroy(all);
+    }
+    for (int i = 0; i < fanout->children; i++) {
+        void* result;
+        if (faeb_future_await(children[i], &result) != FAEB_SUCCESS) fanout->failures++;
+        fanout->total += (uintptr_t)result;
+        faeb_future_destroy(children[i]);
+    }
+    fanout->elapsed_ns = now_ns() - start;
+}
+
+static void future_count(void* context, void* result) {
+    *(uintptr_t*)context += (uintptr_t)result;
+}
+
+struct future_waiter {
+    faeb_future_t* future;
+    void* result;
+    int woken;
+};
+
+static void future_waiter(void* context) {
+    struct future_waiter* waiter = context;
+    if (faeb_future_await(waiter->future, &waiter->result) == FAEB_SUCCESS) {
+        waiter->woken++;
+    }
+}
+
+// Completion, awaiting, continuations and combinators on the
+// cooperative scheduler
+int test_future_basic(void) {
+    // A plain future completes once; outside of a process only a
+    // completed one can be awaited
+    faeb_future_t* future = faeb_future_create();
+    if (!future) return 1;
+    void* result = NULL;
+    if (faeb_future_await(future, &result) != FAEB_ERROR_INVALID) return 2;
+    uintptr_t counted = 0;
+    if (faeb_future_then(future, future_count, &counted) != FAEB_SUCCESS) return 3;
+    if (faeb_future_is_ready(future)) return 4;
+    if (faeb_future_complete(future, (void*)42) != FAEB_SUCCESS) return 5;
+    if (faeb_future_complete(future, (void*)43) != FAEB_ERROR_INVALID) return 6;
+    if (!faeb_future_is_ready(future) || counted != 42) return 7;
+    if (faeb_future_await(future, &result) != FAEB_SUCCESS || result != (void*)42) return 8;
+    if (faeb_future_then(future, future_count, &counted) != FAEB_ERROR_INVALID) return 9;
+    faeb_future_destroy(future);
+    
+    // Processes parked on a future all wake with its result
+    struct future_waiter waiters[3];
+    future = faeb_future_create();
+    for (int i = 0; i < 3; i++) {
+        waiters[i] = (struct future_waiter){ .future = future };
+        if (faeb_process_spawn(future_waiter, &waiters[i]) != FAEB_SUCCESS) return 10;
+    }
+    faeb_scheduler_run();
+    if (waiters[0].woken || waiters[2].woken) return 11;
+    faeb_future_complete(future, (void*)7);
+    faeb_scheduler_run();
+    for (int i = 0; i < 3; i++) {
+        if (waiters[i].woken != 1 || waiters[i].result != (void*)7) return 12;
+    }
+    faeb_future_destroy(future);
+    
+    // Spawned futures complete with their function's return value, and
+    // survive the caller letting go early
+    future = faeb_future_spawn(future_double, (void*)21);
+    faeb_future_t* dropped = faeb_future_spawn(future_double, (void*)1);
+    if (!future || !dropped || faeb_future_spawn(NULL, NULL) != NULL) return 13;
+    faeb_future_destroy(dropped);
+    faeb_scheduler_run();
+    if (faeb_future_await(future, &result) != FAEB_SUCCESS || result != (void*)42) return 14;
+    faeb_future_destroy(future);
+    
+    // Fan-out: children sleeping side by side take as long as one of them
+    struct future_fanout fanout = { .children = 8, .nap_ms = 10, .combine = true };
+    if (faeb_process_spawn(future_handler, &fanout) != FAEB_SUCCESS) return 15;
+    faeb_scheduler_run();
+    if (fanout.failures || fanout.total != 80) return 16;
+    if (fanout.elapsed_ns < 10000000ULL || fanout.elapsed_ns > 40000000ULL) return 17;
+    
+    // when_any completes with the index of the first child to complete;
+    // later completions are ignored
+    faeb_future_t* children[3];
+    for (int i = 0; i < 3; i++) {
+        children[i] = faeb_future_create();
+    }
+    faeb_future_t* any = faeb_future_when_any(children, 3);
+    faeb_future_t* all = faeb_future_when_all(children, 3);
+    if (!any || !all) return 18;
+    if (faeb_future_when_all(children, 0) != NULL) return 19;
+    faeb_future_complete(children[2], NULL);
+    if (faeb_future_await(any, &result) != FAEB_SUCCESS || result != (void*)2) return 20;
+    if (faeb_future_is_ready(all)) return 21;
+    faeb_future_complete(children[0], NULL);
+    faeb_future_complete(children[1], NULL);
+    if (!faeb_future_is_ready(all)) return 22;
+    if (faeb_future_await(any, &result) != FAEB_SUCCESS || result != (void*)2) return 23;
+    
+    // Combinators over completed children complete at once
+    faeb_future_t* late = faeb_future_when_any(&children[1], 2);
+    if (!late || faeb_future_await(late, &result) != FAEB_SUCCESS || result != NULL) return 24;
+    faeb_future_destroy(late);
+    faeb_future_destroy(any);
+    faeb_future_destroy(all);
+    for (int i = 0; i < 3; i++) {
+        faeb_future_destroy(children[i]);
+    }
+    
+    // A child dropped before completing releases its combinator
+    faeb_future_t* orphan = faeb_future_create();
+    all = faeb_future_when_all(&orphan, 1);
+    faeb_future_destroy(orphan);
+    if (faeb_future_is_ready(all)) return 25;
+    faeb_future_destroy(all);
+    
+    return 0;
+}
+
+static void* future_complete_thread(void* context) {
+    struct timespec pause = { 0, 2000000 };
+    nanosleep(&pause, NULL);
+    faeb_future_complete(context, (void*)99);
+    return NULL;
+}
+
+// Fan-out across the worker pool, and completion from a plain thread
+int test_future_workers(void) {
+    enum { HANDLERS = 16 };
+    static struct future_fanout fanouts[HANDLERS];
+    static faeb_process_t* handlers[HANDLERS];
+    if (faeb_scheduler_init_workers(4) != FAEB_SUCCESS) return 1;
+    
+    for (int i = 0; i < HANDLERS; i++) {
+        fanouts[i] = (struct future_fanout){ .children = 32, .combine = i % 2 == 0 };
+        handlers[i] = faeb_process_create(future_handler, &fanouts[i]);
+        if (!handlers[i] || faeb_scheduler_submit(handlers[i]) != FAEB_SUCCESS) return 2;
+    }
+    faeb_scheduler_wait();
+    
+    // Child i sums 1..100i
+    uintptr_t expected = 0;
+    for (uintptr_t i = 0; i < 32; i++) {
+        expected += 100 * i * (100 * i + 1) / 2;
+    }
+    for (int i = 0; i < HANDLERS; i++) {
+        if (fanouts[i].failures || fanouts[i].total != expected) return 3;
+        faeb_process_destroy(handlers[i]);
+    }
+    
+    struct future_waiter waiter = { .future = faeb_future_create() };
+    faeb_process_t* process = faeb_process_create(future_waiter, &waiter);
+    if (!waiter.future || !process || faeb_scheduler_submit(process) != FAEB_SUCCESS) return 4;
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, future_complete_thread, waiter.future) != 0) return 5;
+    faeb_scheduler_wait();
+    pthread_join(thread, NULL);
+    if (waiter.woken != 1 || waiter.result != (void*)99) return 6;
+    faeb_process_destroy(process);
+    faeb_future_destroy(waiter.future);
+    
+    faeb_scheduler_shutdown_workers();
+    return 0;
+}
+
+static void future_round_trips(void* context) {
+    int rounds = *(int*)context;
+    for (int i = 0; i < rounds; i++) {
+        faeb_future_t* future = faeb_future_spawn(future_double, (void*)(uintptr_t)i);
+        void* result;
+        faeb_future_await(future, &result);
+        faeb_future_destroy(future);
+    }
+}
+
+// Cost of a spawn and await round trip, and latency of a handler doing
+// its children's work in turn or fanning out to futures
+int test_performance_future(void) {
+    int rounds = 100000;
+    faeb_process_t* process = faeb_process_create(future_round_trips, &rounds);
+    if (!process) return 1;
+    uint64_t start = now_ns();
+    faeb_scheduler_run();
+    double round_trip = (double)(now_ns() - start) / rounds;
+    faeb_process_destroy(process);
+    printf("  spawn+await: %.1f ns\n", round_trip);
+    
+    const char* modes[] = { "serial", "awaited in turn", "when_all" };
+    for (int mode = 0; mode < 3; mode++) {
+        struct future_fanout fanout = { .children = 16, .nap_ms = 2,
+                                        .serial = mode == 0, .combine = mode == 2 };
+        if (faeb_process_spawn(future_handler, &fanout) != FAEB_SUCCESS) return 2;
+        faeb_scheduler_run();
+        if (fanout.failures || fanout.total != 32) return 3;
+        printf("  16 children napping 2 ms, %s: %.2f ms\n",
+               modes[mode], (double)fanout.elapsed_ns / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+/* FAEB Test Suite - C++20 Future Coroutine Tests
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#include "faeb/future.hpp"
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+
+struct coroutine_run {
+    int sum = 0;
+    std::size_t first = 99;
+    bool all_done = false;
+    bool caught = false;
+};
+
+// Suspends in co_await on spawned processes, then resumes in a process
+// of its own to combine their values
+faeb::future<int> add_later(int a, int b) {
+    auto x = faeb::spawn([a] {
+        faeb_process_sleep(2);
+        return a;
+    });
+    auto y = faeb::spawn([b] { return b; });
+    int first = co_await x;
+    int second = co_await y;
+    co_return first + second;
+}
+
+faeb::future<void> coroutine_main(coroutine_run* run) {
+    run->sum = co_await add_later(20, 22);
+
+    // when_any reports the position of the first to complete
+    auto slow = faeb::spawn([] {
+        faeb_process_sleep(20);
+        return 1;
+    });
+    auto fast = faeb::spawn([] { return 2; });
+    run->first = co_await faeb::when_any(slow, fast);
+
+    // when_all completes once both have; get no longer parks after it
+    co_await faeb::when_all(slow, fast);
+    run->all_done = slow.ready() && fast.ready() && slow.get() + fast.get() == 3;
+
+    // Exceptions thrown by the work come back out of co_await
+    auto failing = faeb::spawn([]() -> int { throw std::runtime_error("boom"); });
+    try {
+        co_await failing;
+    } catch (const std::runtime_error&) {
+        run->caught = true;
+    }
+}
+
+// get parks a plain process on the future instead of a coroutine
+void process_get(void* context) {
+    int* result = static_cast<int*>(context);
+    *result = faeb::spawn([] { return 6 * 7; }).get();
+}
+
+}  // namespace
+
+int test_future_coroutines() {
+    // Outside of a process get only takes completed values
+    auto pending = faeb::spawn([] { return 1; });
+    try {
+        pending.get();
+        return 1;
+    } catch (const std::logic_error&) {
+    }
+    faeb_scheduler_run();
+    if (!pending.ready() || pending.get() != 1) return 2;
+    
+    int got = 0;
+    if (faeb_process_spawn(process_get, &got) != FAEB_SUCCESS) return 3;
+    faeb_scheduler_run();
+    if (got != 42) return 4;
+    
+    coroutine_run run;
+    faeb::future<void> done = coroutine_main(&run);
+    if (!done.valid() || done.ready()) return 5;
+    faeb_scheduler_run();
+    if (!done.ready()) return 6;
+    done.get();
+    if (run.sum != 42) return 7;
+    if (run.first != 1) return 8;
+    if (!run.all_done) return 9;
+    if (!run.caught) return 10;
+    return 0;
+}
+
+int main() {
+    int result = test_future_coroutines();
+    std::printf("test_future_coroutines: %d\n", result);
+    return result == 0 ? 0 : 1;
+}
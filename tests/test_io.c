@@ -0,0 +1,803 @@
+/* FAEB Test Suite - I/O Tests
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "faeb/runtime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+
+// Monotonic timestamp in nanoseconds
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Whatever has reached the pipe so far, without waiting for more
+static size_t io_pending(int fd, char* out, size_t size) {
+    ssize_t n = read(fd, out, size - 1);
+    size_t count = n > 0 ? (size_t)n : 0;
+    out[count] = '\0';
+    return count;
+}
+
+// Buffered output in each mode, and buffered input, over pipes
+int test_io_basic(void) {
+    int in[2], out[2];
+    if (pipe(in) != 0 || pipe(out) != 0) return 1;
+    fcntl(out[0], F_SETFL, O_NONBLOCK);
+    char seen[256];
+    
+    // Fully buffered: nothing moves until the buffer fills or is flushed
+    faeb_io_config_t config = { .buffer_size = 16, .mode = FAEB_IO_FULL };
+    faeb_io_t* io = faeb_io_open(in[0], out[1], &config);
+    if (!io || !faeb_io_is_available(io)) return 2;
+    if (faeb_io_write(io, "hello\n", 6) != 6) return 3;
+    if (io_pending(out[0], seen, sizeof(seen)) != 0) return 4;
+    if (faeb_io_flush(io) != FAEB_SUCCESS) return 5;
+    if (io_pending(out[0], seen, sizeof(seen)) != 6 || strcmp(seen, "hello\n") != 0) return 6;
+    
+    // Filling the buffer writes it out first; large writes skip it
+    faeb_io_write(io, "0123456789", 10);
+    faeb_io_write(io, "abcdefghij", 10);
+    if (io_pending(out[0], seen, sizeof(seen)) != 10 || strcmp(seen, "0123456789") != 0) return 7;
+    faeb_io_write(io, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", 26);
+    if (io_pending(out[0], seen, sizeof(seen)) != 36 ||
+        strcmp(seen, "abcdefghijABCDEFGHIJKLMNOPQRSTUVWXYZ") != 0) {
+        return 8;
+    }
+    faeb_io_write(io, "tail", 4);
+    faeb_io_destroy(io);
+    if (io_pending(out[0], seen, sizeof(seen)) != 4 || strcmp(seen, "tail") != 0) return 9;
+    
+    // Line buffered: a write containing a newline pushes the buffer out
+    config.mode = FAEB_IO_LINE;
+    io = faeb_io_open(in[0], out[1], &config);
+    if (!io) return 10;
+    faeb_io_write(io, "abc", 3);
+    if (io_pending(out[0], seen, sizeof(seen)) != 0) return 11;
+    faeb_io_write(io, "d\nef", 4);
+    if (io_pending(out[0], seen, sizeof(seen)) != 7 || strcmp(seen, "abcd\nef") != 0) return 12;
+    faeb_io_write(io, "gh", 2);
+    faeb_io_destroy(io);
+    if (io_pending(out[0], seen, sizeof(seen)) != 2 || strcmp(seen, "gh") != 0) return 13;
+    
+    // Unbuffered: every write lands at once
+    config.mode = FAEB_IO_UNBUFFERED;
+    io = faeb_io_open(in[0], out[1], &config);
+    if (!io) return 14;
+    faeb_io_write(io, "x", 1);
+    if (io_pending(out[0], seen, sizeof(seen)) != 1 || seen[0] != 'x') return 15;
+    faeb_io_destroy(io);
+    
+    // Input comes out in order however it is sliced, then end of input
+    const char* text = "line one\nline two\nand a longer third line\n";
+    if (write(in[1], text, strlen(text)) != (ssize_t)strlen(text)) return 16;
+    close(in[1]);
+    config.mode = FAEB_IO_FULL;
+    io = faeb_io_open(in[0], out[1], &config);
+    if (!io) return 17;
+    char got[128] = { 0 };
+    size_t total = 0, n;
+    size_t slices[] = { 3, 40, 1, 7 };
+    for (int i = 0; (n = faeb_io_read(io, got + total, slices[i % 4])) > 0; i++) {
+        total += n;
+    }
+    if (faeb_io_get_last_error(io) != FAEB_SUCCESS) return 18;
+    if (total != strlen(text) || strcmp(got, text) != 0) return 19;
+    faeb_io_destroy(io);
+    
+    // The standard descriptors work as before
+    io = faeb_io_create();
+    if (!io || !faeb_io_is_available(io)) return 20;
+    if (faeb_io_flush(io) != FAEB_SUCCESS) return 21;
+    faeb_io_destroy(io);
+    
+    close(in[0]);
+    close(out[0]);
+    close(out[1]);
+    return 0;
+}
+
+// Invalid arguments and failing descriptors
+int test_io_errors(void) {
+    char byte = 0;
+    if (faeb_io_read(NULL, &byte, 1) != 0 || faeb_io_write(NULL, &byte, 1) != 0) return 1;
+    if (faeb_io_flush(NULL) != FAEB_ERROR_INVALID) return 2;
+    if (faeb_io_get_last_error(NULL) != FAEB_ERROR_INVALID) return 3;
+    if (faeb_io_is_available(NULL)) return 4;
+    if (faeb_io_open(-1, 1, NULL) != NULL) return 5;
+    
+    // Output to a read-only descriptor fails when it reaches the fd
+    int readonly = open("/dev/null", O_RDONLY);
+    int writeonly = open("/dev/null", O_WRONLY);
+    if (readonly < 0 || writeonly < 0) return 6;
+    faeb_io_config_t config = { .mode = FAEB_IO_UNBUFFERED };
+    faeb_io_t* io = faeb_io_open(writeonly, readonly, &config);
+    if (!io) return 7;
+    if (faeb_io_write(io, "x", 1) != 0 || faeb_io_get_last_error(io) != FAEB_ERROR_IO) return 8;
+    if (faeb_io_write(io, NULL, 1) != 0 || faeb_io_get_last_error(io) != FAEB_ERROR_INVALID) return 9;
+    if (faeb_io_read(io, &byte, 1) != 0 || faeb_io_get_last_error(io) != FAEB_ERROR_IO) return 10;
+    faeb_io_destroy(io);
+    
+    // Buffered, the write is accepted and the flush reports the failure
+    config.mode = FAEB_IO_FULL;
+    io = faeb_io_open(writeonly, readonly, &config);
+    if (!io) return 11;
+    if (faeb_io_write(io, "x", 1) != 1 || faeb_io_get_last_error(io) != FAEB_SUCCESS) return 12;
+    if (faeb_io_flush(io) != FAEB_ERROR_IO || faeb_io_get_last_error(io) != FAEB_ERROR_IO) return 13;
+    if (faeb_io_flush(io) != FAEB_ERROR_IO) return 14;
+    faeb_io_destroy(io);
+    
+    close(readonly);
+    close(writeonly);
+    return 0;
+}
+
+// Small-write throughput to /dev/null in each mode
+int test_performance_io(void) {
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd < 0) return 1;
+    
+    const char line[] = "2026-10-17T12:00:00Z info request served\n";
+    size_t length = sizeof(line) - 1;
+    int writes = 1000000;
+    const char* names[] = { "unbuffered", "line", "full" };
+    faeb_io_mode_t modes[] = { FAEB_IO_UNBUFFERED, FAEB_IO_LINE, FAEB_IO_FULL };
+    for (int m = 0; m < 3; m++) {
+        faeb_io_config_t config = { .mode = modes[m] };
+        faeb_io_t* io = faeb_io_open(STDIN_FILENO, fd, &config);
+        if (!io) return 2;
+        
+        // Log-style lines: half of them written as two pieces
+        uint64_t start = now_ns();
+        for (int i = 0; i < writes; i++) {
+            if (i & 1) {
+                faeb_io_write(io, line, 21);
+                faeb_io_write(io, line + 21, length - 21);
+            } else {
+                faeb_io_write(io, line, length);
+            }
+        }
+        if (faeb_io_flush(io) != FAEB_SUCCESS) return 3;
+        double elapsed = (double)(now_ns() - start);
+        faeb_io_destroy(io);
+        printf("  %-10s %7.1f ns per line, %7.1f MB/s\n", names[m],
+               elapsed / writes, (double)writes * length / elapsed * 1e3);
+    }
+    
+    close(fd);
+    return 0;
+}
+
+struct io_pipe_reader {
+    int fd;
+    char data[64];
+    size_t length;
+    faeb_result_t result;
+    int other_runs;            // Runs of the other process seen meanwhile
+    int* counter;
+};
+
+static void io_pipe_reader_main(void* context) {
+    struct io_pipe_reader* reader = context;
+    int before = *reader->counter;
+    reader->result = faeb_io_pread(reader->fd, reader->data, sizeof(reader->data) - 1, -1,
+                                   &reader->length);
+    reader->other_runs = *reader->counter - before;
+}
+
+struct io_pipe_writer {
+    int fd;
+    int counter;
+    int yields;
+    faeb_result_t result;
+};
+
+// Keeps running while the reader waits, then writes what it waits for
+static void io_pipe_writer_main(void* context) {
+    struct io_pipe_writer* writer = context;
+    for (int i = 0; i < writer->yields; i++) {
+        writer->counter++;
+        faeb_process_yield();
+    }
+    size_t written = 0;
+    writer->result = faeb_io_pwrite(writer->fd, "ping", 4, -1, &written);
+    if (written != 4) writer->result = FAEB_ERROR_IO;
+}
+
+struct io_file_reader {
+    int fd;
+    int index;
+    int failures;
+};
+
+// Each reader checks the blocks it reads carry their own offsets
+static void io_file_reader_main(void* context) {
+    struct io_file_reader* reader = context;
+    uint32_t block[1024];
+    for (int i = 0; i < 16; i++) {
+        int64_t number = (reader->index * 16 + i) % 256;
+        size_t done = 0;
+        if (faeb_io_pread(reader->fd, block, sizeof(block), number * (int64_t)sizeof(block),
+                          &done) != FAEB_SUCCESS || done != sizeof(block) ||
+            block[0] != (uint32_t)number || block[1023] != (uint32_t)number) {
+            reader->failures++;
+        }
+    }
+}
+
+// A 1 MiB file of 4 KiB blocks, each filled with its number
+static int io_block_file(void) {
+    char path[] = "/tmp/faeb_io_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return -1;
+    unlink(path);
+    uint32_t block[1024];
+    for (uint32_t number = 0; number < 256; number++) {
+        for (int i = 0; i < 1024; i++) {
+            block[i] = number;
+        }
+        if (write(fd, block, sizeof(block)) != (ssize_t)sizeof(block)) {
+            close(fd);
+            return -1;
+        }
+    }
+    return fd;
+}
+
+static void* io_late_writer(void* context) {
+    struct timespec pause = { 0, 20000000 };
+    nanosleep(&pause, NULL);
+    ssize_t written = write(*(int*)context, "late", 4);
+    (void)written;
+    return NULL;
+}
+
+static void io_napper(void* context) {
+    (void)context;
+    faeb_process_sleep(2);
+}
+
+static void io_destroyer(void* context) {
+    faeb_process_destroy(context);
+}
+
+// One backend on the cooperative scheduler
+static int io_async_backend(faeb_io_backend_t backend, int file) {
+    if (faeb_scheduler_set_io_backend(backend) != FAEB_SUCCESS) return 1;
+    if (faeb_scheduler_get_io_backend() != backend) return 2;
+    // A reader waiting on an empty pipe leaves the scheduler to others
+    int fds[2];
+    if (pipe(fds) != 0) return 3;
+    struct io_pipe_writer writer = { .fd = fds[1], .yields = 50 };
+    struct io_pipe_reader reader = { .fd = fds[0], .counter = &writer.counter };
+    if (faeb_process_spawn(io_pipe_reader_main, &reader) != FAEB_SUCCESS ||
+        faeb_process_spawn(io_pipe_writer_main, &writer) != FAEB_SUCCESS) {
+        return 4;
+    }
+    faeb_scheduler_run();
+    if (reader.result != FAEB_SUCCESS || writer.result != FAEB_SUCCESS) return 5;
+    if (reader.length != 4 || memcmp(reader.data, "ping", 4) != 0) return 6;
+    if (reader.other_runs != 50) return 7;
+    
+    // Data from another thread completes a read the loop waits for, with
+    // a sleeper's timer due in between
+    pthread_t thread;
+    reader = (struct io_pipe_reader){ .fd = fds[0], .counter = &writer.counter };
+    if (faeb_process_spawn(io_pipe_reader_main, &reader) != FAEB_SUCCESS ||
+        faeb_process_spawn(io_napper, NULL) != FAEB_SUCCESS ||
+        pthread_create(&thread, NULL, io_late_writer, &fds[1]) != 0) {
+        return 8;
+    }
+    faeb_scheduler_run();
+    pthread_join(thread, NULL);
+    if (reader.result != FAEB_SUCCESS || reader.length != 4 || memcmp(reader.data, "late", 4)) {
+        return 9;
+    }
+    
+    // Concurrent reads at offsets each get their own block
+    struct io_file_reader readers[32];
+    for (int i = 0; i < 32; i++) {
+        readers[i] = (struct io_file_reader){ .fd = file, .index = i };
+        if (faeb_process_spawn(io_file_reader_main, &readers[i]) != FAEB_SUCCESS) return 10;
+    }
+    faeb_scheduler_run();
+    for (int i = 0; i < 32; i++) {
+        if (readers[i].failures) return 11;
+    }
+    
+    // Errors come back as results
+    struct io_pipe_reader bad = { .fd = 1000, .counter = &writer.counter };
+    faeb_process_spawn(io_pipe_reader_main, &bad);
+    faeb_scheduler_run();
+    if (bad.result != FAEB_ERROR_IO) return 12;
+    
+    faeb_scheduler_stats_t after;
+    faeb_scheduler_get_stats(&after);
+    if (after.io_pending != 0 || after.io_requests < 2 + 32 * 16) return 13;
+    if (backend == FAEB_IO_BACKEND_URING && after.io_enters >= after.io_requests) return 14;
+    
+    // A reader destroyed while its read waits leaves its stack to the
+    // engine; io_uring cancels the read, the thread pool finishes it
+    reader = (struct io_pipe_reader){ .fd = fds[0], .counter = &writer.counter };
+    faeb_process_t* parked = faeb_process_create(io_pipe_reader_main, &reader);
+    if (!parked || faeb_process_spawn(io_destroyer, parked) != FAEB_SUCCESS) return 15;
+    faeb_scheduler_run();
+    faeb_scheduler_get_stats(&after);
+    if (after.io_pending != 0) return 16;
+    if (write(fds[1], "gone", 4) != 4) return 17;
+    char left[4];
+    if (backend == FAEB_IO_BACKEND_URING && read(fds[0], left, sizeof(left)) != 4) return 18;
+    close(fds[0]);
+    close(fds[1]);
+    
+    // More reads waiting on pipes than the thread pool starts with leave
+    // room for the writes that complete them
+    int pipes[8][2];
+    struct io_pipe_reader pipe_readers[8];
+    struct io_pipe_writer pipe_writers[8];
+    for (int i = 0; i < 8; i++) {
+        if (pipe(pipes[i]) != 0) return 19;
+        pipe_readers[i] = (struct io_pipe_reader){ .fd = pipes[i][0], .counter = &writer.counter };
+        if (faeb_process_spawn(io_pipe_reader_main, &pipe_readers[i]) != FAEB_SUCCESS) return 20;
+    }
+    for (int i = 0; i < 8; i++) {
+        pipe_writers[i] = (struct io_pipe_writer){ .fd = pipes[i][1] };
+        if (faeb_process_spawn(io_pipe_writer_main, &pipe_writers[i]) != FAEB_SUCCESS) return 20;
+    }
+    faeb_scheduler_run();
+    for (int i = 0; i < 8; i++) {
+        if (pipe_readers[i].result != FAEB_SUCCESS || pipe_readers[i].length != 4) return 21;
+        if (pipe_writers[i].result != FAEB_SUCCESS) return 21;
+        close(pipes[i][0]);
+        close(pipes[i][1]);
+    }
+    return 0;
+}
+
+// Processes parking on I/O with io_uring, with the thread pool, and on
+// workers
+int test_io_async(void) {
+    if (faeb_scheduler_set_io_backend((faeb_io_backend_t)7) != FAEB_ERROR_INVALID) return 1;
+    int file = io_block_file();
+    if (file < 0) return 2;
+    
+    // Outside of a process the calls just block
+    char byte;
+    size_t done = 0;
+    if (faeb_io_pread(file, &byte, 1, 4096, &done) != FAEB_SUCCESS || done != 1) return 3;
+    if (byte != 1) return 4;
+    if (faeb_io_pread(-1, &byte, 1, 0, &done) != FAEB_ERROR_INVALID) return 5;
+    if (faeb_io_pread(file, &byte, 1, -2, &done) != FAEB_ERROR_INVALID) return 6;
+    
+    faeb_result_t uring = faeb_scheduler_set_io_backend(FAEB_IO_BACKEND_URING);
+    if (uring == FAEB_SUCCESS) {
+        int result = io_async_backend(FAEB_IO_BACKEND_URING, file);
+        if (result) return 10 + result;
+    } else if (uring != FAEB_ERROR_IO) {
+        return 7;
+    } else {
+        printf("  io_uring unavailable, thread pool only\n");
+    }
+    int result = io_async_backend(FAEB_IO_BACKEND_THREADS, file);
+    if (result) return 30 + result;
+    
+    // Worker processes hand their calls to the thread pool
+    if (faeb_scheduler_init_workers(2) != FAEB_SUCCESS) return 50;
+    struct io_file_reader readers[8];
+    faeb_process_t* processes[8];
+    for (int i = 0; i < 8; i++) {
+        readers[i] = (struct io_file_reader){ .fd = file, .index = i };
+        processes[i] = faeb_process_create(io_file_reader_main, &readers[i]);
+        if (!processes[i] || faeb_scheduler_submit(processes[i]) != FAEB_SUCCESS) return 51;
+    }
+    faeb_scheduler_wait();
+    for (int i = 0; i < 8; i++) {
+        if (readers[i].failures) return 52;
+        faeb_process_destroy(processes[i]);
+    }
+    faeb_scheduler_shutdown_workers();
+    
+    if (faeb_scheduler_set_io_backend(FAEB_IO_BACKEND_AUTO) != FAEB_SUCCESS) return 53;
+    close(file);
+    return 0;
+}
+
+struct io_bench {
+    int fd;
+    int reads;
+    bool direct;               // Plain pread, blocking the scheduler
+    uint64_t seed;
+};
+
+static void io_bench_main(void* context) {
+    struct io_bench* bench = context;
+    char block[4096];
+    for (int i = 0; i < bench->reads; i++) {
+        bench->seed = bench->seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        off_t offset = (off_t)((bench->seed >> 33) % 256) * 4096;
+        size_t done;
+        if (bench->direct) {
+            ssize_t n = pread(bench->fd, block, sizeof(block), offset);
+            (void)n;
+        } else {
+            faeb_io_pread(bench->fd, block, sizeof(block), offset, &done);
+        }
+    }
+}
+
+// 4 KiB reads of a cached file from 64 processes: blocking calls, the
+// thread pool and io_uring, with how many requests each submission
+// carried
+int test_performance_io_async(void) {
+    int file = io_block_file();
+    if (file < 0) return 1;
+    
+    enum { PROCESSES = 64, READS = 256 };
+    static struct io_bench benches[PROCESSES];
+    const char* names[] = { "blocking", "threads", "io_uring" };
+    faeb_io_backend_t backends[] = { FAEB_IO_BACKEND_THREADS, FAEB_IO_BACKEND_THREADS,
+                                     FAEB_IO_BACKEND_URING };
+    for (int mode = 0; mode < 3; mode++) {
+        if (faeb_scheduler_set_io_backend(backends[mode]) != FAEB_SUCCESS) {
+            printf("  %-9s unavailable\n", names[mode]);
+            continue;
+        }
+        faeb_scheduler_stats_t before, after;
+        faeb_scheduler_get_stats(&before);
+        for (int i = 0; i < PROCESSES; i++) {
+            benches[i] = (struct io_bench){ .fd = file, .reads = READS, .direct = mode == 0,
+                                            .seed = (uint64_t)i + 1 };
+            if (faeb_process_spawn(io_bench_main, &benches[i]) != FAEB_SUCCESS) return 2;
+        }
+        uint64_t start = now_ns();
+        faeb_scheduler_run();
+        double elapsed = (double)(now_ns() - start);
+        faeb_scheduler_get_stats(&after);
+        uint64_t requests = after.io_requests - before.io_requests;
+        uint64_t enters = after.io_enters - before.io_enters;
+        printf("  %-9s %7.1f ns per 4 KiB read", names[mode], elapsed / (PROCESSES * READS));
+        if (enters) {
+            printf(", %.1f requests per io_uring_enter", (double)requests / (double)enters);
+        }
+        printf("\n");
+    }
+    
+    faeb_scheduler_set_io_backend(FAEB_IO_BACKEND_AUTO);
+    close(file);
+    return 0;
+}
+
+struct io_echo {
+    int fd;
+    int rounds;
+    bool client;
+    int failures;
+};
+
+// Clients send numbered messages and check each comes back; servers
+// return whatever arrives until end of input
+static void io_echo_main(void* context) {
+    struct io_echo* echo = context;
+    char message[32];
+    char reply[32];
+    if (!echo->client) {
+        size_t got;
+        while (faeb_fd_read(echo->fd, message, sizeof(message), &got) == FAEB_SUCCESS && got) {
+            if (faeb_fd_write(echo->fd, message, got, NULL) != FAEB_SUCCESS) echo->failures++;
+        }
+        return;
+    }
+    for (int i = 0; i < echo->rounds; i++) {
+        int length = snprintf(message, sizeof(message), "%d:%d", echo->fd, i);
+        size_t got = 0;
+        if (faeb_fd_write(echo->fd, message, (size_t)length, NULL) != FAEB_SUCCESS) {
+            echo->failures++;
+            break;
+        }
+        while (got < (size_t)length) {
+            size_t n;
+            if (faeb_fd_read(echo->fd, reply + got, sizeof(reply) - got, &n) != FAEB_SUCCESS ||
+                n == 0) {
+                break;
+            }
+            got += n;
+        }
+        if (got != (size_t)length || memcmp(message, reply, got) != 0) echo->failures++;
+    }
+    shutdown(echo->fd, SHUT_WR);
+}
+
+// Run pairs echo connections on the current scheduler, rounds messages
+// each; returns the failures, -1 when they cannot be set up
+static int io_echo_run(struct io_echo* echoes, int pairs, int rounds) {
+    for (int i = 0; i < pairs; i++) {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) return -1;
+        echoes[2 * i] = (struct io_echo){ .fd = fds[0], .rounds = rounds, .client = true };
+        echoes[2 * i + 1] = (struct io_echo){ .fd = fds[1] };
+        if (faeb_fd_register(fds[0]) != FAEB_SUCCESS ||
+            faeb_fd_register(fds[1]) != FAEB_SUCCESS) {
+            return -1;
+        }
+    }
+    for (int i = 0; i < 2 * pairs; i++) {
+        if (faeb_process_spawn(io_echo_main, &echoes[i]) != FAEB_SUCCESS) return -1;
+    }
+    faeb_scheduler_run();
+    int failures = 0;
+    for (int i = 0; i < 2 * pairs; i++) {
+        failures += echoes[i].failures;
+        faeb_fd_unregister(echoes[i].fd);
+        close(echoes[i].fd);
+    }
+    return failures;
+}
+
+struct io_stream {
+    int fd;
+    size_t size;
+    size_t moved;
+    faeb_result_t result;
+};
+
+static void io_stream_writer(void* context) {
+    struct io_stream* stream = context;
+    char* data = malloc(stream->size);
+    if (!data) return;
+    for (size_t i = 0; i < stream->size; i++) {
+        data[i] = (char)(i * 31);
+    }
+    stream->result = faeb_fd_write(stream->fd, data, stream->size, &stream->moved);
+    free(data);
+    faeb_fd_unregister(stream->fd);
+    close(stream->fd);
+}
+
+static void io_stream_reader(void* context) {
+    struct io_stream* stream = context;
+    char block[4096];
+    size_t got;
+    while ((stream->result = faeb_fd_read(stream->fd, block, sizeof(block), &got)) ==
+           FAEB_SUCCESS && got) {
+        for (size_t i = 0; i < got; i++) {
+            if (block[i] != (char)((stream->moved + i) * 31)) stream->result = FAEB_ERROR_IO;
+        }
+        stream->moved += got;
+    }
+}
+
+struct io_late {
+    int fd;
+    int delay_ms;
+};
+
+static void* io_late_write(void* context) {
+    struct io_late* late = context;
+    struct timespec pause = { 0, late->delay_ms * 1000000L };
+    nanosleep(&pause, NULL);
+    ssize_t written = write(late->fd, "late", 4);
+    (void)written;
+    return NULL;
+}
+
+struct io_waiter {
+    int fd;
+    bool engine;               // Through the I/O engine rather than the reactor
+    char data[8];
+    size_t got;
+    faeb_result_t result;
+};
+
+static void io_waiter_main(void* context) {
+    struct io_waiter* waiter = context;
+    if (waiter->engine) {
+        waiter->result = faeb_io_pread(waiter->fd, waiter->data, sizeof(waiter->data), -1,
+                                       &waiter->got);
+    } else {
+        waiter->result = faeb_fd_read(waiter->fd, waiter->data, sizeof(waiter->data),
+                                      &waiter->got);
+    }
+}
+
+static void io_noop(void* context) {
+    (void)context;
+}
+
+static void io_readiness_main(void* context) {
+    struct io_waiter* waiter = context;
+    waiter->result = faeb_fd_wait(waiter->fd, FAEB_FD_READ);
+}
+
+// Pulls the descriptor from under a waiting reader, then ends its input
+static void io_orphaner(void* context) {
+    int* fds = context;
+    faeb_scheduler_stats_t stats;
+    faeb_scheduler_get_stats(&stats);
+    if (stats.fd_waiting != 1) return;
+    faeb_fd_unregister(fds[0]);
+    close(fds[1]);
+}
+
+// Processes waiting on descriptor readiness in the loop and on the tick
+// scheduler
+int test_io_reactor(void) {
+    // Echo connections, each direction parking on reads
+    static struct io_echo echoes[128];
+    if (io_echo_run(echoes, 64, 20) != 0) return 1;
+    faeb_scheduler_stats_t stats;
+    faeb_scheduler_get_stats(&stats);
+    if (stats.fd_waiting != 0 || stats.fd_polls == 0 || stats.fd_events == 0) return 2;
+    
+    // A writer filling a pipe parks until the reader drains it
+    int fds[2];
+    if (pipe(fds) != 0) return 3;
+    struct io_stream writer = { .fd = fds[1], .size = 1 << 20 };
+    struct io_stream reader = { .fd = fds[0] };
+    if (faeb_process_spawn(io_stream_writer, &writer) != FAEB_SUCCESS ||
+        faeb_process_spawn(io_stream_reader, &reader) != FAEB_SUCCESS) {
+        return 4;
+    }
+    faeb_scheduler_run();
+    if (writer.result != FAEB_SUCCESS || writer.moved != writer.size) return 5;
+    if (reader.result != FAEB_SUCCESS || reader.moved != writer.size) return 6;
+    faeb_fd_unregister(fds[0]);
+    close(fds[0]);
+    
+    // With nothing to run the loop sleeps on readiness and I/O completions
+    // together; data comes from other threads
+    int ready[2], engine[2];
+    if (pipe(ready) != 0 || pipe(engine) != 0) return 7;
+    struct io_waiter waiters[2] = { { .fd = ready[0] }, { .fd = engine[0], .engine = true } };
+    struct io_late lates[2] = { { ready[1], 40 }, { engine[1], 20 } };
+    pthread_t threads[2];
+    for (int i = 0; i < 2; i++) {
+        if (faeb_process_spawn(io_waiter_main, &waiters[i]) != FAEB_SUCCESS) return 8;
+        if (pthread_create(&threads[i], NULL, io_late_write, &lates[i]) != 0) return 9;
+    }
+    faeb_scheduler_run();
+    for (int i = 0; i < 2; i++) {
+        pthread_join(threads[i], NULL);
+        if (waiters[i].result != FAEB_SUCCESS || waiters[i].got != 4) return 10;
+        if (memcmp(waiters[i].data, "late", 4) != 0) return 11;
+    }
+    
+    // Unregistering wakes the waiters, to find the input closed
+    struct io_waiter orphan = { .fd = ready[0] };
+    faeb_process_spawn(io_waiter_main, &orphan);
+    faeb_process_spawn(io_orphaner, ready);
+    faeb_scheduler_run();
+    if (orphan.result != FAEB_SUCCESS || orphan.got != 0) return 12;
+    if (faeb_fd_unregister(ready[0]) != FAEB_ERROR_INVALID) return 13;
+    if (fcntl(ready[0], F_GETFL) & O_NONBLOCK) return 32;
+    close(ready[0]);
+    close(engine[0]);
+    close(engine[1]);
+    
+    // Unregistering leaves non-blocking what was non-blocking before
+    if (pipe(fds) != 0) return 33;
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    if (faeb_fd_register(fds[0]) != FAEB_SUCCESS || faeb_fd_register(fds[1]) != FAEB_SUCCESS) {
+        return 34;
+    }
+    if (!(fcntl(fds[0], F_GETFL) & O_NONBLOCK)) return 35;
+    faeb_fd_unregister(fds[0]);
+    faeb_fd_unregister(fds[1]);
+    if ((fcntl(fds[0], F_GETFL) & O_NONBLOCK) || !(fcntl(fds[1], F_GETFL) & O_NONBLOCK)) {
+        return 36;
+    }
+    
+    // A descriptor closed while registered leaves the set; a wait on the
+    // next one given its number registers that one afresh
+    int stale = fds[0];
+    faeb_fd_register(stale);
+    close(fds[0]);
+    close(fds[1]);
+    if (pipe(fds) != 0 || fds[0] != stale) return 37;
+    struct io_waiter reused = { .fd = fds[0] };
+    struct io_late late = { fds[1], 20 };
+    pthread_t thread;
+    if (faeb_process_spawn(io_readiness_main, &reused) != FAEB_SUCCESS ||
+        pthread_create(&thread, NULL, io_late_write, &late) != 0) {
+        return 38;
+    }
+    faeb_scheduler_run();
+    pthread_join(thread, NULL);
+    if (reused.result != FAEB_SUCCESS || !(fcntl(fds[0], F_GETFL) & O_NONBLOCK)) return 39;
+    faeb_fd_unregister(fds[0]);
+    close(fds[0]);
+    close(fds[1]);
+    
+    // Arguments, and descriptors that cannot be waited on
+    if (faeb_fd_wait(-1, FAEB_FD_READ) != FAEB_ERROR_INVALID) return 15;
+    if (faeb_fd_wait(0, 0) != FAEB_ERROR_INVALID) return 16;
+    if (faeb_fd_unregister(1000) != FAEB_ERROR_INVALID) return 17;
+    char path[] = "/tmp/faeb_io_XXXXXX";
+    int file = mkstemp(path);
+    if (file < 0) return 18;
+    unlink(path);
+    if (faeb_fd_register(file) != FAEB_ERROR_INVALID) return 19;
+    close(file);
+    
+    // Outside of a process waiting is a poll
+    if (pipe(fds) != 0) return 20;
+    if (faeb_fd_wait(fds[1], FAEB_FD_WRITE) != FAEB_SUCCESS) return 21;
+    
+    // The tick scheduler blocks its current process until the descriptor
+    // is readable and unblocks it on a later tick
+    faeb_scheduler_init(10);
+    faeb_process_t* a = faeb_process_create(io_noop, NULL);
+    faeb_process_t* b = faeb_process_create(io_noop, NULL);
+    if (!a || !b) return 22;
+    faeb_scheduler_add_process(a);
+    faeb_scheduler_add_process(b);
+    if (faeb_scheduler_schedule_next() != a) return 23;
+    if (faeb_scheduler_block_current_fd(fds[0], FAEB_FD_READ) != FAEB_SUCCESS) return 24;
+    faeb_scheduler_tick();
+    faeb_scheduler_get_stats(&stats);
+    if (stats.blocked_count != 1 || stats.fd_waiting != 1 || faeb_scheduler_get_current() != b) {
+        return 25;
+    }
+    if (write(fds[1], "x", 1) != 1) return 26;
+    faeb_scheduler_tick();
+    faeb_scheduler_get_stats(&stats);
+    if (stats.blocked_count != 0 || stats.fd_waiting != 0) return 27;
+    
+    // Removing a blocked process takes it off the descriptor too
+    if (faeb_scheduler_schedule_next() != a) return 28;
+    char byte;
+    if (read(fds[0], &byte, 1) != 1) return 29;
+    faeb_scheduler_block_current_fd(fds[0], FAEB_FD_READ);
+    if (faeb_scheduler_remove_process(a) != FAEB_SUCCESS) return 30;
+    faeb_scheduler_get_stats(&stats);
+    if (stats.fd_waiting != 0) return 31;
+    faeb_scheduler_remove_process(b);
+    faeb_process_destroy(a);
+    faeb_process_destroy(b);
+    faeb_fd_unregister(fds[0]);
+    close(fds[0]);
+    close(fds[1]);
+    return 0;
+}
+
+// Echo round trips over as many connections as the descriptor limit
+// allows, up to 8192, all multiplexed by one thread
+int test_performance_io_reactor(void) {
+    struct rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    int pairs = limit.rlim_cur < 16384 + 64 ? (int)(limit.rlim_cur - 64) / 2 : 8192;
+    if (pairs < 16) return 1;
+    
+    int counts[] = { 16, pairs };
+    for (int c = 0; c < 2; c++) {
+        struct io_echo* echoes = calloc(2 * (size_t)counts[c], sizeof(struct io_echo));
+        if (!echoes) return 2;
+        int rounds = 65536 / counts[c] > 4 ? 65536 / counts[c] : 4;
+        faeb_scheduler_stats_t before, after;
+        faeb_scheduler_get_stats(&before);
+        uint64_t start = now_ns();
+        int failures = io_echo_run(echoes, counts[c], rounds);
+        double elapsed = (double)(now_ns() - start);
+        faeb_scheduler_get_stats(&after);
+        free(echoes);
+        if (failures != 0) return 3;
+        
+        uint64_t polls = after.fd_polls - before.fd_polls;
+        uint64_t events = after.fd_events - before.fd_events;
+        printf("  %5d connections: %7.1f ns per round trip, %.1f events per epoll_wait\n",
+               counts[c], elapsed / ((double)counts[c] * rounds),
+               polls ? (double)events / (double)polls : 0.0);
+    }
+    return 0;
+}
@@ -13,20 +13,69 @@
 extern int test_memory_basic(void);
 extern int test_memory_boundaries(void);
 extern int test_memory_cleanup(void);
+extern int test_memory_foreign_free(void);
+extern int test_memory_arena(void);
+extern int test_memory_slab(void);
+extern int test_memory_threads(void);
+extern int test_memory_mmap(void);
+extern int test_memory_aligned(void);
+extern int test_memory_reallocate(void);
+extern int test_memory_stats(void);
+extern int test_memory_batch(void);
 extern int test_process_creation(void);
 extern int test_process_scheduling(void);
 extern int test_process_destruction(void);
+extern int test_process_coroutine(void);
+extern int test_process_priority(void);
+extern int test_process_sleep(void);
+extern int test_process_recycling(void);
 extern int test_io_basic(void);
 extern int test_io_errors(void);
+extern int test_io_async(void);
+extern int test_io_reactor(void);
 extern int test_scheduler_basic(void);
 extern int test_scheduler_timeslices(void);
+extern int test_scheduler_workers(void);
+extern int test_scheduler_timeouts(void);
+extern int test_scheduler_stats(void);
+extern int test_scheduler_instances(void);
+extern int test_scheduler_deadlines(void);
+extern int test_scheduler_placement(void);
+extern int test_future_basic(void);
+extern int test_future_workers(void);
+extern int test_parallel_for(void);
+extern int test_parallel_graph(void);
+extern int test_sync_primitives(void);
+extern int test_sync_workers(void);
+extern int test_channel_basic(void);
+extern int test_channel_workers(void);
 extern int test_verification_memory(void);
 extern int test_verification_type(void);
 extern int test_verification_thread(void);
 extern int test_verification_runtime(void);
 extern int test_integration_complete(void);
 extern int test_performance_memory(void);
+extern int test_performance_memory_free(void);
+extern int test_performance_memory_slab(void);
+extern int test_performance_memory_threads(void);
+extern int test_performance_memory_append(void);
+extern int test_performance_memory_batch(void);
 extern int test_performance_process(void);
+extern int test_performance_process_switch(void);
+extern int test_performance_process_priority(void);
+extern int test_performance_io(void);
+extern int test_performance_io_async(void);
+extern int test_performance_io_reactor(void);
+extern int test_performance_process_spawn(void);
+extern int test_performance_scheduler_workers(void);
+extern int test_performance_scheduler_timers(void);
+extern int test_performance_scheduler_stats(void);
+extern int test_performance_scheduler_shards(void);
+extern int test_performance_scheduler_deadlines(void);
+extern int test_performance_future(void);
+extern int test_performance_parallel(void);
+extern int test_performance_sync(void);
+extern int test_performance_channel(void);
 extern int test_stress_memory(void);
 extern int test_stress_process(void);
 extern int test_edge_null(void);
@@ -46,20 +95,69 @@ static struct test_case tests[] = {
     {"memory_basic", test_memory_basic},
     {"memory_boundaries", test_memory_boundaries},
     {"memory_cleanup", test_memory_cleanup},
+    {"memory_foreign_free", test_memory_foreign_free},
+    {"memory_arena", test_memory_arena},
+    {"memory_slab", test_memory_slab},
+    {"memory_threads", test_memory_threads},
+    {"memory_mmap", test_memory_mmap},
+    {"memory_aligned", test_memory_aligned},
+    {"memory_reallocate", test_memory_reallocate},
+    {"memory_stats", test_memory_stats},
+    {"memory_batch", test_memory_batch},
     {"process_creation", test_process_creation},
     {"process_scheduling", test_process_scheduling},
     {"process_destruction", test_process_destruction},
+    {"process_coroutine", test_process_coroutine},
+    {"process_priority", test_process_priority},
+    {"process_sleep", test_process_sleep},
+    {"process_recycling", test_process_recycling},
     {"io_basic", test_io_basic},
     {"io_errors", test_io_errors},
+    {"io_async", test_io_async},
+    {"io_reactor", test_io_reactor},
     {"scheduler_basic", test_scheduler_basic},
     {"scheduler_timeslices", test_scheduler_timeslices},
+    {"scheduler_workers", test_scheduler_workers},
+    {"scheduler_timeouts", test_scheduler_timeouts},
+    {"scheduler_stats", test_scheduler_stats},
+    {"scheduler_instances", test_scheduler_instances},
+    {"scheduler_deadlines", test_scheduler_deadlines},
+    {"scheduler_placement", test_scheduler_placement},
+    {"future_basic", test_future_basic},
+    {"future_workers", test_future_workers},
+    {"parallel_for", test_parallel_for},
+    {"parallel_graph", test_parallel_graph},
+    {"sync_primitives", test_sync_primitives},
+    {"sync_workers", test_sync_workers},
+    {"channel_basic", test_channel_basic},
+    {"channel_workers", test_channel_workers},
     {"verification_memory", test_verification_memory},
     {"verification_type", test_verification_type},
     {"verification_thread", test_verification_thread},
     {"verification_runtime", test_verification_runtime},
     {"integration_complete", test_integration_complete},
     {"performance_memory", test_performance_memory},
+    {"performance_memory_free", test_performance_memory_free},
+    {"performance_memory_slab", test_performance_memory_slab},
+    {"performance_memory_threads", test_performance_memory_threads},
+    {"performance_memory_append", test_performance_memory_append},
+    {"performance_memory_batch", test_performance_memory_batch},
     {"performance_process", test_performance_process},
+    {"performance_process_switch", test_performance_process_switch},
+    {"performance_process_priority", test_performance_process_priority},
+    {"performance_io", test_performance_io},
+    {"performance_io_async", test_performance_io_async},
+    {"performance_io_reactor", test_performance_io_reactor},
+    {"performance_process_spawn", test_performance_process_spawn},
+    {"performance_scheduler_workers", test_performance_scheduler_workers},
+    {"performance_scheduler_timers", test_performance_scheduler_timers},
+    {"performance_scheduler_stats", test_performance_scheduler_stats},
+    {"performance_scheduler_shards", test_performance_scheduler_shards},
+    {"performance_scheduler_deadlines", test_performance_scheduler_deadlines},
+    {"performance_future", test_performance_future},
+    {"performance_parallel", test_performance_parallel},
+    {"performance_sync", test_performance_sync},
+    {"performance_channel", test_performance_channel},
     {"stress_memory", test_stress_memory},
     {"stress_process", test_stress_process},
     {"edge_null", test_edge_null},
@@ -0,0 +1,735 @@
+/* FAEB Test Suite - Memory Management Tests
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "faeb/runtime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// Monotonic timestamp in nanoseconds
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Deterministic shuffle so frees do not simply follow allocation order
+static void shuffle(void** items, size_t count) {
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = count - 1; i > 0; i--) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        size_t j = (size_t)(state % (i + 1));
+        void* tmp = items[i];
+        items[i] = items[j];
+        items[j] = tmp;
+    }
+}
+
+// Foreign and double frees are rejected without touching the budget
+int test_memory_foreign_free(void) {
+    faeb_memory_t* memory = faeb_memory_create(4096);
+    faeb_memory_t* other = faeb_memory_create(4096);
+    if (!memory || !other) return 1;
+
+    void* a = faeb_memory_allocate(memory, 128);
+    void* b = faeb_memory_allocate(other, 128);
+    if (!a || !b) return 2;
+
+    faeb_memory_free(memory, b);
+    if (faeb_memory_get_last_error(memory) != FAEB_ERROR_INVALID) return 3;
+
+    faeb_memory_free(memory, a);
+    if (faeb_memory_get_last_error(memory) != FAEB_SUCCESS) return 4;
+    faeb_memory_free(memory, a);
+    if (faeb_memory_get_last_error(memory) != FAEB_ERROR_INVALID) return 8;
+
+    // A pointer at the start of a mapping has no readable header in front
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    void* mapping = mmap(NULL, page, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) return 9;
+    faeb_memory_free(memory, mapping);
+    munmap(mapping, page);
+    if (faeb_memory_get_last_error(memory) != FAEB_ERROR_INVALID) return 10;
+
+    // Budget fully returned: the whole pool is available again
+    void* c = faeb_memory_allocate(memory, 4096);
+    if (!c) return 5;
+    if (faeb_memory_allocate(memory, 1) != NULL) return 6;
+    if (faeb_memory_get_last_error(memory) != FAEB_ERROR_LIMIT) return 7;
+
+    faeb_memory_destroy(memory);
+    faeb_memory_destroy(other);
+    return 0;
+}
+
+// Arena carves aligned slices, enforces its budget and resets in bulk
+int test_memory_arena(void) {
+    faeb_memory_t* arena = faeb_memory_create_arena(1024);
+    if (!arena) return 1;
+
+    char* first = faeb_memory_allocate(arena, 10);
+    char* second = faeb_memory_allocate(arena, 10);
+    if (!first || !second) return 2;
+    if ((uintptr_t)second % _Alignof(max_align_t) != 0) return 3;
+    if (second <= first) return 4;
+
+    // Exhaust the region
+    while (faeb_memory_allocate(arena, 100) != NULL) {}
+    if (faeb_memory_get_last_error(arena) != FAEB_ERROR_LIMIT) return 5;
+
+    int outside = 0;
+    faeb_memory_free(arena, &outside);
+    if (faeb_memory_get_last_error(arena) != FAEB_ERROR_INVALID) return 6;
+
+    if (faeb_memory_reset(arena) != FAEB_SUCCESS) return 7;
+    if (faeb_memory_allocate(arena, 1024) != first) return 8;
+
+    // Freeing the most recent allocation rolls the bump pointer back
+    faeb_memory_reset(arena);
+    void* scratch = faeb_memory_allocate(arena, 512);
+    faeb_memory_free(arena, scratch);
+    if (faeb_memory_allocate(arena, 1024) != scratch) return 9;
+
+    faeb_memory_destroy(arena);
+    return 0;
+}
+
+static size_t slab_stats_in_use(faeb_memory_t* memory, size_t class_index) {
+    faeb_memory_class_stats_t stats[FAEB_MEMORY_SLAB_CLASSES];
+    faeb_memory_get_class_stats(memory, stats, FAEB_MEMORY_SLAB_CLASSES);
+    return stats[class_index].objects_in_use;
+}
+
+// Slab classes pack small objects and report occupancy per class
+int test_memory_slab(void) {
+    faeb_memory_config_t config = { .kind = FAEB_MEMORY_SLAB };
+    faeb_memory_t* memory = faeb_memory_create_config(1 << 20, &config);
+    if (!memory) return 1;
+
+    void* small[100];
+    for (int i = 0; i < 100; i++) {
+        small[i] = faeb_memory_allocate(memory, 24);
+        if (!small[i]) return 2;
+    }
+    void* line = faeb_memory_allocate(memory, 100);
+    void* large = faeb_memory_allocate(memory, 4000);
+    if (!line || !large) return 3;
+    if ((uintptr_t)line % FAEB_CACHE_LINE_SIZE != 0) return 4;
+
+    faeb_memory_class_stats_t stats[FAEB_MEMORY_SLAB_CLASSES];
+    size_t classes = faeb_memory_get_class_stats(memory, stats,
+                                                 FAEB_MEMORY_SLAB_CLASSES);
+    if (classes != FAEB_MEMORY_SLAB_CLASSES) return 5;
+    if (stats[1].object_size != 32 || stats[1].objects_in_use != 100) return 6;
+    if (stats[1].objects_capacity < 100 || stats[1].slabs < 1) return 7;
+    if (stats[3].object_size != 128 || stats[3].objects_in_use != 1) return 8;
+
+    char* outside = calloc(1, 256);
+    faeb_memory_free(memory, outside + 128);
+    free(outside);
+    if (faeb_memory_get_last_error(memory) != FAEB_ERROR_INVALID) return 9;
+
+    for (int i = 0; i < 100; i++) {
+        faeb_memory_free(memory, small[i]);
+        if (faeb_memory_get_last_error(memory) != FAEB_SUCCESS) return 10;
+    }
+    faeb_memory_free(memory, line);
+    faeb_memory_free(memory, large);
+    if (faeb_memory_get_last_error(memory) != FAEB_SUCCESS) return 11;
+
+    // Double frees are caught whether the object sits in a magazine or
+    // back in its slab
+    faeb_memory_free(memory, small[99]);
+    if (faeb_memory_get_last_error(memory) != FAEB_ERROR_INVALID) return 14;
+    faeb_memory_free(memory, small[0]);
+    if (faeb_memory_get_last_error(memory) != FAEB_ERROR_INVALID) return 15;
+    faeb_memory_free(memory, line);
+    if (faeb_memory_get_last_error(memory) != FAEB_ERROR_INVALID) return 16;
+
+    faeb_memory_get_class_stats(memory, stats, FAEB_MEMORY_SLAB_CLASSES);
+    if (stats[1].objects_in_use != 0 || stats[1].slabs > 1) return 12;
+
+    // Recycled objects are handed out again
+    void* again = faeb_memory_allocate(memory, 32);
+    if (!again || slab_stats_in_use(memory, 1) != 1) return 13;
+
+    // Freed objects and pointers into the middle of one do not resize
+    void* stale = small[50] != again ? small[50] : small[51];
+    if (faeb_memory_reallocate(memory, stale, 16) != NULL) return 17;
+    if (faeb_memory_get_last_error(memory) != FAEB_ERROR_INVALID) return 18;
+    if (faeb_memory_reallocate(memory, stale, 64) != NULL) return 19;
+    if (faeb_memory_get_last_error(memory) != FAEB_ERROR_INVALID) return 20;
+    if (faeb_memory_reallocate(memory, (char*)again + 8, 16) != NULL) return 21;
+    if (slab_stats_in_use(memory, 1) != 1) return 22;
+
+    faeb_memory_destroy(memory);
+    return 0;
+}
+
+// Small-object churn: slab engine against the heap engine
+int test_performance_memory_slab(void) {
+    const int rounds = 200;
+    const int batch = 1000;
+    void* objects[1000];
+    double per_op[2];
+
+    for (int engine = 0; engine < 2; engine++) {
+        faeb_memory_config_t config = {
+            .kind = engine ? FAEB_MEMORY_SLAB : FAEB_MEMORY_HEAP
+        };
+        faeb_memory_t* memory = faeb_memory_create_config(1 << 24, &config);
+        if (!memory) return 1;
+
+        uint64_t start = now_ns();
+        for (int r = 0; r < rounds; r++) {
+            for (int i = 0; i < batch; i++) {
+                objects[i] = faeb_memory_allocate(memory, 16 + (i % 4) * 16);
+                if (!objects[i]) return 2;
+            }
+            for (int i = 0; i < batch; i++) {
+                faeb_memory_free(memory, objects[i]);
+            }
+        }
+        per_op[engine] = (double)(now_ns() - start) / (rounds * batch * 2.0);
+        faeb_memory_destroy(memory);
+    }
+
+    printf("  heap=%.1f ns/op slab=%.1f ns/op\n", per_op[0], per_op[1]);
+    return 0;
+}
+
+// Mapped regions honour the budget, fall back from huge pages and trim
+int test_memory_mmap(void) {
+    const size_t size = 8 << 20;
+    faeb_memory_config_t config = {
+        .kind = FAEB_MEMORY_ARENA,
+        .flags = FAEB_MEMORY_MMAP | FAEB_MEMORY_HUGEPAGES | FAEB_MEMORY_PREFAULT
+    };
+    faeb_memory_t* arena = faeb_memory_create_config(size, &config);
+    if (!arena) return 1;
+
+    size_t page = faeb_memory_get_page_size(arena);
+    if (page != (size_t)sysconf(_SC_PAGESIZE) && page != (2 << 20)) return 2;
+
+    char* data = faeb_memory_allocate(arena, size);
+    if (!data) return 3;
+    memset(data, 0xab, size);
+    if (faeb_memory_allocate(arena, 1) != NULL) return 4;
+
+    faeb_memory_reset(arena);
+    if (faeb_memory_trim(arena) != FAEB_SUCCESS) return 5;
+    faeb_memory_destroy(arena);
+
+    // Slab pages are carved from the mapping and handed back on trim
+    config.kind = FAEB_MEMORY_SLAB;
+    config.flags = FAEB_MEMORY_MMAP;
+    faeb_memory_t* slab = faeb_memory_create_config(size, &config);
+    if (!slab) return 6;
+
+    void* objects[2000];
+    for (int i = 0; i < 2000; i++) {
+        objects[i] = faeb_memory_allocate(slab, 64 + (i % 3) * 64);
+        if (!objects[i]) return 7;
+    }
+    for (int i = 0; i < 2000; i++) {
+        faeb_memory_free(slab, objects[i]);
+        if (faeb_memory_get_last_error(slab) != FAEB_SUCCESS) return 8;
+    }
+    // Draining this thread's magazines lets empty slabs release pages
+    faeb_memory_class_stats_t stats[FAEB_MEMORY_SLAB_CLASSES];
+    faeb_memory_get_class_stats(slab, stats, FAEB_MEMORY_SLAB_CLASSES);
+    if (faeb_memory_trim(slab) != FAEB_SUCCESS) return 9;
+    if (!faeb_memory_allocate(slab, 64)) return 10;
+    faeb_memory_destroy(slab);
+
+    // Heap managers cannot be backed by a single mapping
+    config.kind = FAEB_MEMORY_HEAP;
+    if (faeb_memory_create_config(size, &config) != NULL) return 11;
+
+    return 0;
+}
+
+// Aligned and cache-line allocations honour alignment on every engine
+int test_memory_aligned(void) {
+    faeb_memory_kind_t kinds[] = {
+        FAEB_MEMORY_HEAP, FAEB_MEMORY_ARENA, FAEB_MEMORY_SLAB
+    };
+    const size_t budget = 1 << 20;
+
+    for (size_t k = 0; k < 3; k++) {
+        faeb_memory_config_t config = { .kind = kinds[k] };
+        faeb_memory_t* memory = faeb_memory_create_config(budget, &config);
+        if (!memory) return 1;
+
+        for (size_t alignment = 8; alignment <= 4096; alignment *= 2) {
+            for (size_t size = 1; size <= 1000; size += 333) {
+                char* p = faeb_memory_allocate_aligned(memory, size, alignment);
+                if (!p || (uintptr_t)p % alignment != 0) return 2;
+                memset(p, 0x5a, size);
+                faeb_memory_free(memory, p);
+                if (faeb_memory_get_last_error(memory) != FAEB_SUCCESS) return 3;
+            }
+        }
+
+        if (faeb_memory_allocate_aligned(memory, 64, 48) != NULL) return 4;
+        if (faeb_memory_get_last_error(memory) != FAEB_ERROR_INVALID) return 5;
+
+        // Neighbouring counters never share a cache line
+        char* a = faeb_memory_allocate_cacheline(memory, 8);
+        char* b = faeb_memory_allocate_cacheline(memory, 8);
+        if (!a || !b) return 6;
+        if ((uintptr_t)a % FAEB_CACHE_LINE_SIZE || (uintptr_t)b % FAEB_CACHE_LINE_SIZE) return 7;
+        if ((uintptr_t)a / FAEB_CACHE_LINE_SIZE == (uintptr_t)b / FAEB_CACHE_LINE_SIZE) return 8;
+        faeb_memory_free(memory, a);
+        faeb_memory_free(memory, b);
+
+        // Heap and slab budgets come back in full
+        if (kinds[k] != FAEB_MEMORY_ARENA) {
+            void* all = faeb_memory_allocate(memory, budget);
+            if (!all) return 9;
+            faeb_memory_free(memory, all);
+        }
+
+        faeb_memory_destroy(memory);
+    }
+
+    // Over-aligned heap blocks keep their alignment as they grow,
+    // including those whose header needs no padding to get it
+    faeb_memory_t* heap = faeb_memory_create(budget);
+    if (!heap) return 10;
+    size_t alignments[] = { 32, 64, 4096 };
+    for (size_t n = 0; n < 3; n++) {
+        unsigned char* blocks[64];
+        for (size_t i = 0; i < 64; i++) {
+            blocks[i] = faeb_memory_allocate_aligned(heap, 24, alignments[n]);
+            if (!blocks[i]) return 10;
+            memset(blocks[i], (int)i, 24);
+        }
+        for (size_t i = 0; i < 64; i++) {
+            blocks[i] = faeb_memory_reallocate(heap, blocks[i], 256 + 16 * i);
+            if (!blocks[i] || (uintptr_t)blocks[i] % alignments[n] != 0) return 11;
+            if (blocks[i][0] != (unsigned char)i || blocks[i][23] != (unsigned char)i) {
+                return 12;
+            }
+        }
+        for (size_t i = 0; i < 64; i++) {
+            faeb_memory_free(heap, blocks[i]);
+        }
+    }
+    faeb_memory_destroy(heap);
+    return 0;
+}
+
+// Reallocation keeps contents and budget exact, in place where possible
+int test_memory_reallocate(void) {
+    faeb_memory_kind_t kinds[] = {
+        FAEB_MEMORY_HEAP, FAEB_MEMORY_ARENA, FAEB_MEMORY_SLAB
+    };
+    const size_t budget = 1 << 20;
+
+    for (size_t k = 0; k < 3; k++) {
+        faeb_memory_config_t config = { .kind = kinds[k] };
+        faeb_memory_t* memory = faeb_memory_create_config(budget, &config);
+        if (!memory) return 1;
+
+        unsigned char* buffer = faeb_memory_reallocate(memory, NULL, 16);
+        if (!buffer) return 2;
+        for (size_t i = 0; i < 16; i++) buffer[i] = (unsigned char)i;
+
+        size_t size = 16;
+        while (size < 64 * 1024) {
+            size *= 2;
+            buffer = faeb_memory_reallocate(memory, buffer, size);
+            if (!buffer) return 3;
+            for (size_t i = 0; i < 16; i++) {
+                if (buffer[i] != (unsigned char)i) return 4;
+            }
+        }
+
+        // Growing past the budget fails and leaves the block intact
+        if (faeb_memory_reallocate(memory, buffer, budget * 2) != NULL) return 5;
+        if (faeb_memory_get_last_error(memory) != FAEB_ERROR_LIMIT) return 6;
+        if (buffer[15] != 15) return 7;
+
+        // Shrinking never moves the block and hands the tail back to
+        // the budget at once
+        if (faeb_memory_reallocate(memory, buffer, 8) != buffer) return 8;
+        if (buffer[7] != 7) return 11;
+        if (kinds[k] != FAEB_MEMORY_ARENA) {
+            void* rest = faeb_memory_allocate(memory, budget - 8);
+            if (!rest) return 12;
+            faeb_memory_free(memory, rest);
+        }
+
+        // The arena tail grows without moving
+        if (kinds[k] == FAEB_MEMORY_ARENA &&
+            faeb_memory_reallocate(memory, buffer, 4096) != buffer) return 9;
+
+        faeb_memory_free(memory, buffer);
+        if (kinds[k] != FAEB_MEMORY_ARENA) {
+            void* all = faeb_memory_allocate(memory, budget);
+            if (!all) return 10;
+            faeb_memory_free(memory, all);
+        }
+        faeb_memory_destroy(memory);
+    }
+
+    // An arena block followed by another moves to grow, taking its own
+    // contents and leaving its neighbour's alone
+    faeb_memory_config_t config = { .kind = FAEB_MEMORY_ARENA };
+    faeb_memory_t* arena = faeb_memory_create_config(budget, &config);
+    if (!arena) return 13;
+    unsigned char* inner = faeb_memory_allocate(arena, 16);
+    unsigned char* next = faeb_memory_allocate(arena, 64);
+    if (!inner || !next) return 13;
+    memset(inner, 0x11, 16);
+    memset(next, 0x22, 64);
+    unsigned char* grown = faeb_memory_reallocate(arena, inner, 48);
+    if (!grown || grown == inner) return 14;
+    memset(grown + 16, 0x33, 32);
+    for (size_t i = 0; i < 16; i++) {
+        if (grown[i] != 0x11) return 15;
+    }
+    for (size_t i = 0; i < 64; i++) {
+        if (next[i] != 0x22) return 16;
+    }
+
+    // Shrunk in place it grows back only by moving again
+    if (faeb_memory_reallocate(arena, next, 8) != next) return 17;
+    if (faeb_memory_reallocate(arena, next, 32) == next) return 18;
+    if (faeb_memory_reallocate(arena, grown + 8, 16) != NULL) return 19;
+    if (faeb_memory_get_last_error(arena) != FAEB_ERROR_INVALID) return 20;
+    faeb_memory_destroy(arena);
+    return 0;
+}
+
+// Telemetry counts allocations, sizes, peak usage and budget refusals
+int test_memory_stats(void) {
+    faeb_memory_t* memory = faeb_memory_create(4096);
+    if (!memory) return 1;
+
+    void* a = faeb_memory_allocate(memory, 100);   // bucket 6
+    void* b = faeb_memory_allocate(memory, 1000);  // bucket 9
+    void* c = faeb_memory_allocate(memory, 1024);  // bucket 10
+    if (!a || !b || !c) return 2;
+    if (faeb_memory_allocate(memory, 4096) != NULL) return 3;
+    faeb_memory_free(memory, b);
+
+    faeb_memory_stats_t stats;
+    if (faeb_memory_get_stats(memory, &stats) != FAEB_SUCCESS) return 4;
+    if (stats.allocations != 3 || stats.frees != 1) return 5;
+    if (stats.limit_hits != 1) return 6;
+    if (stats.bytes_live != 1124 || stats.bytes_peak != 2124) return 7;
+    if (stats.size_histogram[6] != 1 || stats.size_histogram[9] != 1 ||
+        stats.size_histogram[10] != 1) return 8;
+    if (stats.total_size != 4096 || stats.allocations_per_second <= 0.0) return 9;
+    if (stats.numa_node != -1) return 14;
+
+    // Sample every allocation and get the stacks back
+    if (faeb_memory_profile_start(memory, 1) != FAEB_SUCCESS) return 10;
+    for (int i = 0; i < 5; i++) {
+        faeb_memory_free(memory, faeb_memory_allocate(memory, 32));
+    }
+    faeb_memory_profile_start(memory, 0);
+    faeb_memory_free(memory, faeb_memory_allocate(memory, 32));
+
+    faeb_memory_sample_t samples[8];
+    size_t taken = faeb_memory_profile_read(memory, samples, 8);
+    if (taken != 5) return 11;
+    for (size_t i = 0; i < taken; i++) {
+        if (samples[i].size != 32) return 12;
+        if (samples[i].depth > FAEB_MEMORY_PROFILE_DEPTH) return 13;
+    }
+
+    faeb_memory_destroy(memory);
+    return 0;
+}
+
+// Batches are all or nothing against the budget and free in one call
+int test_memory_batch(void) {
+    faeb_memory_kind_t kinds[] = {
+        FAEB_MEMORY_HEAP, FAEB_MEMORY_ARENA, FAEB_MEMORY_SLAB
+    };
+
+    for (size_t k = 0; k < 3; k++) {
+        faeb_memory_config_t config = { .kind = kinds[k] };
+        faeb_memory_t* memory = faeb_memory_create_config(64 * 1024, &config);
+        if (!memory) return 1;
+
+        void* ptrs[1024];
+        if (faeb_memory_allocate_batch(memory, 64, ptrs, 512) != FAEB_SUCCESS) return 2;
+        for (size_t i = 0; i < 512; i++) {
+            if (!ptrs[i]) return 3;
+            memset(ptrs[i], (int)i, 64);
+        }
+
+        // A batch that does not fit leaves everything as it was
+        void* more[1024] = { NULL };
+        if (faeb_memory_allocate_batch(memory, 64, more, 1024) != FAEB_ERROR_LIMIT) return 4;
+        if (more[0] != NULL) return 5;
+
+        faeb_memory_stats_t stats;
+        faeb_memory_get_stats(memory, &stats);
+        if (stats.allocations != 512 || stats.limit_hits != 1) return 6;
+
+        faeb_memory_free_batch(memory, ptrs, 512);
+        if (faeb_memory_get_last_error(memory) != FAEB_SUCCESS) return 7;
+        faeb_memory_get_stats(memory, &stats);
+        if (stats.frees != 512) return 8;
+
+        if (kinds[k] == FAEB_MEMORY_ARENA) {
+            faeb_memory_reset(memory);
+        } else if (stats.bytes_live != 0) {
+            return 9;
+        }
+
+        // The whole budget is usable again in one batch
+        if (faeb_memory_allocate_batch(memory, 64, ptrs, 1024) != FAEB_SUCCESS) return 10;
+        faeb_memory_free_batch(memory, ptrs, 1024);
+        faeb_memory_destroy(memory);
+    }
+    return 0;
+}
+
+// Worker for the concurrent tests: churn objects of mixed sizes
+struct memory_worker {
+    faeb_memory_t* memory;
+    int iterations;
+    int failures;
+};
+
+static void* memory_worker_run(void* arg) {
+    struct memory_worker* worker = arg;
+    void* live[64];
+
+    for (int i = 0; i < worker->iterations; i++) {
+        for (int j = 0; j < 64; j++) {
+            size_t size = (size_t)(8 + ((i + j) % 48) * 8);
+            live[j] = faeb_memory_allocate(worker->memory, size);
+            if (!live[j]) {
+                worker->failures++;
+            } else {
+                memset(live[j], j, size);
+            }
+        }
+        for (int j = 0; j < 64; j++) {
+            faeb_memory_free(worker->memory, live[j]);
+        }
+    }
+    return NULL;
+}
+
+static int memory_run_workers(faeb_memory_t* memory, int threads,
+                              int iterations) {
+    pthread_t ids[64];
+    struct memory_worker workers[64];
+    int failures = 0;
+
+    for (int t = 0; t < threads; t++) {
+        workers[t] = (struct memory_worker){ memory, iterations, 0 };
+        pthread_create(&ids[t], NULL, memory_worker_run, &workers[t]);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        failures += workers[t].failures;
+    }
+    return failures;
+}
+
+// Concurrent churn keeps the shared budget exact for every engine
+int test_memory_threads(void) {
+    const size_t budget = 4 << 20;
+    faeb_memory_kind_t kinds[] = { FAEB_MEMORY_HEAP, FAEB_MEMORY_SLAB };
+
+    for (size_t k = 0; k < 2; k++) {
+        faeb_memory_config_t config = { .kind = kinds[k] };
+        faeb_memory_t* memory = faeb_memory_create_config(budget, &config);
+        if (!memory) return 1;
+
+        if (memory_run_workers(memory, 8, 2000) != 0) return 2;
+
+        // Every byte came back: the whole budget is allocatable again
+        void* all = faeb_memory_allocate(memory, budget);
+        if (!all) return 3;
+        faeb_memory_free(memory, all);
+
+        faeb_memory_destroy(memory);
+    }
+    return 0;
+}
+
+// Amortized append throughput: reallocate against allocate-copy-free
+int test_performance_memory_append(void) {
+    const size_t total = 64 * 1024;
+    const size_t chunk = 64;
+    char record[64];
+    memset(record, 0x42, sizeof(record));
+
+    // The arena never reclaims the copied-from buffers, so the budget
+    // must cover the sum of every intermediate size (total^2 / 2 chunk)
+    faeb_memory_kind_t kinds[] = { FAEB_MEMORY_HEAP, FAEB_MEMORY_ARENA };
+    const char* names[] = { "heap", "arena" };
+
+    for (size_t k = 0; k < 2; k++) {
+        for (int use_realloc = 0; use_realloc < 2; use_realloc++) {
+            faeb_memory_config_t config = { .kind = kinds[k] };
+            faeb_memory_t* memory = faeb_memory_create_config(64 << 20, &config);
+            if (!memory) return 1;
+
+            char* buffer = NULL;
+            uint64_t start = now_ns();
+            for (size_t length = 0; length < total; length += chunk) {
+                if (use_realloc) {
+                    buffer = faeb_memory_reallocate(memory, buffer, length + chunk);
+                    if (!buffer) return 2;
+                } else {
+                    char* grown = faeb_memory_allocate(memory, length + chunk);
+                    if (!grown) return 3;
+                    if (buffer) {
+                        memcpy(grown, buffer, length);
+                        faeb_memory_free(memory, buffer);
+                    }
+                    buffer = grown;
+                }
+                memcpy(buffer + length, record, chunk);
+            }
+            double seconds = (double)(now_ns() - start) / 1e9;
+
+            printf("  %-5s %-18s %.1f MB/s\n", names[k],
+                   use_realloc ? "reallocate" : "allocate-copy-free",
+                   (double)total / seconds / 1e6);
+            faeb_memory_destroy(memory);
+        }
+    }
+    return 0;
+}
+
+// Burst allocation: batch calls against one call per object
+int test_performance_memory_batch(void) {
+    const int rounds = 2000;
+    const size_t burst = 256;
+    void* ptrs[256];
+
+    faeb_memory_kind_t kinds[] = { FAEB_MEMORY_HEAP, FAEB_MEMORY_SLAB };
+    const char* names[] = { "heap", "slab" };
+
+    for (size_t k = 0; k < 2; k++) {
+        for (int batched = 0; batched < 2; batched++) {
+            faeb_memory_config_t config = { .kind = kinds[k] };
+            faeb_memory_t* memory = faeb_memory_create_config(16 << 20, &config);
+            if (!memory) return 1;
+
+            uint64_t start = now_ns();
+            for (int r = 0; r < rounds; r++) {
+                if (batched) {
+                    if (faeb_memory_allocate_batch(memory, 64, ptrs, burst) != FAEB_SUCCESS) return 2;
+                    faeb_memory_free_batch(memory, ptrs, burst);
+                } else {
+                    for (size_t i = 0; i < burst; i++) {
+                        ptrs[i] = faeb_memory_allocate(memory, 64);
+                        if (!ptrs[i]) return 3;
+                    }
+                    for (size_t i = 0; i < burst; i++) {
+                        faeb_memory_free(memory, ptrs[i]);
+                    }
+                }
+            }
+            double per_object = (double)(now_ns() - start) / (rounds * (double)burst);
+
+            printf("  %-4s %-10s %.1f ns/object\n", names[k],
+                   batched ? "batch" : "per-object", per_object);
+            faeb_memory_destroy(memory);
+        }
+    }
+    return 0;
+}
+
+// Slab throughput from 1 to N threads sharing one manager
+int test_performance_memory_threads(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = cpus > 4 ? (int)cpus : 4;
+    if (max_threads > 64) max_threads = 64;
+    const int iterations = 5000;
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        faeb_memory_config_t config = { .kind = FAEB_MEMORY_SLAB };
+        faeb_memory_t* memory = faeb_memory_create_config(64 << 20, &config);
+        if (!memory) return 1;
+
+        uint64_t start = now_ns();
+        if (memory_run_workers(memory, threads, iterations) != 0) return 2;
+        double seconds = (double)(now_ns() - start) / 1e9;
+        double ops = (double)threads * iterations * 64 * 2;
+
+        printf("  threads=%-3d %.1f Mops/s\n", threads, ops / seconds / 1e6);
+        faeb_memory_destroy(memory);
+    }
+    return 0;
+}
+
+// Free latency must stay flat as the number of live blocks grows. Each
+// size frees the same number of blocks, picked at random among the live
+// ones, and allocates them again, so every size walks the same amount of
+// memory; rounds are averaged.
+int test_performance_memory_free(void) {
+    const size_t max_live = 1000000;
+    const size_t sample = 1000;
+    const int rounds = 20;
+    void** blocks = malloc(max_live * sizeof(void*));
+    if (!blocks) return 1;
+
+    double baseline = 0.0;
+    double worst = 0.0;
+
+    for (size_t live = 10; live <= max_live; live *= 10) {
+        faeb_memory_t* memory = faeb_memory_create(live * 64);
+        if (!memory) return 2;
+
+        for (size_t i = 0; i < live; i++) {
+            blocks[i] = faeb_memory_allocate(memory, 64);
+            if (!blocks[i]) return 3;
+        }
+        shuffle(blocks, live);
+
+        // The first round only warms up
+        size_t count = live < sample ? live : sample;
+        uint64_t total = 0;
+        for (int round = 0; round <= rounds; round++) {
+            shuffle(blocks, count);
+            uint64_t start = now_ns();
+            for (size_t i = 0; i < count; i++) {
+                faeb_memory_free(memory, blocks[i]);
+            }
+            if (round > 0) total += now_ns() - start;
+            for (size_t i = 0; i < count; i++) {
+                blocks[i] = faeb_memory_allocate(memory, 64);
+                if (!blocks[i]) return 3;
+            }
+        }
+        double per_free = (double)total / (double)(count * (size_t)rounds);
+
+        printf("  live=%-8zu free=%.1f ns\n", live, per_free);
+        if (live == sample) baseline = per_free;
+        if (live > sample && per_free > worst) worst = per_free;
+
+        faeb_memory_destroy(memory);
+    }
+
+    free(blocks);
+
+    // Smaller sizes are too noisy to compare against. A walk over the
+    // live blocks would be ~1000x slower at 1M than at 1k; the index's
+    // cache misses on large tables stay well within 4x.
+    return worst <= baseline * 4.0 ? 0 : 4;
+}
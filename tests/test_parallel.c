@@ -0,0 +1,301 @@
+/* FAEB Test Suite - Parallel Loop and Task Graph Tests
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "faeb/runtime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+
+// Monotonic timestamp in nanoseconds
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+struct parallel_cover {
+    _Atomic uint8_t* hits;     // Times each index was visited
+    _Atomic uint64_t sum;
+    _Atomic int chunks;
+    size_t spin;               // Busy work per index
+};
+
+static void parallel_visit(void* context, size_t begin, size_t end) {
+    struct parallel_cover* cover = context;
+    uint64_t sum = 0;
+    for (size_t i = begin; i < end; i++) {
+        atomic_fetch_add_explicit(&cover->hits[i], 1, memory_order_relaxed);
+        sum += i;
+        for (volatile size_t j = 0; j < cover->spin; j++) {}
+    }
+    atomic_fetch_add(&cover->sum, sum);
+    atomic_fetch_add(&cover->chunks, 1);
+}
+
+// Run [begin, end) and check every index was visited exactly once
+static int parallel_check(size_t begin, size_t end, size_t grain, int* chunks) {
+    struct parallel_cover cover = { .hits = calloc(end + 1, sizeof(_Atomic uint8_t)) };
+    if (!cover.hits) return 1;
+    atomic_init(&cover.sum, 0);
+    atomic_init(&cover.chunks, 0);
+    int failures = 0;
+    if (faeb_parallel_for(begin, end, grain, parallel_visit, &cover) != FAEB_SUCCESS) failures++;
+    for (size_t i = 0; i <= end; i++) {
+        if (cover.hits[i] != (i >= begin && i < end ? 1 : 0)) failures++;
+    }
+    uint64_t expected = (uint64_t)end * (end - 1) / 2 - (begin ? (uint64_t)begin * (begin - 1) / 2 : 0);
+    if (begin < end && cover.sum != expected) failures++;
+    if (chunks) {
+        *chunks = cover.chunks;
+    }
+    free(cover.hits);
+    return failures;
+}
+
+struct parallel_nested {
+    int failures;
+    int chunks;
+};
+
+static void parallel_nested_main(void* context) {
+    struct parallel_nested* nested = context;
+    nested->failures = parallel_check(0, 20000, 16, &nested->chunks);
+}
+
+// Coverage of parallel_for with and without workers, from a thread and
+// from inside a process on a worker
+int test_parallel_for(void) {
+    // Without workers the body gets the whole range at once
+    int chunks = 0;
+    if (parallel_check(3, 1000, 0, &chunks) || chunks != 1) return 1;
+    if (faeb_parallel_for(5, 5, 1, parallel_visit, NULL) != FAEB_SUCCESS) return 2;
+    if (faeb_parallel_for(5, 4, 1, parallel_visit, NULL) != FAEB_ERROR_INVALID) return 3;
+    if (faeb_parallel_for(0, 4, 1, NULL, NULL) != FAEB_ERROR_INVALID) return 4;
+    
+    if (faeb_scheduler_init_workers(4) != FAEB_SUCCESS) return 5;
+    
+    // Guided chunks: many, but far fewer than grain-sized ones
+    if (parallel_check(0, 100000, 1, &chunks)) return 6;
+    if (chunks < 2 || chunks > 5000) return 7;
+    if (parallel_check(7, 100007, 0, NULL)) return 8;
+    if (parallel_check(0, 1000, 1000, &chunks) || chunks != 1) return 9;
+    if (parallel_check(0, 3, 1, NULL)) return 10;
+    
+    // A process on a worker takes part in its own loop and parks for it
+    struct parallel_nested nested[4] = { 0 };
+    faeb_process_t* processes[4];
+    for (int i = 0; i < 4; i++) {
+        processes[i] = faeb_process_create(parallel_nested_main, &nested[i]);
+        if (!processes[i] || faeb_scheduler_submit(processes[i]) != FAEB_SUCCESS) return 11;
+    }
+    faeb_scheduler_wait();
+    for (int i = 0; i < 4; i++) {
+        if (nested[i].failures || nested[i].chunks < 1) return 12;
+        faeb_process_destroy(processes[i]);
+    }
+    
+    faeb_scheduler_shutdown_workers();
+    return 0;
+}
+
+struct graph_log {
+    _Atomic int clock;
+    int finished[64];          // Clock at which each task finished
+    int started[64];
+    size_t spin;
+};
+
+struct graph_node {
+    struct graph_log* log;
+    int id;
+};
+
+static void graph_step(void* context) {
+    struct graph_node* node = context;
+    node->log->started[node->id] = atomic_fetch_add(&node->log->clock, 1);
+    for (volatile size_t j = 0; j < node->log->spin; j++) {}
+    node->log->finished[node->id] = atomic_fetch_add(&node->log->clock, 1);
+}
+
+// A task must start after each of its dependencies finished
+static int graph_ordered(struct graph_log* log, int task, const size_t* dependencies, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (log->started[task] <= log->finished[dependencies[i]]) return 1;
+    }
+    return 0;
+}
+
+// Build a diamond fanning out to width tasks and back in, run it and
+// check the order
+static int graph_diamond(int width, int runs) {
+    struct graph_log log = { .spin = 2000 };
+    struct graph_node nodes[64];
+    faeb_graph_t* graph = faeb_graph_create();
+    if (!graph) return 1;
+    
+    size_t top, bottom, middle[62];
+    nodes[0] = (struct graph_node){ &log, 0 };
+    if (faeb_graph_add_task(graph, graph_step, &nodes[0], NULL, 0, &top) != FAEB_SUCCESS) return 2;
+    for (int i = 0; i < width; i++) {
+        nodes[1 + i] = (struct graph_node){ &log, 1 + i };
+        if (faeb_graph_add_task(graph, graph_step, &nodes[1 + i], &top, 1, &middle[i]) != FAEB_SUCCESS) {
+            return 3;
+        }
+    }
+    nodes[1 + width] = (struct graph_node){ &log, 1 + width };
+    if (faeb_graph_add_task(graph, graph_step, &nodes[1 + width], middle, (size_t)width,
+                            &bottom) != FAEB_SUCCESS) {
+        return 4;
+    }
+    
+    for (int run = 0; run < runs; run++) {
+        atomic_store(&log.clock, 1);
+        memset(log.started, 0, sizeof(log.started));
+        if (faeb_graph_run(graph) != FAEB_SUCCESS) return 5;
+        for (int i = 0; i < width; i++) {
+            if (graph_ordered(&log, 1 + i, &top, 1)) return 6;
+        }
+        if (graph_ordered(&log, 1 + width, middle, (size_t)width)) return 7;
+        if (atomic_load(&log.clock) != 1 + 2 * (width + 2)) return 8;
+    }
+    faeb_graph_destroy(graph);
+    return 0;
+}
+
+// A chain: each task depends on the previous one
+static int graph_chain(int length) {
+    struct graph_log log = { .spin = 100 };
+    struct graph_node nodes[64];
+    faeb_graph_t* graph = faeb_graph_create();
+    if (!graph) return 1;
+    for (int i = 0; i < length; i++) {
+        nodes[i] = (struct graph_node){ &log, i };
+        size_t previous = (size_t)i - 1;
+        if (faeb_graph_add_task(graph, graph_step, &nodes[i], &previous, i ? 1 : 0,
+                                NULL) != FAEB_SUCCESS) {
+            return 2;
+        }
+    }
+    atomic_store(&log.clock, 1);
+    if (faeb_graph_run(graph) != FAEB_SUCCESS) return 3;
+    for (int i = 1; i < length; i++) {
+        size_t previous = (size_t)i - 1;
+        if (graph_ordered(&log, i, &previous, 1)) return 4;
+    }
+    faeb_graph_destroy(graph);
+    return 0;
+}
+
+struct graph_runner {
+    int failures;
+};
+
+static void graph_runner_main(void* context) {
+    struct graph_runner* runner = context;
+    runner->failures = graph_diamond(8, 3);
+}
+
+// Dependency order of task graphs with and without workers, from a
+// thread and from processes on the workers
+int test_parallel_graph(void) {
+    faeb_graph_t* graph = faeb_graph_create();
+    if (!graph) return 1;
+    size_t first, bogus = 1;
+    struct graph_log log = { 0 };
+    struct graph_node node = { &log, 0 };
+    if (faeb_graph_add_task(graph, NULL, NULL, NULL, 0, NULL) != FAEB_ERROR_INVALID) return 2;
+    if (faeb_graph_add_task(graph, graph_step, &node, &bogus, 1, NULL) != FAEB_ERROR_INVALID) return 3;
+    if (faeb_graph_add_task(graph, graph_step, &node, NULL, 0, &first) != FAEB_SUCCESS) return 4;
+    if (first != 0) return 5;
+    if (faeb_graph_add_task(graph, graph_step, &node, &first, 1, NULL) != FAEB_SUCCESS) return 6;
+    if (faeb_graph_add_task(graph, graph_step, &node, &bogus, 1, NULL) != FAEB_SUCCESS) return 7;
+    size_t several[] = { 0, 1, 5 };
+    if (faeb_graph_add_task(graph, graph_step, &node, several, 3, NULL) != FAEB_ERROR_INVALID) return 8;
+    if (faeb_graph_run(graph) != FAEB_SUCCESS || atomic_load(&log.clock) != 6) return 9;
+    faeb_graph_destroy(graph);
+    
+    // An empty graph runs to completion either way
+    graph = faeb_graph_create();
+    if (faeb_graph_run(graph) != FAEB_SUCCESS) return 10;
+    
+    // Without workers tasks run in id order, which respects dependencies
+    if (graph_diamond(6, 1) || graph_chain(20)) return 11;
+    
+    if (faeb_scheduler_init_workers(4) != FAEB_SUCCESS) return 12;
+    if (faeb_graph_run(graph) != FAEB_SUCCESS) return 13;
+    faeb_graph_destroy(graph);
+    if (graph_diamond(1, 5) || graph_diamond(16, 5) || graph_diamond(62, 3)) return 14;
+    if (graph_chain(64)) return 15;
+    
+    // Processes running graphs park until their graph finishes
+    struct graph_runner runners[4] = { 0 };
+    faeb_process_t* processes[4];
+    for (int i = 0; i < 4; i++) {
+        processes[i] = faeb_process_create(graph_runner_main, &runners[i]);
+        if (!processes[i] || faeb_scheduler_submit(processes[i]) != FAEB_SUCCESS) return 16;
+    }
+    faeb_scheduler_wait();
+    for (int i = 0; i < 4; i++) {
+        if (runners[i].failures) return 17;
+        faeb_process_destroy(processes[i]);
+    }
+    
+    faeb_scheduler_shutdown_workers();
+    return 0;
+}
+
+static void parallel_noop(void* context) {
+    (void)context;
+}
+
+// Loop throughput against worker count, and the cost of dispatching a
+// graph task
+int test_performance_parallel(void) {
+    enum { ITEMS = 1 << 20 };
+    struct parallel_cover cover = { .hits = calloc(ITEMS, sizeof(_Atomic uint8_t)), .spin = 50 };
+    if (!cover.hits) return 1;
+    
+    int counts[] = { 0, 1, 2, 4, 8 };
+    for (int c = 0; c < 5; c++) {
+        if (counts[c] && faeb_scheduler_init_workers(counts[c]) != FAEB_SUCCESS) return 2;
+        atomic_store(&cover.chunks, 0);
+        uint64_t start = now_ns();
+        if (faeb_parallel_for(0, ITEMS, 0, parallel_visit, &cover) != FAEB_SUCCESS) return 3;
+        double elapsed = (double)(now_ns() - start) / 1e6;
+        printf("  parallel_for 1M items, %d workers: %.2f ms in %d chunks\n",
+               counts[c], elapsed, atomic_load(&cover.chunks));
+        if (counts[c]) faeb_scheduler_shutdown_workers();
+    }
+    free(cover.hits);
+    
+    // Layers of empty tasks, each depending on the whole layer before:
+    // per-task cost of counting down and handing tasks to workers
+    enum { WIDTH = 32, LAYERS = 500, TASKS = WIDTH * LAYERS };
+    faeb_graph_t* graph = faeb_graph_create();
+    if (!graph) return 4;
+    size_t layer[WIDTH] = { 0 };
+    for (int l = 0; l < LAYERS; l++) {
+        size_t previous[WIDTH];
+        memcpy(previous, layer, sizeof(layer));
+        for (int i = 0; i < WIDTH; i++) {
+            if (faeb_graph_add_task(graph, parallel_noop, NULL, previous, l ? WIDTH : 0,
+                                    &layer[i]) != FAEB_SUCCESS) {
+                return 5;
+            }
+        }
+    }
+    if (faeb_scheduler_init_workers(4) != FAEB_SUCCESS) return 6;
+    uint64_t start = now_ns();
+    if (faeb_graph_run(graph) != FAEB_SUCCESS) return 7;
+    printf("  graph of %d tasks in layers of %d on 4 workers: %.1f ns per task\n",
+           TASKS, WIDTH, (double)(now_ns() - start) / TASKS);
+    faeb_scheduler_shutdown_workers();
+    faeb_graph_destroy(graph);
+    return 0;
+}
@@ -0,0 +1,401 @@
+/* FAEB Test Suite - Process Management Tests
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "faeb/runtime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+
+// Monotonic timestamp in nanoseconds
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Shared trace of which process ran which step
+struct coroutine_trace {
+    int entries[128];
+    int count;
+};
+
+struct coroutine_step {
+    struct coroutine_trace* trace;
+    int id;
+    int steps;
+};
+
+// Records id * 100 + step before each yield; the loop counter lives on
+// the process stack and must survive every suspension
+static void coroutine_stepper(void* context) {
+    struct coroutine_step* step = context;
+    for (int i = 0; i < step->steps; i++) {
+        step->trace->entries[step->trace->count++] = step->id * 100 + i;
+        faeb_process_yield();
+    }
+}
+
+// Burns stack in every frame so the run needs a larger stack
+static int coroutine_recurse(int depth) {
+    volatile char frame[1024];
+    frame[0] = (char)depth;
+    if (depth == 0) return frame[0];
+    int result = coroutine_recurse(depth - 1) + 1;
+    faeb_process_yield();
+    return result + frame[0] - (char)depth;
+}
+
+static void coroutine_deep(void* context) {
+    *(int*)context = coroutine_recurse(200);
+}
+
+// Yield suspends mid-function and resumes exactly where it left off
+int test_process_coroutine(void) {
+    struct coroutine_trace trace = { .count = 0 };
+    struct coroutine_step first = { &trace, 1, 3 };
+    struct coroutine_step second = { &trace, 2, 3 };
+
+    faeb_process_t* a = faeb_process_create(coroutine_stepper, &first);
+    faeb_process_t* b = faeb_process_create(coroutine_stepper, &second);
+    if (!a || !b) return 1;
+
+    faeb_scheduler_run();
+
+    const int expected[] = { 100, 200, 101, 201, 102, 202 };
+    if (trace.count != 6) return 2;
+    if (memcmp(trace.entries, expected, sizeof(expected)) != 0) return 3;
+    if (!faeb_process_is_terminated(a) || !faeb_process_is_terminated(b)) return 4;
+
+    // Finished processes are not started again
+    faeb_process_run(a);
+    if (trace.count != 6) return 5;
+    faeb_process_destroy(a);
+    faeb_process_destroy(b);
+
+    // Stepping a process by hand, then abandoning it while suspended
+    trace.count = 0;
+    faeb_process_t* manual = faeb_process_create(coroutine_stepper, &first);
+    if (!manual) return 6;
+    faeb_process_run(manual);
+    faeb_process_run(manual);
+    if (trace.count != 2 || trace.entries[1] != 101) return 7;
+    if (faeb_process_is_terminated(manual)) return 8;
+    faeb_process_destroy(manual);
+
+    // A larger configured stack holds deep recursion across yields
+    int depth = 0;
+    faeb_process_config_t config = { .stack_size = 512 << 10 };
+    faeb_process_t* deep = faeb_process_create_config(coroutine_deep, &depth, &config);
+    if (!deep) return 9;
+    faeb_scheduler_run();
+    if (depth != 200 || !faeb_process_is_terminated(deep)) return 10;
+    faeb_process_destroy(deep);
+
+    // Yield outside of any process does nothing
+    faeb_process_yield();
+    return 0;
+}
+
+// Higher priorities run first; aging lets a starved process through
+int test_process_priority(void) {
+    struct coroutine_trace trace = { .count = 0 };
+    struct coroutine_step low = { &trace, 1, 2 };
+    struct coroutine_step high = { &trace, 2, 2 };
+
+    faeb_process_t* a = faeb_process_create(coroutine_stepper, &low);
+    faeb_process_t* b = faeb_process_create(coroutine_stepper, &high);
+    if (!a || !b) return 1;
+    if (faeb_process_get_priority(a) != FAEB_PROCESS_PRIORITY_DEFAULT) return 2;
+    if (faeb_process_set_priority(a, FAEB_PROCESS_PRIORITIES) != FAEB_ERROR_INVALID) return 3;
+    if (faeb_process_set_priority(a, 2) != FAEB_SUCCESS) return 4;
+    if (faeb_process_set_priority(b, 30) != FAEB_SUCCESS) return 5;
+
+    faeb_scheduler_run();
+
+    const int expected[] = { 200, 201, 100, 101 };
+    if (trace.count != 4) return 6;
+    if (memcmp(trace.entries, expected, sizeof(expected)) != 0) return 7;
+    faeb_process_destroy(a);
+    faeb_process_destroy(b);
+
+    // A busy high-priority process cannot hold off a low one forever
+    trace.count = 0;
+    struct coroutine_step busy = { &trace, 3, 100 };
+    struct coroutine_step starved = { &trace, 4, 1 };
+    a = faeb_process_create(coroutine_stepper, &busy);
+    b = faeb_process_create(coroutine_stepper, &starved);
+    if (!a || !b) return 8;
+    faeb_process_set_priority(a, 4);
+    faeb_process_set_priority(b, 0);
+
+    faeb_scheduler_run();
+
+    int position = -1;
+    for (int i = 0; i < trace.count; i++) {
+        if (trace.entries[i] == 400) position = i;
+    }
+    if (trace.count != 101 || position < 0 || position == trace.count - 1) return 9;
+    faeb_process_destroy(a);
+    faeb_process_destroy(b);
+    return 0;
+}
+
+struct sleeper {
+    uint64_t milliseconds;
+    uint64_t woke_ns;
+    int* order;
+    int* slot;
+};
+
+static void sleeper_run(void* context) {
+    struct sleeper* sleeper = context;
+    faeb_process_sleep(sleeper->milliseconds);
+    sleeper->woke_ns = now_ns();
+    sleeper->order[(*sleeper->slot)++] = (int)sleeper->milliseconds;
+}
+
+static void sleeper_spin(void* context) {
+    int* spins = context;
+    for (int i = 0; i < 5; i++) {
+        (*spins)++;
+        faeb_process_yield();
+    }
+}
+
+// Sleeping processes wake in deadline order, never early, while other
+// processes keep running
+int test_process_sleep(void) {
+    int order[3];
+    int slot = 0;
+    int spins = 0;
+    struct sleeper sleepers[3] = {
+        { 30, 0, order, &slot }, { 10, 0, order, &slot }, { 20, 0, order, &slot }
+    };
+    faeb_process_t* processes[4];
+
+    for (int i = 0; i < 3; i++) {
+        processes[i] = faeb_process_create(sleeper_run, &sleepers[i]);
+        if (!processes[i]) return 1;
+    }
+    processes[3] = faeb_process_create(sleeper_spin, &spins);
+    if (!processes[3]) return 2;
+
+    uint64_t start = now_ns();
+    faeb_scheduler_run();
+
+    if (slot != 3 || order[0] != 10 || order[1] != 20 || order[2] != 30) return 3;
+    for (int i = 0; i < 3; i++) {
+        if (sleepers[i].woke_ns - start < sleepers[i].milliseconds * 1000000ULL) return 4;
+    }
+    if (spins != 5) return 5;
+    for (int i = 0; i < 4; i++) {
+        faeb_process_destroy(processes[i]);
+    }
+
+    // Outside of a scheduling loop the thread itself sleeps
+    start = now_ns();
+    if (faeb_process_sleep(5) != FAEB_SUCCESS) return 6;
+    if (now_ns() - start < 5000000ULL) return 7;
+    return 0;
+}
+
+static void spawn_count(void* context) {
+    atomic_fetch_add((_Atomic int*)context, 1);
+}
+
+// Spawns one detached child per request, yielding between requests as
+// a loop waiting on its next request would
+struct spawn_loop {
+    _Atomic int* done;
+    int children;
+};
+
+static void spawn_requests(void* context) {
+    struct spawn_loop* loop = context;
+    for (int i = 0; i < loop->children; i++) {
+        while (faeb_process_spawn(spawn_count, loop->done) != FAEB_SUCCESS) {
+            faeb_process_yield();
+        }
+        faeb_process_yield();
+    }
+}
+
+// Destroyed processes are recycled with their stacks; detached processes
+// recycle themselves when they finish
+int test_process_recycling(void) {
+    _Atomic int done = 0;
+
+    // The most recently destroyed process is the next one handed out
+    faeb_process_t* a = faeb_process_create(spawn_count, &done);
+    if (!a) return 1;
+    faeb_process_destroy(a);
+    faeb_process_t* b = faeb_process_create(spawn_count, &done);
+    if (b != a) return 2;
+    faeb_scheduler_run();
+    if (atomic_load(&done) != 1 || !faeb_process_is_terminated(b)) return 3;
+    faeb_process_destroy(b);
+
+    // Other stack sizes are never mixed in
+    faeb_process_config_t config = { .stack_size = 128 << 10 };
+    faeb_process_t* large = faeb_process_create_config(spawn_count, &done, &config);
+    if (!large || large == a) return 4;
+    faeb_process_destroy(large);
+
+    // Detached processes run and vanish; a recycled one starts afresh
+    if (faeb_process_spawn(NULL, NULL) != FAEB_ERROR_INVALID) return 5;
+    atomic_store(&done, 0);
+    for (int i = 0; i < 1000; i++) {
+        if (faeb_process_spawn(spawn_count, &done) != FAEB_SUCCESS) return 6;
+    }
+    faeb_scheduler_run();
+    if (atomic_load(&done) != 1000) return 7;
+
+    // Spawning from processes on the worker pool
+    atomic_store(&done, 0);
+    struct spawn_loop loop = { &done, 2000 };
+    if (faeb_scheduler_init_workers(4) != FAEB_SUCCESS) return 8;
+    for (int i = 0; i < 4; i++) {
+        faeb_process_t* spawner = faeb_process_create(spawn_requests, &loop);
+        if (!spawner || faeb_scheduler_submit(spawner) != FAEB_SUCCESS) return 9;
+        faeb_scheduler_wait();
+        faeb_process_destroy(spawner);
+    }
+    faeb_scheduler_shutdown_workers();
+    if (atomic_load(&done) != 8000) return 10;
+
+    // With recycling off every process is fresh
+    faeb_process_set_cache_limit(0);
+    faeb_process_trim_cache();
+    a = faeb_process_create(spawn_count, &done);
+    if (!a) return 11;
+    faeb_process_destroy(a);
+    b = faeb_process_create(spawn_count, &done);
+    if (!b) return 12;
+    faeb_process_destroy(b);
+    faeb_process_set_cache_limit(256);
+    return 0;
+}
+
+static void switch_spinner(void* context) {
+    int rounds = *(int*)context;
+    for (int i = 0; i < rounds; i++) {
+        faeb_process_yield();
+    }
+}
+
+// Context switch cost: two processes yielding to each other through the
+// scheduler, so every yield is a switch out and a switch back in
+int test_performance_process_switch(void) {
+    int rounds = 1000000;
+
+    faeb_process_t* a = faeb_process_create(switch_spinner, &rounds);
+    faeb_process_t* b = faeb_process_create(switch_spinner, &rounds);
+    if (!a || !b) return 1;
+
+    uint64_t start = now_ns();
+    faeb_scheduler_run();
+    uint64_t elapsed = now_ns() - start;
+
+    double per_switch = (double)elapsed / (4.0 * rounds);
+    printf("  %.1f ns/switch, %.1f ns/yield round trip\n",
+           per_switch, per_switch * 2.0);
+    faeb_process_destroy(a);
+    faeb_process_destroy(b);
+
+    // Creation cost with pooled stacks
+    faeb_process_t* processes[64];
+    start = now_ns();
+    for (int r = 0; r < 1000; r++) {
+        for (int i = 0; i < 64; i++) {
+            processes[i] = faeb_process_create(switch_spinner, &rounds);
+            if (!processes[i]) return 2;
+        }
+        for (int i = 0; i < 64; i++) {
+            faeb_process_destroy(processes[i]);
+        }
+    }
+    printf("  %.1f ns/create+destroy\n", (double)(now_ns() - start) / 64000.0);
+    return 0;
+}
+
+// Pick cost is independent of how many processes are queued
+int test_performance_process_priority(void) {
+    static faeb_process_t* idle[4096];
+    int rounds = 200000;
+    int idle_rounds = 1;
+
+    for (int queued = 16; queued <= 4096; queued *= 16) {
+        for (int i = 0; i < queued; i++) {
+            idle[i] = faeb_process_create(switch_spinner, &idle_rounds);
+            if (!idle[i]) return 1;
+            faeb_process_set_priority(idle[i], i % FAEB_PROCESS_PRIORITY_DEFAULT);
+        }
+        faeb_process_t* hot = faeb_process_create(switch_spinner, &rounds);
+        if (!hot) return 2;
+        faeb_process_set_priority(hot, FAEB_PROCESS_PRIORITIES - 1);
+
+        uint64_t start = now_ns();
+        faeb_scheduler_run();
+        double per_yield = (double)(now_ns() - start) / (rounds + 2.0 * queued);
+
+        printf("  %4d queued: %.1f ns/yield\n", queued, per_yield);
+        faeb_process_destroy(hot);
+        for (int i = 0; i < queued; i++) {
+            faeb_process_destroy(idle[i]);
+        }
+    }
+    return 0;
+}
+
+// Spawn-per-request throughput: detached processes created and recycled
+// in steady state, with and without the recycling caches
+int test_performance_process_spawn(void) {
+    enum { SPAWNS = 1000000, WAVE = 100 };
+    _Atomic int done = 0;
+    size_t limits[] = { 256, 0 };
+
+    for (int l = 0; l < 2; l++) {
+        faeb_process_set_cache_limit(limits[l]);
+        int spawns = limits[l] ? SPAWNS : SPAWNS / 10;
+        atomic_store(&done, 0);
+        uint64_t start = now_ns();
+        for (int i = 0; i < spawns; i += WAVE) {
+            for (int j = 0; j < WAVE; j++) {
+                if (faeb_process_spawn(spawn_count, &done) != FAEB_SUCCESS) return 1;
+            }
+            faeb_scheduler_run();
+        }
+        double seconds = (double)(now_ns() - start) / 1e9;
+        if (atomic_load(&done) != spawns) return 2;
+        printf("  cache %3zu, one thread: %.0f spawns/s (%.0f ns per spawn+run+exit)\n",
+               limits[l], spawns / seconds, seconds * 1e9 / spawns);
+    }
+    faeb_process_set_cache_limit(256);
+
+    // Spawners on every worker, each child recycled where it finished
+    if (faeb_scheduler_init_workers(0) != FAEB_SUCCESS) return 3;
+    int workers = faeb_scheduler_get_worker_count();
+    struct spawn_loop loop = { &done, SPAWNS / workers };
+    faeb_process_t* spawners[256];
+    atomic_store(&done, 0);
+    uint64_t start = now_ns();
+    for (int i = 0; i < workers; i++) {
+        spawners[i] = faeb_process_create(spawn_requests, &loop);
+        if (!spawners[i] || faeb_scheduler_submit(spawners[i]) != FAEB_SUCCESS) return 4;
+    }
+    faeb_scheduler_wait();
+    double seconds = (double)(now_ns() - start) / 1e9;
+    if (atomic_load(&done) != loop.children * workers) return 5;
+    printf("  cache 256, %d workers: %.0f spawns/s\n", workers, atomic_load(&done) / seconds);
+    for (int i = 0; i < workers; i++) {
+        faeb_process_destroy(spawners[i]);
+    }
+    faeb_scheduler_shutdown_workers();
+    return 0;
+}
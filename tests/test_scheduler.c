@@ -0,0 +1,928 @@
+/* FAEB Test Suite - Scheduler Tests
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "faeb/runtime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// Monotonic timestamp in nanoseconds
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// One unit of worker-pool work: sums its range across several yields
+struct worker_job {
+    uint64_t first;
+    uint64_t count;
+    uint64_t sum;
+    uint64_t submitted_ns;
+    uint64_t started_ns;
+    int yields;
+    _Atomic int* spawned;
+};
+
+static void worker_job_run(void* context) {
+    struct worker_job* job = context;
+    job->started_ns = now_ns();
+    uint64_t step = job->count / (uint64_t)(job->yields + 1) + 1;
+    for (uint64_t i = 0; i < job->count; i++) {
+        job->sum += job->first + i;
+        if (i % step == step - 1) {
+            faeb_process_yield();
+        }
+    }
+}
+
+// Spawns children from inside a worker; they are submitted automatically
+static void worker_job_spawn(void* context) {
+    struct worker_job* jobs = context;
+    for (int i = 1; i <= 8; i++) {
+        faeb_process_t* child = faeb_process_create(worker_job_run, &jobs[i]);
+        if (child) atomic_fetch_add(jobs[0].spawned, 1);
+        faeb_process_yield();
+    }
+}
+
+static void worker_job_nap(void* context) {
+    struct worker_job* job = context;
+    faeb_process_sleep(5);
+    job->sum = 1;
+}
+
+static void worker_job_doze(void* context) {
+    struct worker_job* job = context;
+    atomic_store(job->spawned, 1);
+    faeb_process_sleep(60000);
+}
+
+// Submitted processes all run to completion on the pool
+int test_scheduler_workers(void) {
+    enum { JOBS = 1000 };
+    static struct worker_job jobs[JOBS];
+    static faeb_process_t* processes[JOBS];
+    
+    if (faeb_scheduler_submit(NULL) != FAEB_ERROR_INVALID) return 1;
+    if (faeb_scheduler_init_workers(4) != FAEB_SUCCESS) return 2;
+    if (faeb_scheduler_get_worker_count() != 4) return 3;
+    
+    for (int i = 0; i < JOBS; i++) {
+        jobs[i] = (struct worker_job){ .first = (uint64_t)i, .count = 100, .yields = 4 };
+        processes[i] = faeb_process_create(worker_job_run, &jobs[i]);
+        if (!processes[i]) return 4;
+        if (faeb_scheduler_submit(processes[i]) != FAEB_SUCCESS) return 5;
+    }
+    // Submitted or finished processes cannot be submitted again
+    if (faeb_scheduler_submit(processes[0]) != FAEB_ERROR_INVALID) return 6;
+    if (faeb_scheduler_wait() != FAEB_SUCCESS) return 7;
+    
+    for (int i = 0; i < JOBS; i++) {
+        uint64_t expected = 100 * (uint64_t)i + 4950;
+        if (!faeb_process_is_terminated(processes[i])) return 8;
+        if (jobs[i].sum != expected) return 9;
+        faeb_process_destroy(processes[i]);
+    }
+    
+    // Processes created on a worker are queued on that worker
+    _Atomic int spawned = 0;
+    struct worker_job family[9];
+    for (int i = 0; i < 9; i++) {
+        family[i] = (struct worker_job){ .first = 1, .count = 10, .yields = 2,
+                                         .spawned = &spawned };
+    }
+    faeb_process_t* parent = faeb_process_create(worker_job_spawn, family);
+    if (!parent || faeb_scheduler_submit(parent) != FAEB_SUCCESS) return 10;
+    faeb_scheduler_wait();
+    if (atomic_load(&spawned) != 8) return 11;
+    for (int i = 1; i <= 8; i++) {
+        if (family[i].sum != 55) return 12;
+    }
+    faeb_process_destroy(parent);
+    
+    // Sleepers park on their worker's timer wheel
+    struct worker_job nap = { .count = 0 };
+    faeb_process_t* napper = faeb_process_create(worker_job_nap, &nap);
+    uint64_t start = now_ns();
+    if (!napper || faeb_scheduler_submit(napper) != FAEB_SUCCESS) return 13;
+    faeb_scheduler_wait();
+    if (now_ns() - start < 5000000ULL || nap.sum != 1) return 14;
+    faeb_process_destroy(napper);
+    
+    // A sleeper outlives the pool and its wheel; destroying it afterwards
+    // must not touch the freed wheel
+    _Atomic int dozing = 0;
+    struct worker_job doze = { .spawned = &dozing };
+    faeb_process_t* dozer = faeb_process_create(worker_job_doze, &doze);
+    if (!dozer || faeb_scheduler_submit(dozer) != FAEB_SUCCESS) return 16;
+    // The worker only sees the stop flag once the process has parked
+    while (!atomic_load(&dozing)) {}
+    
+    faeb_scheduler_shutdown_workers();
+    if (faeb_scheduler_get_worker_count() != 0) return 15;
+    faeb_process_destroy(dozer);
+    return 0;
+}
+
+static void scheduler_noop(void* context) {
+    (void)context;
+}
+
+// Slices are measured per process on the monotonic clock, and timed
+// blocks come back on their own unless unblocked first
+int test_scheduler_timeouts(void) {
+    if (faeb_scheduler_init(5) != FAEB_SUCCESS) return 1;
+    
+    faeb_process_t* a = faeb_process_create(scheduler_noop, NULL);
+    faeb_process_t* b = faeb_process_create(scheduler_noop, NULL);
+    if (!a || !b) return 2;
+    faeb_scheduler_add_process(a);
+    faeb_scheduler_add_process(b);
+    
+    if (faeb_scheduler_schedule_next() != a) return 3;
+    if (faeb_scheduler_time_slice_expired()) return 4;
+    uint64_t start = now_ns();
+    while (now_ns() - start < 6000000ULL) {
+        // Burn the slice
+    }
+    if (!faeb_scheduler_time_slice_expired()) return 5;
+    
+    // a blocks for 10ms; b runs meanwhile
+    start = now_ns();
+    if (faeb_scheduler_block_current_timeout(10) != FAEB_SUCCESS) return 6;
+    if (faeb_scheduler_schedule_next() != b) return 7;
+    if (faeb_scheduler_block_current_timeout(1000) != FAEB_SUCCESS) return 8;
+    while (faeb_scheduler_get_current() != a) {
+        faeb_scheduler_tick();
+        if (now_ns() - start > 1000000000ULL) return 9;
+    }
+    if (now_ns() - start < 10000000ULL) return 10;
+    
+    // Unblocking early cancels b's timeout
+    if (faeb_scheduler_unblock_process(b) != FAEB_SUCCESS) return 11;
+    if (faeb_scheduler_unblock_process(b) != FAEB_ERROR_INVALID) return 12;
+    if (faeb_scheduler_schedule_next() != b) return 13;
+    
+    faeb_scheduler_remove_process(a);
+    faeb_scheduler_remove_process(b);
+    faeb_process_destroy(a);
+    faeb_process_destroy(b);
+    return 0;
+}
+
+// Timed-block arm and cancel cost against the number of pending timers
+int test_performance_scheduler_timers(void) {
+    enum { MAX_PENDING = 16384 };
+    static faeb_process_t* processes[MAX_PENDING];
+    faeb_process_config_t config = { .stack_size = 4096 };
+    
+    faeb_scheduler_init(10);
+    for (int pending = 256; pending <= MAX_PENDING; pending *= 8) {
+        for (int i = 0; i < pending; i++) {
+            processes[i] = faeb_process_create_config(scheduler_noop, NULL, &config);
+            if (!processes[i]) return 1;
+            faeb_scheduler_add_process(processes[i]);
+        }
+        
+        uint64_t start = now_ns();
+        for (int i = 0; i < pending; i++) {
+            faeb_scheduler_schedule_next();
+            faeb_scheduler_block_current_timeout(1000 + (uint32_t)(i * 7919) % 600000);
+        }
+        double arm = (double)(now_ns() - start) / pending;
+        
+        // Ticking with nothing due stays cheap however many are pending
+        start = now_ns();
+        for (int i = 0; i < 1000; i++) {
+            faeb_scheduler_tick();
+        }
+        double tick = (double)(now_ns() - start) / 1000.0;
+        
+        // Newest blocked first, so cancel does not pay for a list walk
+        start = now_ns();
+        for (int i = pending - 1; i >= 0; i--) {
+            faeb_scheduler_unblock_process(processes[i]);
+        }
+        double cancel = (double)(now_ns() - start) / pending;
+        
+        printf("  %5d pending: block+arm %.1f ns, tick %.1f ns, unblock+cancel %.1f ns\n",
+               pending, arm, tick, cancel);
+        for (int i = 0; i < pending; i++) {
+            faeb_scheduler_remove_process(processes[i]);
+            faeb_process_destroy(processes[i]);
+        }
+        faeb_scheduler_schedule_next();
+    }
+    return 0;
+}
+
+// Throughput and start latency from 1 to N workers
+int test_performance_scheduler_workers(void) {
+    enum { JOBS = 20000 };
+    static struct worker_job jobs[JOBS];
+    static faeb_process_t* processes[JOBS];
+    static uint64_t latency[JOBS];
+    
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_workers = online > 1 ? (int)online : 2;
+    
+    for (int workers = 1; workers <= max_workers; workers *= 2) {
+        if (faeb_scheduler_init_workers(workers) != FAEB_SUCCESS) return 1;
+        
+        for (int i = 0; i < JOBS; i++) {
+            jobs[i] = (struct worker_job){ .first = (uint64_t)i, .count = 2000, .yields = 8 };
+            processes[i] = faeb_process_create(worker_job_run, &jobs[i]);
+            if (!processes[i]) return 2;
+        }
+        
+        uint64_t start = now_ns();
+        for (int i = 0; i < JOBS; i++) {
+            jobs[i].submitted_ns = now_ns();
+            if (faeb_scheduler_submit(processes[i]) != FAEB_SUCCESS) return 3;
+        }
+        faeb_scheduler_wait();
+        double seconds = (double)(now_ns() - start) / 1e9;
+        
+        for (int i = 0; i < JOBS; i++) {
+            latency[i] = jobs[i].started_ns - jobs[i].submitted_ns;
+            faeb_process_destroy(processes[i]);
+        }
+        qsort(latency, JOBS, sizeof(latency[0]), compare_u64);
+        
+        printf("  %2d workers: %.0f processes/s, %.0f yields/s, start delay "
+               "p50=%.1fus p99=%.1fus p99.9=%.1fus\n",
+               workers, JOBS / seconds, JOBS * 8.0 / seconds,
+               latency[JOBS / 2] / 1e3, latency[JOBS * 99 / 100] / 1e3,
+               latency[JOBS * 999 / 1000] / 1e3);
+        faeb_scheduler_shutdown_workers();
+    }
+    return 0;
+}
+
+static uint64_t histogram_total(const uint64_t* histogram) {
+    uint64_t total = 0;
+    for (int i = 0; i < FAEB_SCHEDULER_DELAY_BUCKETS; i++) {
+        total += histogram[i];
+    }
+    return total;
+}
+
+// Smallest delay bucket holding at least fraction of the samples
+static int histogram_percentile(const uint64_t* histogram, double fraction) {
+    uint64_t total = histogram_total(histogram);
+    uint64_t seen = 0;
+    for (int i = 0; i < FAEB_SCHEDULER_DELAY_BUCKETS; i++) {
+        seen += histogram[i];
+        if (seen > 0 && (double)seen >= fraction * (double)total) return i;
+    }
+    return FAEB_SCHEDULER_DELAY_BUCKETS - 1;
+}
+
+// Yields three times, waits on a semaphore, then finishes
+static void stats_worker(void* context) {
+    for (int i = 0; i < 3; i++) {
+        faeb_process_yield();
+    }
+    faeb_semaphore_wait(context);
+}
+
+// Keeps the CPU for 2ms in one run
+static void stats_busy(void* context) {
+    (void)context;
+    uint64_t start = now_ns();
+    while (now_ns() - start < 2000000ULL) {
+        // Burn
+    }
+}
+
+// Counters follow every switch, per process and in total, and reading
+// them does not depend on how many processes exist
+int test_scheduler_stats(void) {
+    faeb_scheduler_stats_t before, after;
+    faeb_process_stats_t stats;
+    if (faeb_scheduler_get_stats(NULL) != FAEB_ERROR_INVALID) return 1;
+    if (faeb_process_get_stats(NULL, &stats) != FAEB_ERROR_INVALID) return 2;
+    
+    faeb_semaphore_t* semaphore = faeb_semaphore_create(0);
+    if (!semaphore) return 3;
+    faeb_process_t* worker = faeb_process_create(stats_worker, semaphore);
+    if (!worker) return 4;
+    if (faeb_scheduler_get_stats(&before) != FAEB_SUCCESS) return 5;
+    faeb_scheduler_run();
+    faeb_semaphore_post(semaphore);
+    faeb_scheduler_run();
+    faeb_scheduler_get_stats(&after);
+    
+    // Five runs: three ended in a yield, one in a block, one in the finish
+    if (faeb_process_get_stats(worker, &stats) != FAEB_SUCCESS) return 6;
+    if (stats.runs != 5 || stats.switches != 4 || stats.blocks != 1) return 7;
+    if (histogram_total(stats.delay_histogram) != 5) return 8;
+    if (after.runs - before.runs != 5 || after.switches - before.switches != 4 ||
+        after.blocks - before.blocks != 1) return 9;
+    if (histogram_total(after.delay_histogram) -
+        histogram_total(before.delay_histogram) != 5) return 10;
+    if (after.cpu_time_ns - before.cpu_time_ns < stats.cpu_time_ns) return 11;
+    faeb_process_destroy(worker);
+    
+    // A process queued behind a 2ms run waits at least that long
+    faeb_process_t* busy = faeb_process_create(stats_busy, NULL);
+    faeb_process_t* waiting = faeb_process_create(scheduler_noop, NULL);
+    if (!busy || !waiting) return 12;
+    faeb_scheduler_run();
+    faeb_process_get_stats(busy, &stats);
+    if (stats.cpu_time_ns < 2000000ULL || stats.runs != 1 || stats.switches != 0) return 13;
+    faeb_process_get_stats(waiting, &stats);
+    if (histogram_percentile(stats.delay_histogram, 1.0) < 20) return 14;  // 2^20ns ~ 1ms
+    faeb_process_destroy(busy);
+    faeb_process_destroy(waiting);
+    
+    // Tick scheduler queues are counted as processes move between them
+    faeb_scheduler_init(10);
+    faeb_process_t* a = faeb_process_create(scheduler_noop, NULL);
+    faeb_process_t* b = faeb_process_create(scheduler_noop, NULL);
+    if (!a || !b) return 15;
+    faeb_scheduler_add_process(a);
+    faeb_scheduler_add_process(b);
+    faeb_scheduler_get_stats(&after);
+    if (after.ready_count != 2 || after.blocked_count != 0 || after.total_processes != 2) return 16;
+    if (faeb_scheduler_schedule_next() != a) return 17;
+    faeb_scheduler_block_current();
+    faeb_scheduler_get_stats(&after);
+    if (after.ready_count != 1 || after.blocked_count != 1 || after.total_processes != 2) return 18;
+    faeb_process_get_stats(a, &stats);
+    if (stats.runs != 1 || stats.blocks != 1) return 19;
+    faeb_scheduler_unblock_process(a);
+    faeb_scheduler_remove_process(a);
+    faeb_scheduler_remove_process(b);
+    faeb_process_destroy(a);
+    faeb_process_destroy(b);
+    
+    // Worker threads add to the same totals
+    enum { JOBS = 100 };
+    static struct worker_job jobs[JOBS];
+    static faeb_process_t* processes[JOBS];
+    if (faeb_scheduler_init_workers(2) != FAEB_SUCCESS) return 20;
+    faeb_scheduler_get_stats(&before);
+    for (int i = 0; i < JOBS; i++) {
+        jobs[i] = (struct worker_job){ .count = 100, .yields = 4 };
+        processes[i] = faeb_process_create(worker_job_run, &jobs[i]);
+        if (!processes[i] || faeb_scheduler_submit(processes[i]) != FAEB_SUCCESS) return 21;
+    }
+    faeb_scheduler_wait();
+    faeb_scheduler_get_stats(&after);
+    if (after.submitted != 0 || after.runs - before.runs != JOBS * 5) return 22;
+    for (int i = 0; i < JOBS; i++) {
+        faeb_process_get_stats(processes[i], &stats);
+        if (stats.runs != 5 || stats.switches != 4) return 23;
+        faeb_process_destroy(processes[i]);
+    }
+    faeb_scheduler_shutdown_workers();
+    
+    faeb_semaphore_destroy(semaphore);
+    return 0;
+}
+
+static void stats_yield(void* context) {
+    int rounds = *(int*)context;
+    for (int i = 0; i < rounds; i++) {
+        faeb_process_yield();
+    }
+}
+
+// Cost of a stats snapshot against the number of live processes, and
+// the queueing delay a ring of yielding processes sees
+int test_performance_scheduler_stats(void) {
+    enum { MAX_PROCESSES = 16384 };
+    static faeb_process_t* processes[MAX_PROCESSES];
+    faeb_process_config_t config = { .stack_size = 16 << 10 };
+    faeb_process_stats_t stats;
+    faeb_scheduler_stats_t snapshot;
+    int rounds = 20;
+    
+    faeb_scheduler_init(10);
+    for (int count = 16; count <= MAX_PROCESSES; count *= 32) {
+        for (int i = 0; i < count; i++) {
+            processes[i] = faeb_process_create_config(stats_yield, &rounds, &config);
+            if (!processes[i]) return 1;
+        }
+        
+        uint64_t start = now_ns();
+        for (int i = 0; i < 10000; i++) {
+            faeb_scheduler_get_stats(&snapshot);
+        }
+        double read = (double)(now_ns() - start) / 10000.0;
+        
+        start = now_ns();
+        faeb_scheduler_run();
+        double switch_ns = (double)(now_ns() - start) / ((double)count * (rounds + 1));
+        
+        faeb_process_get_stats(processes[count - 1], &stats);
+        printf("  %5d processes: stats read %.1f ns, %.1f ns/switch, "
+               "delay p50 < %.1fus p90 < %.1fus\n",
+               count, read, switch_ns,
+               (double)(2ULL << histogram_percentile(stats.delay_histogram, 0.5)) / 1e3,
+               (double)(2ULL << histogram_percentile(stats.delay_histogram, 0.9)) / 1e3);
+        for (int i = 0; i < count; i++) {
+            faeb_process_destroy(processes[i]);
+        }
+    }
+    return 0;
+}
+
+// Appends its tag to a shared trace, yielding in between
+struct instance_job {
+    int tag;
+    int rounds;
+    int* trace;
+    int* count;
+    faeb_event_t* event;
+};
+
+static void instance_run(void* context) {
+    struct instance_job* job = context;
+    for (int i = 0; i < job->rounds; i++) {
+        job->trace[(*job->count)++] = job->tag;
+        faeb_process_yield();
+    }
+    if (job->event) {
+        faeb_event_wait(job->event);
+        job->trace[(*job->count)++] = job->tag + 1;
+    }
+}
+
+static void* instance_set_event(void* arg) {
+    faeb_event_set(arg);
+    return NULL;
+}
+
+// One shard: a private scheduler on its own thread running a ring of
+// yielding processes
+struct instance_shard {
+    int processes;
+    int rounds;
+    int failed;
+};
+
+static void shard_yield(void* context) {
+    struct instance_shard* shard = context;
+    for (int i = 0; i < shard->rounds; i++) {
+        faeb_process_yield();
+    }
+}
+
+static void* instance_shard_main(void* arg) {
+    struct instance_shard* shard = arg;
+    faeb_scheduler_t* scheduler = faeb_scheduler_create(10);
+    if (!scheduler) {
+        shard->failed = 1;
+        return NULL;
+    }
+    faeb_scheduler_set_current(scheduler);
+    
+    faeb_process_t** processes = calloc((size_t)shard->processes, sizeof(*processes));
+    faeb_process_config_t config = { .stack_size = 16 << 10 };
+    for (int i = 0; i < shard->processes; i++) {
+        processes[i] = faeb_process_create_config(shard_yield, shard, &config);
+        if (!processes[i]) shard->failed = 1;
+    }
+    faeb_scheduler_run();
+    for (int i = 0; i < shard->processes; i++) {
+        if (!faeb_process_is_terminated(processes[i])) shard->failed = 1;
+        faeb_process_destroy(processes[i]);
+    }
+    free(processes);
+    
+    faeb_scheduler_set_current(NULL);
+    faeb_scheduler_destroy(scheduler);
+    return NULL;
+}
+
+// Instances keep their own queues and tick state, wakes from other
+// threads reach the scheduler a process belongs to, and threads running
+// private instances do not see each other's processes
+int test_scheduler_instances(void) {
+    int trace[64];
+    int count = 0;
+    faeb_scheduler_t* first = faeb_scheduler_create(5);
+    faeb_scheduler_t* second = faeb_scheduler_create(5);
+    if (!first || !second) return 1;
+    if (faeb_scheduler_current() != faeb_scheduler_get_default()) return 2;
+    faeb_scheduler_stats_t base, stats;
+    faeb_scheduler_get_stats(&base);
+    
+    // Each process runs only when its own scheduler does
+    struct instance_job a = { .tag = 10, .rounds = 3, .trace = trace, .count = &count };
+    struct instance_job b = { .tag = 20, .rounds = 3, .trace = trace, .count = &count };
+    if (faeb_scheduler_set_current(first) != faeb_scheduler_get_default()) return 3;
+    faeb_process_t* pa = faeb_process_create(instance_run, &a);
+    faeb_scheduler_set_current(second);
+    faeb_process_t* pb = faeb_process_create(instance_run, &b);
+    if (!pa || !pb) return 4;
+    faeb_scheduler_run();
+    if (count != 3 || trace[0] != 20 || trace[2] != 20 || faeb_process_is_terminated(pa)) return 5;
+    if (faeb_scheduler_set_current(first) != second) return 6;
+    faeb_scheduler_run();
+    if (count != 6 || trace[3] != 10 || !faeb_process_is_terminated(pa)) return 7;
+    faeb_process_destroy(pa);
+    faeb_process_destroy(pb);
+    
+    // Each instance counts only its own processes: three yields and a finish
+    faeb_scheduler_get_stats(&stats);
+    if (stats.runs != 4 || stats.switches != 3) return 22;
+    faeb_scheduler_set_current(second);
+    faeb_scheduler_get_stats(&stats);
+    if (stats.runs != 4 || stats.switches != 3) return 23;
+    faeb_scheduler_set_current(NULL);
+    faeb_scheduler_get_stats(&stats);
+    if (stats.runs != base.runs || stats.switches != base.switches) return 24;
+    faeb_scheduler_set_current(first);
+    
+    // The tick API works on the current instance only
+    faeb_process_t* t = faeb_process_create(scheduler_noop, NULL);
+    if (!t) return 8;
+    if (faeb_scheduler_schedule_next() != t) return 9;
+    faeb_scheduler_set_current(second);
+    if (faeb_scheduler_get_current() != NULL || faeb_scheduler_schedule_next() != NULL) return 10;
+    faeb_scheduler_set_current(first);
+    if (faeb_scheduler_get_current() != t) return 11;
+    faeb_process_destroy(t);
+    if (faeb_scheduler_get_current() != NULL) return 12;
+    
+    // A plain thread wakes a parked process into its scheduler's inbox
+    faeb_event_t* event = faeb_event_create(false);
+    if (!event) return 13;
+    count = 0;
+    a = (struct instance_job){ .tag = 30, .rounds = 1, .trace = trace, .count = &count,
+                               .event = event };
+    pa = faeb_process_create(instance_run, &a);
+    if (!pa) return 14;
+    faeb_scheduler_run();
+    if (count != 1 || faeb_process_is_terminated(pa)) return 15;
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, instance_set_event, event) != 0) return 16;
+    pthread_join(thread, NULL);
+    faeb_scheduler_set_current(second);
+    faeb_scheduler_run();
+    if (count != 1) return 17;
+    faeb_scheduler_set_current(first);
+    faeb_scheduler_run();
+    if (count != 2 || trace[1] != 31 || !faeb_process_is_terminated(pa)) return 18;
+    faeb_process_destroy(pa);
+    faeb_event_destroy(event);
+    
+    // Shards on their own threads
+    enum { SHARDS = 4 };
+    struct instance_shard shards[SHARDS];
+    pthread_t threads[SHARDS];
+    for (int i = 0; i < SHARDS; i++) {
+        shards[i] = (struct instance_shard){ .processes = 64 + i, .rounds = 100 };
+        if (pthread_create(&threads[i], NULL, instance_shard_main, &shards[i]) != 0) return 19;
+    }
+    for (int i = 0; i < SHARDS; i++) {
+        pthread_join(threads[i], NULL);
+        if (shards[i].failed) return 20;
+    }
+    
+    // Destroying the current instance falls back to the default
+    faeb_scheduler_destroy(first);
+    if (faeb_scheduler_current() != faeb_scheduler_get_default()) return 21;
+    faeb_scheduler_destroy(second);
+    faeb_scheduler_destroy(faeb_scheduler_get_default());
+    return 0;
+}
+
+// Aggregate switch rate of 1 to N threads each running a private
+// scheduler instance
+int test_performance_scheduler_shards(void) {
+    enum { MAX_SHARDS = 16 };
+    struct instance_shard shards[MAX_SHARDS];
+    pthread_t threads[MAX_SHARDS];
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_shards = online > 1 ? (int)(online < MAX_SHARDS ? online : MAX_SHARDS) : 2;
+    
+    for (int count = 1; count <= max_shards; count *= 2) {
+        uint64_t start = now_ns();
+        for (int i = 0; i < count; i++) {
+            shards[i] = (struct instance_shard){ .processes = 256, .rounds = 2000 };
+            if (pthread_create(&threads[i], NULL, instance_shard_main, &shards[i]) != 0) return 1;
+        }
+        for (int i = 0; i < count; i++) {
+            pthread_join(threads[i], NULL);
+            if (shards[i].failed) return 2;
+        }
+        double seconds = (double)(now_ns() - start) / 1e9;
+        double switches = (double)count * 256.0 * 2001.0;
+        printf("  %2d shards: %.1fM switches/s\n", count, switches / seconds / 1e6);
+    }
+    return 0;
+}
+
+// Records its tag once per job; periodic jobs wait for their release
+struct deadline_job {
+    int tag;
+    int jobs;
+    uint64_t busy_ns;
+    int* trace;
+    int* count;
+    uint64_t period_ns;
+    uint64_t* lateness;
+    volatile int* done;
+};
+
+static void deadline_run(void* context) {
+    struct deadline_job* job = context;
+    for (int i = 0; i < job->jobs; i++) {
+        if (job->trace) {
+            job->trace[(*job->count)++] = job->tag;
+        }
+        uint64_t start = now_ns();
+        while (now_ns() - start < job->busy_ns) {
+            // Burn
+        }
+        if (job->period_ns) {
+            faeb_process_wait_period();
+        } else {
+            faeb_process_yield();
+        }
+    }
+}
+
+// Admission, earliest-deadline ordering ahead of priorities, periodic
+// releases and miss counting
+int test_scheduler_deadlines(void) {
+    int trace[64];
+    int count = 0;
+    faeb_process_stats_t stats;
+    faeb_scheduler_stats_t scheduler_stats;
+    faeb_scheduler_t* scheduler = faeb_scheduler_create(10);
+    if (!scheduler) return 1;
+    faeb_scheduler_set_current(scheduler);
+    
+    // Parameters must satisfy runtime <= deadline <= period
+    struct deadline_job idle = { .jobs = 1 };
+    faeb_process_t* p = faeb_process_create(deadline_run, &idle);
+    if (!p) return 2;
+    faeb_process_deadline_t bad[] = {
+        { .runtime_ns = 0, .period_ns = 1000000 },
+        { .runtime_ns = 2000000, .deadline_ns = 1000000, .period_ns = 4000000 },
+        { .runtime_ns = 1000, .deadline_ns = 5000000, .period_ns = 4000000 },
+    };
+    for (int i = 0; i < 3; i++) {
+        if (faeb_process_set_deadline(p, &bad[i]) != FAEB_ERROR_INVALID) return 3;
+    }
+    if (faeb_process_set_deadline(NULL, &bad[0]) != FAEB_ERROR_INVALID) return 4;
+    if (faeb_process_wait_period() != FAEB_ERROR_INVALID) return 5;
+    
+    // Density 0.4 each: two fit under the bound, a third does not until
+    // one withdraws
+    faeb_process_t* q = faeb_process_create(deadline_run, &idle);
+    faeb_process_t* r = faeb_process_create(deadline_run, &idle);
+    if (!q || !r) return 6;
+    faeb_process_deadline_t heavy = { .runtime_ns = 4000000, .period_ns = 10000000 };
+    if (faeb_process_set_deadline(p, &heavy) != FAEB_SUCCESS) return 7;
+    if (faeb_process_set_deadline(q, &heavy) != FAEB_SUCCESS) return 8;
+    if (faeb_process_set_deadline(r, &heavy) != FAEB_ERROR_LIMIT) return 9;
+    faeb_scheduler_get_stats(&scheduler_stats);
+    if (scheduler_stats.deadline_processes != 2 ||
+        scheduler_stats.deadline_density < 0.79 || scheduler_stats.deadline_density > 0.81) return 10;
+    if (faeb_process_set_deadline(q, NULL) != FAEB_SUCCESS) return 11;
+    if (faeb_process_set_deadline(r, &heavy) != FAEB_SUCCESS) return 12;
+    faeb_process_destroy(r);
+    faeb_scheduler_get_stats(&scheduler_stats);
+    if (scheduler_stats.deadline_processes != 1) return 13;
+    faeb_scheduler_run();
+    faeb_process_destroy(p);
+    faeb_process_destroy(q);
+    
+    // Earliest deadline first, all ahead of the highest priority
+    struct deadline_job jobs[4];
+    faeb_process_t* processes[4];
+    const uint64_t deadlines[] = { 30000000, 10000000, 20000000 };
+    for (int i = 0; i < 4; i++) {
+        jobs[i] = (struct deadline_job){ .tag = i, .jobs = 1, .trace = trace, .count = &count };
+        processes[i] = faeb_process_create(deadline_run, &jobs[i]);
+        if (!processes[i]) return 14;
+    }
+    faeb_process_set_priority(processes[3], FAEB_PROCESS_PRIORITIES - 1);
+    for (int i = 0; i < 3; i++) {
+        faeb_process_deadline_t deadline = { .runtime_ns = 100000, .period_ns = deadlines[i] };
+        if (faeb_process_set_deadline(processes[i], &deadline) != FAEB_SUCCESS) return 15;
+    }
+    faeb_scheduler_run();
+    if (count != 4 || trace[0] != 1 || trace[1] != 2 || trace[2] != 0 || trace[3] != 3) return 16;
+    for (int i = 0; i < 4; i++) {
+        faeb_process_destroy(processes[i]);
+    }
+    
+    // Periodic jobs of 5ms: four releases after the first take 15ms+.
+    // Jobs that run 3ms against a 2ms deadline are all misses.
+    struct deadline_job periodic = { .jobs = 4, .period_ns = 5000000 };
+    struct deadline_job late = { .jobs = 2, .period_ns = 20000000, .busy_ns = 3000000 };
+    p = faeb_process_create(deadline_run, &periodic);
+    q = faeb_process_create(deadline_run, &late);
+    if (!p || !q) return 17;
+    faeb_process_deadline_t steady = { .runtime_ns = 500000, .period_ns = 5000000 };
+    faeb_process_deadline_t tight = { .runtime_ns = 1000000, .deadline_ns = 2000000,
+                                      .period_ns = 20000000 };
+    if (faeb_process_set_deadline(p, &steady) != FAEB_SUCCESS) return 18;
+    if (faeb_process_set_deadline(q, &tight) != FAEB_SUCCESS) return 19;
+    uint64_t start = now_ns();
+    faeb_scheduler_run();
+    if (now_ns() - start < 15000000ULL) return 20;
+    faeb_process_get_stats(p, &stats);
+    if (stats.periods != 4) return 21;
+    faeb_process_get_stats(q, &stats);
+    if (stats.periods != 2 || stats.deadline_misses != 2) return 22;
+    faeb_scheduler_get_stats(&scheduler_stats);
+    if (scheduler_stats.deadline_misses < 2) return 23;
+    faeb_process_destroy(p);
+    faeb_process_destroy(q);
+    
+    // Deadline processes stay off the worker pool
+    p = faeb_process_create(deadline_run, &idle);
+    if (!p || faeb_process_set_deadline(p, &steady) != FAEB_SUCCESS) return 24;
+    if (faeb_scheduler_init_workers(1) != FAEB_SUCCESS) return 25;
+    if (faeb_scheduler_submit(p) != FAEB_ERROR_INVALID) return 26;
+    faeb_scheduler_shutdown_workers();
+    faeb_process_destroy(p);
+    
+    faeb_scheduler_set_current(NULL);
+    faeb_scheduler_destroy(scheduler);
+    return 0;
+}
+
+// Background load: yields after every 20us of work until told to stop
+static void deadline_background(void* context) {
+    volatile int* stop = context;
+    while (!*stop) {
+        uint64_t start = now_ns();
+        while (now_ns() - start < 20000ULL) {
+            // Burn
+        }
+        faeb_process_yield();
+    }
+}
+
+// Control loop: measures how late each job starts after its release.
+// Without deadline parameters it sleeps until the next release instead.
+static void deadline_control(void* context) {
+    struct deadline_job* job = context;
+    uint64_t release = now_ns();
+    for (int i = 0; i < job->jobs; i++) {
+        uint64_t start = now_ns();
+        job->lateness[i] = start > release ? start - release : 0;
+        while (now_ns() - start < job->busy_ns) {
+            // Burn
+        }
+        release += job->period_ns;
+        if (faeb_process_wait_period() != FAEB_SUCCESS) {
+            uint64_t now = now_ns();
+            if (release > now) {
+                faeb_process_sleep((release - now + 999999) / 1000000);
+            }
+        }
+    }
+    *job->done = 1;
+}
+
+// Release-to-start lateness of a 4ms control loop sharing the thread
+// with busy background processes, scheduled by priority and by deadline
+int test_performance_scheduler_deadlines(void) {
+    enum { JOBS = 500, BACKGROUND = 64 };
+    static uint64_t lateness[JOBS];
+    static faeb_process_t* background[BACKGROUND];
+    
+    for (int mode = 0; mode < 2; mode++) {
+        volatile int done = 0;
+        for (int i = 0; i < BACKGROUND; i++) {
+            background[i] = faeb_process_create(deadline_background, (void*)&done);
+            if (!background[i]) return 1;
+        }
+        
+        struct deadline_job job = { .jobs = JOBS, .period_ns = 4000000, .busy_ns = 100000,
+                                    .lateness = lateness, .done = &done };
+        faeb_process_t* control = faeb_process_create(deadline_control, &job);
+        if (!control) return 2;
+        faeb_process_set_priority(control, FAEB_PROCESS_PRIORITIES - 1);
+        faeb_process_deadline_t deadline = { .runtime_ns = 200000, .deadline_ns = 2000000,
+                                             .period_ns = 4000000 };
+        if (mode == 1 && faeb_process_set_deadline(control, &deadline) != FAEB_SUCCESS) return 3;
+        faeb_scheduler_run();
+        
+        faeb_process_stats_t stats;
+        faeb_process_get_stats(control, &stats);
+        qsort(lateness, JOBS, sizeof(lateness[0]), compare_u64);
+        printf("  %-8s: lateness p50=%.0fus p99=%.0fus p99.9=%.0fus, %llu/%llu deadline misses\n",
+               mode ? "deadline" : "priority", lateness[JOBS / 2] / 1e3,
+               lateness[JOBS * 99 / 100] / 1e3, lateness[JOBS * 999 / 1000] / 1e3,
+               (unsigned long long)stats.deadline_misses, (unsigned long long)stats.periods);
+        faeb_process_destroy(control);
+        for (int i = 0; i < BACKGROUND; i++) {
+            faeb_process_destroy(background[i]);
+        }
+    }
+    return 0;
+}
+
+struct placement_probe {
+    int node;
+    int memory_node;
+};
+
+// Runs on a pinned worker: report its node and map a pool there
+static void placement_probe(void* context) {
+    struct placement_probe* probe = context;
+    probe->node = faeb_topology_current_node();
+    
+    faeb_memory_config_t config = { .kind = FAEB_MEMORY_ARENA, .flags = FAEB_MEMORY_MMAP };
+    faeb_memory_t* memory = faeb_memory_create_config(1 << 20, &config);
+    faeb_memory_stats_t stats;
+    probe->memory_node = -2;
+    if (memory && faeb_memory_get_stats(memory, &stats) == FAEB_SUCCESS) {
+        probe->memory_node = stats.numa_node;
+    }
+    faeb_memory_destroy(memory);
+}
+
+// The topology agrees with the CPUs online, workers land on the CPUs
+// they were placed on, and pools mapped there are bound to their node
+int test_scheduler_placement(void) {
+    enum { MAX_CPUS = 1024 };
+    static faeb_cpu_info_t cpus[MAX_CPUS];
+    faeb_topology_t topology;
+    if (faeb_topology_get(&topology) != FAEB_SUCCESS) return 1;
+    if (topology.cpus != (int)sysconf(_SC_NPROCESSORS_ONLN)) return 2;
+    if (topology.cores < 1 || topology.cores > topology.cpus) return 3;
+    if (topology.packages < 1 || topology.nodes < 1 || topology.caches < 1) return 4;
+    
+    size_t count = faeb_topology_get_cpus(cpus, MAX_CPUS);
+    if (count != (size_t)topology.cpus) return 5;
+    for (size_t i = 0; i < count && i < MAX_CPUS; i++) {
+        if (i > 0 && cpus[i].cpu <= cpus[i - 1].cpu) return 6;
+        if (cpus[i].core >= topology.cores || cpus[i].cache >= topology.caches) return 7;
+        if (cpus[i].node < 0 || cpus[i].thread < 0) return 8;
+    }
+    
+    // Placement names online CPUs only, and needs a mode to use them
+    int bogus = 1 << 20;
+    faeb_worker_config_t config = { .placement = FAEB_PLACEMENT_PINNED,
+                                    .cpus = &bogus, .cpu_count = 1 };
+    if (faeb_scheduler_init_workers_config(&config) != FAEB_ERROR_INVALID) return 9;
+    config.cpu_count = 0;
+    if (faeb_scheduler_init_workers_config(&config) != FAEB_ERROR_INVALID) return 10;
+    config = (faeb_worker_config_t){ .cpus = &cpus[0].cpu, .cpu_count = 1 };
+    if (faeb_scheduler_init_workers_config(&config) != FAEB_ERROR_INVALID) return 11;
+    if (faeb_topology_pin_thread(&bogus, 1) != FAEB_ERROR_INVALID) return 12;
+    if (faeb_scheduler_get_worker_count() != 0) return 13;
+    
+    // Pin this thread to the first CPU it may use, then two workers there
+    const faeb_cpu_info_t* target = NULL;
+    for (size_t i = 0; i < count && i < MAX_CPUS && !target; i++) {
+        if (faeb_topology_pin_thread(&cpus[i].cpu, 1) == FAEB_SUCCESS) {
+            target = &cpus[i];
+        }
+    }
+    if (!target) return 14;
+    if (faeb_topology_current_node() != target->node) return 15;
+    
+    config = (faeb_worker_config_t){ .workers = 2, .placement = FAEB_PLACEMENT_PINNED,
+                                     .cpus = &target->cpu, .cpu_count = 1 };
+    if (faeb_scheduler_init_workers_config(&config) != FAEB_SUCCESS) return 16;
+    if (faeb_scheduler_get_worker_count() != 2) return 17;
+    if (faeb_scheduler_get_worker_cpu(0) != target->cpu ||
+        faeb_scheduler_get_worker_cpu(1) != target->cpu ||
+        faeb_scheduler_get_worker_cpu(2) != -1) return 18;
+    
+    struct placement_probe probe = { .node = -2 };
+    faeb_process_t* process = faeb_process_create(placement_probe, &probe);
+    if (!process || faeb_scheduler_submit(process) != FAEB_SUCCESS) return 19;
+    faeb_scheduler_wait();
+    if (probe.node != target->node || probe.memory_node != target->node) return 20;
+    faeb_process_destroy(process);
+    faeb_scheduler_shutdown_workers();
+    
+    // The default set holds every CPU that is not isolated, one worker each
+    if (faeb_topology_pin_thread(NULL, 0) != FAEB_SUCCESS) return 21;
+    config = (faeb_worker_config_t){ .placement = FAEB_PLACEMENT_SHARED };
+    if (faeb_scheduler_init_workers_config(&config) != FAEB_SUCCESS) return 22;
+    if (faeb_scheduler_get_worker_count() != topology.cpus - topology.isolated) return 23;
+    if (faeb_scheduler_get_worker_cpu(0) != -1) return 24;
+    faeb_scheduler_shutdown_workers();
+    
+    return 0;
+}
@@ -0,0 +1,304 @@
+/* FAEB Test Suite - Synchronization Tests
+ * RISC-V Paradigm: Simple, orthogonal, verifiable
+ * License: Apache 2.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "faeb/runtime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Monotonic timestamp in nanoseconds
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Shared state for the processes of one test
+struct sync_shared {
+    faeb_semaphore_t* ping;
+    faeb_semaphore_t* pong;
+    faeb_mutex_t* mutex;
+    faeb_cond_t* cond;
+    faeb_event_t* event;
+    int trace[64];
+    int count;
+    int inside;
+    int overlaps;
+    int value;
+    int rounds;
+};
+
+// Trace entries past the end are counted but not kept
+static void sync_record(struct sync_shared* shared, int entry) {
+    if (shared->count < 64) shared->trace[shared->count] = entry;
+    shared->count++;
+}
+
+static void sync_ping(void* context) {
+    struct sync_shared* shared = context;
+    for (int i = 0; i < shared->rounds; i++) {
+        sync_record(shared, 100 + i);
+        faeb_semaphore_post(shared->pong);
+        faeb_semaphore_wait(shared->ping);
+    }
+}
+
+static void sync_pong(void* context) {
+    struct sync_shared* shared = context;
+    for (int i = 0; i < shared->rounds; i++) {
+        faeb_semaphore_wait(shared->pong);
+        sync_record(shared, 200 + i);
+        faeb_semaphore_post(shared->ping);
+    }
+}
+
+// Yields while holding the mutex; nobody else may get in meanwhile
+static void sync_critical(void* context) {
+    struct sync_shared* shared = context;
+    for (int i = 0; i < shared->rounds; i++) {
+        faeb_mutex_lock(shared->mutex);
+        if (shared->inside++) shared->overlaps++;
+        int value = shared->value;
+        faeb_process_yield();
+        shared->value = value + 1;
+        shared->inside--;
+        faeb_mutex_unlock(shared->mutex);
+        faeb_process_yield();
+    }
+}
+
+// Consumes shared->rounds items announced through the condition variable
+static void sync_consumer(void* context) {
+    struct sync_shared* shared = context;
+    faeb_mutex_lock(shared->mutex);
+    for (int i = 0; i < shared->rounds; i++) {
+        while (shared->value == 0) {
+            faeb_cond_wait(shared->cond, shared->mutex);
+        }
+        shared->value--;
+        sync_record(shared, i);
+    }
+    faeb_mutex_unlock(shared->mutex);
+}
+
+static void sync_producer(void* context) {
+    struct sync_shared* shared = context;
+    for (int i = 0; i < shared->rounds; i++) {
+        faeb_mutex_lock(shared->mutex);
+        shared->value++;
+        faeb_cond_signal(shared->cond);
+        faeb_mutex_unlock(shared->mutex);
+        faeb_process_yield();
+    }
+}
+
+static void sync_event_waiter(void* context) {
+    struct sync_shared* shared = context;
+    faeb_event_wait(shared->event);
+    shared->value++;
+}
+
+// Semaphores, mutexes, condition variables and events between processes
+// of the cooperative scheduler
+int test_sync_primitives(void) {
+    struct sync_shared shared = { .rounds = 3 };
+    shared.ping = faeb_semaphore_create(0);
+    shared.pong = faeb_semaphore_create(0);
+    if (!shared.ping || !shared.pong) return 1;
+
+    // Ping-pong strictly alternates
+    faeb_process_t* a = faeb_process_create(sync_ping, &shared);
+    faeb_process_t* b = faeb_process_create(sync_pong, &shared);
+    if (!a || !b) return 2;
+    faeb_scheduler_run();
+    const int alternating[] = { 100, 200, 101, 201, 102, 202 };
+    if (shared.count != 6 || memcmp(shared.trace, alternating, sizeof(alternating)) != 0) return 3;
+    if (!faeb_process_is_terminated(a) || !faeb_process_is_terminated(b)) return 4;
+    faeb_process_destroy(a);
+    faeb_process_destroy(b);
+
+    // Waiting outside of a process only succeeds without blocking
+    if (faeb_semaphore_wait(shared.ping) != FAEB_ERROR_INVALID) return 5;
+    faeb_semaphore_post(shared.ping);
+    if (!faeb_semaphore_try_wait(shared.ping) || faeb_semaphore_try_wait(shared.ping)) return 6;
+
+    // Mutual exclusion across yields inside the critical section
+    shared.mutex = faeb_mutex_create();
+    if (!shared.mutex) return 7;
+    shared.rounds = 10;
+    faeb_process_t* workers[4];
+    for (int i = 0; i < 4; i++) {
+        workers[i] = faeb_process_create(sync_critical, &shared);
+        if (!workers[i]) return 8;
+    }
+    faeb_scheduler_run();
+    if (shared.value != 40 || shared.overlaps != 0) return 9;
+    for (int i = 0; i < 4; i++) {
+        faeb_process_destroy(workers[i]);
+    }
+    if (faeb_mutex_unlock(shared.mutex) != FAEB_ERROR_INVALID) return 10;
+    if (!faeb_mutex_try_lock(shared.mutex) || faeb_mutex_try_lock(shared.mutex)) return 11;
+    if (faeb_mutex_unlock(shared.mutex) != FAEB_SUCCESS) return 12;
+
+    // Condition variable: every item produced is consumed, in order
+    shared.cond = faeb_cond_create();
+    if (!shared.cond) return 13;
+    shared.value = 0;
+    shared.count = 0;
+    shared.rounds = 20;
+    a = faeb_process_create(sync_consumer, &shared);
+    b = faeb_process_create(sync_producer, &shared);
+    if (!a || !b) return 14;
+    faeb_scheduler_run();
+    if (shared.count != 20 || shared.value != 0 || shared.trace[19] != 19) return 15;
+    faeb_process_destroy(a);
+    faeb_process_destroy(b);
+
+    // A manual-reset event releases every waiter; auto-reset one per set
+    shared.event = faeb_event_create(false);
+    if (!shared.event) return 16;
+    shared.value = 0;
+    for (int i = 0; i < 4; i++) {
+        workers[i] = faeb_process_create(sync_event_waiter, &shared);
+        if (!workers[i]) return 17;
+    }
+    faeb_scheduler_run();
+    if (shared.value != 0) return 18;
+    faeb_event_set(shared.event);
+    faeb_scheduler_run();
+    if (shared.value != 4) return 19;
+    if (faeb_event_wait(shared.event) != FAEB_SUCCESS) return 20;
+    for (int i = 0; i < 4; i++) {
+        faeb_process_destroy(workers[i]);
+    }
+    faeb_event_destroy(shared.event);
+
+    shared.event = faeb_event_create(true);
+    if (!shared.event) return 21;
+    shared.value = 0;
+    for (int i = 0; i < 4; i++) {
+        workers[i] = faeb_process_create(sync_event_waiter, &shared);
+        if (!workers[i]) return 22;
+    }
+    faeb_scheduler_run();
+    faeb_event_set(shared.event);
+    faeb_event_set(shared.event);
+    faeb_scheduler_run();
+    if (shared.value != 2) return 23;
+    faeb_event_set(shared.event);
+    faeb_event_set(shared.event);
+    faeb_event_set(shared.event);
+    faeb_scheduler_run();
+    if (shared.value != 4) return 24;
+    if (faeb_event_wait(shared.event) != FAEB_SUCCESS) return 25;
+    if (faeb_event_wait(shared.event) != FAEB_ERROR_INVALID) return 26;
+    for (int i = 0; i < 4; i++) {
+        faeb_process_destroy(workers[i]);
+    }
+
+    faeb_event_destroy(shared.event);
+    faeb_cond_destroy(shared.cond);
+    faeb_mutex_destroy(shared.mutex);
+    faeb_semaphore_destroy(shared.ping);
+    faeb_semaphore_destroy(shared.pong);
+    return 0;
+}
+
+// Processes on different workers contend for one mutex, and a plain
+// thread releases processes parked on an event
+int test_sync_workers(void) {
+    enum { PROCESSES = 64 };
+    static faeb_process_t* processes[PROCESSES];
+    struct sync_shared shared = { .rounds = 200 };
+    shared.mutex = faeb_mutex_create();
+    if (!shared.mutex) return 1;
+    if (faeb_scheduler_init_workers(4) != FAEB_SUCCESS) return 2;
+
+    for (int i = 0; i < PROCESSES; i++) {
+        processes[i] = faeb_process_create(sync_critical, &shared);
+        if (!processes[i] || faeb_scheduler_submit(processes[i]) != FAEB_SUCCESS) return 3;
+    }
+    faeb_scheduler_wait();
+    if (shared.value != PROCESSES * 200 || shared.overlaps != 0) return 4;
+    for (int i = 0; i < PROCESSES; i++) {
+        faeb_process_destroy(processes[i]);
+    }
+
+    // Processes park as they start; one set from the main thread frees all
+    shared.event = faeb_event_create(false);
+    if (!shared.event) return 5;
+    shared.value = 0;
+    for (int i = 0; i < PROCESSES; i++) {
+        processes[i] = faeb_process_create(sync_event_waiter, &shared);
+        if (!processes[i] || faeb_scheduler_submit(processes[i]) != FAEB_SUCCESS) return 6;
+    }
+    faeb_event_set(shared.event);
+    faeb_scheduler_wait();
+    if (shared.value != PROCESSES) return 7;
+    for (int i = 0; i < PROCESSES; i++) {
+        faeb_process_destroy(processes[i]);
+    }
+
+    faeb_scheduler_shutdown_workers();
+    faeb_event_destroy(shared.event);
+    faeb_mutex_destroy(shared.mutex);
+    return 0;
+}
+
+static void sync_idle(void* context) {
+    faeb_semaphore_wait(context);
+}
+
+// Handoff and wake cost against the number of processes blocked
+// elsewhere: none of it should grow with the crowd
+int test_performance_sync(void) {
+    enum { MAX_BLOCKED = 16384 };
+    static faeb_process_t* idle[MAX_BLOCKED];
+    faeb_process_config_t config = { .stack_size = 16 << 10 };
+    struct sync_shared shared = { .rounds = 200000 };
+    shared.ping = faeb_semaphore_create(0);
+    shared.pong = faeb_semaphore_create(0);
+    faeb_semaphore_t* crowd = faeb_semaphore_create(0);
+    if (!shared.ping || !shared.pong || !crowd) return 1;
+
+    for (int blocked = 16; blocked <= MAX_BLOCKED; blocked *= 32) {
+        for (int i = 0; i < blocked; i++) {
+            idle[i] = faeb_process_create_config(sync_idle, crowd, &config);
+            if (!idle[i]) return 2;
+        }
+        faeb_scheduler_run();
+
+        shared.count = 0;
+        faeb_process_t* a = faeb_process_create_config(sync_ping, &shared, &config);
+        faeb_process_t* b = faeb_process_create_config(sync_pong, &shared, &config);
+        if (!a || !b) return 3;
+        uint64_t start = now_ns();
+        faeb_scheduler_run();
+        double handoff = (double)(now_ns() - start) / (2.0 * shared.rounds);
+
+        start = now_ns();
+        for (int i = 0; i < blocked; i++) {
+            faeb_semaphore_post(crowd);
+        }
+        faeb_scheduler_run();
+        double wake = (double)(now_ns() - start) / blocked;
+
+        printf("  %5d blocked: %.1f ns/handoff, %.1f ns/wake+finish\n",
+               blocked, handoff, wake);
+        faeb_process_destroy(a);
+        faeb_process_destroy(b);
+        for (int i = 0; i < blocked; i++) {
+            faeb_process_destroy(idle[i]);
+        }
+    }
+
+    faeb_semaphore_destroy(crowd);
+    faeb_semaphore_destroy(shared.ping);
+    faeb_semaphore_destroy(shared.pong);
+    return 0;
+}